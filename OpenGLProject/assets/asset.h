@@ -1,15 +1,15 @@
-#pragma once
-#include <utility>
-#include <vector>
-
-#include "core.h"
-
-namespace ogl {
-
-	template<typename T>
-	class Asset {
-
-		virtual std::vector<char> serialize() = 0;
-		static T deserialize() { return T::deserialize(); }
-	};
+#pragma once
+#include <utility>
+#include <vector>
+
+#include "core.h"
+
+namespace ogl {
+
+	template<typename T>
+	class Asset {
+
+		virtual std::vector<char> serialize() = 0;
+		static T deserialize() { return T::deserialize(); }
+	};
 }
\ No newline at end of file
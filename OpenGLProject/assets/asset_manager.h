@@ -1,109 +1,277 @@
-#pragma once
-
-#include <optional>
-#include <string_view>
-#include <tuple>
-#include <type_traits>
-#include <typeinfo>
-#include <unordered_map>
-#include <any>
-#include <utility>
-
-#include "assert.h"
-#include "asset.h"
-#include "util/greedy_vector.h"
-#include "core.h"
-
-
-namespace ogl {
-	
-
-	namespace intern {
-		int global_index() {
-			static int i = 0;
-			return i++;
-		}
-
-		template<typename T>
-		int type_index() {
-			static int index = global_index();
-			return index;
-		}
-	}
-	
-	class AssetManager;
-
-	template<typename T>
-	class AssetHandle {
-		friend AssetManager;
-	private:
-		AssetHandle(std::string name);
-
-	public:
-		inline T* get_ptr();
-		inline T& get() { return *get_ptr(); }
-		inline std::string name() { return m_Name;	}
-
-
-	private:
-		std::string m_Name;
-		T* m_Data;
-	};
-
-	class AssetManager {
-	private:
-		AssetManager() : m_AssetMap(100) { }
-	
-	public:
-		template<typename T>
-		std::optional<AssetHandle<T>> create(const std::string& name, const std::string& path) {	
-			static_assert(std::is_invocable_r<T, decltype(T::construct_asset), const std::string&>::value, "T must have a static function 'T::construct_asset(const std::string&)' that returns a valid std::optional<T>");
-			static_assert(std::is_move_constructible_v<T>, "T must be move constructible");
-			if(T data = T::construct_asset(path)) {
-				T* ptr = new T(std::move(data));
-				auto key = std::make_pair(std::string{name}, intern::type_index<T>());
-				m_AssetMap[key] = ptr;
-				OGL_ASSERT(false, "TODO implement asset handle");
-				return std::make_optional(AssetHandle<T>(std::string{name}));
-			}
-		}
-
-		template<typename T>
-		std::optional<T&> get(const std::string& name) {
-			auto key = std::make_pair(std::string{name}, intern::type_index<T>());
-			
-			// If not found
-			if(m_AssetMap.find(key) == m_AssetMap.end()) {
-				return std::nullopt;
-			}
-
-			return *((T*) m_AssetMap[key]);
-		}
-
-		template<typename T> 
-		bool free(const std::string& name) {
-			auto key = std::make_pair(std::string{name}, intern::type_index<T>());
-
-			if(m_AssetMap.find(key) == m_AssetMap.end()) {
-				return false;
-			}
-
-			delete ((T*) m_AssetMap[key]);
-			m_AssetMap.erase(key);
-		}
-
-		static AssetManager& instance() {
-			static AssetManager inst{};
-			return inst;
-		}
-
-	private:
-		std::unordered_map<std::pair<std::string, int>, void*> m_AssetMap;
-	};
-
-	template<typename T>
-	T* AssetHandle<T>::get_ptr() {
-		OGL_DEBUG_ASSERT(AssetManager::instance().get(this->name).has_value());
-		return m_Data; 
-	}
-}
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "assert.h"
+#include "asset.h"
+#include "util/hash.h"
+#include "core.h"
+
+
+namespace ogl {
+
+
+	namespace intern {
+		inline uint32_t global_index() {
+			static uint32_t i = 0;
+			return i++;
+		}
+
+		template<typename T>
+		uint32_t type_index() {
+			static uint32_t index = global_index();
+			return index;
+		}
+	}
+
+	// Names are hashed once when an asset is created or looked up, after
+	// that assets are only ever found through handles. Names with the same
+	// hash are told apart by comparing them.
+	using AssetNameId = uint64_t;
+	inline AssetNameId HashAssetName(std::string_view name) { return HashFNV1a(name); }
+
+	class AssetManager;
+
+	// An index into the asset table of T plus the generation of the slot
+	// when the handle was made. Freeing an asset bumps its slot's
+	// generation, so old handles to it stop resolving instead of pointing
+	// at whatever reuses the slot. A default constructed handle is null.
+	template<typename T>
+	class AssetHandle {
+		friend AssetManager;
+	private:
+		AssetHandle(uint32_t index, uint32_t generation) : m_Index(index), m_Generation(generation) {}
+
+	public:
+		AssetHandle() = default;
+
+		// nullptr if the asset has been freed
+		inline T* get_ptr() const;
+		inline T& get() const {
+			T* ptr = get_ptr();
+			OGL_DEBUG_ASSERT(ptr, "Asset handle is null or its asset was freed");
+			return *ptr;
+		}
+		inline bool valid() const { return get_ptr() != nullptr; }
+		inline const std::string& name() const;
+
+		uint32_t index() const { return m_Index; }
+		uint32_t generation() const { return m_Generation; }
+
+		bool operator==(const AssetHandle& other) const { return m_Index == other.m_Index && m_Generation == other.m_Generation; }
+		bool operator!=(const AssetHandle& other) const { return !(*this == other); }
+
+	private:
+		uint32_t m_Index = 0;
+		// Slots start at generation 1, 0 never resolves
+		uint32_t m_Generation = 0;
+	};
+
+	namespace intern {
+		class AssetTableBase {
+		public:
+			virtual ~AssetTableBase() = default;
+		};
+
+		// The assets of one type. Slots are handed out densely from the
+		// front and reused once freed. Assets are allocated separately so
+		// pointers to them stay valid as the table grows.
+		template<typename T>
+		class AssetTable : public AssetTableBase {
+		public:
+			struct Slot {
+				std::unique_ptr<T> asset;
+				uint32_t generation = 1;
+				AssetNameId nameId = 0;
+				std::string name;
+			};
+
+			T* get(uint32_t index, uint32_t generation) const {
+				if(index >= m_Slots.size()) return nullptr;
+				const Slot& slot = m_Slots[index];
+				return slot.generation == generation ? slot.asset.get() : nullptr;
+			}
+
+			const Slot& slot(uint32_t index) const { return m_Slots[index]; }
+
+			std::optional<uint32_t> find(AssetNameId nameId, std::string_view name) const {
+				auto [it, end] = m_Names.equal_range(nameId);
+				for(; it != end; ++it) {
+					if(m_Slots[it->second].name == name) return it->second;
+				}
+				return std::nullopt;
+			}
+
+			uint32_t insert(AssetNameId nameId, std::string_view name, std::unique_ptr<T> asset) {
+				uint32_t index;
+				if(!m_Free.empty()) {
+					index = m_Free.back();
+					m_Free.pop_back();
+				} else {
+					index = (uint32_t)m_Slots.size();
+					m_Slots.emplace_back();
+				}
+
+				Slot& slot = m_Slots[index];
+				slot.asset = std::move(asset);
+				slot.nameId = nameId;
+				slot.name = std::string{name};
+				m_Names.emplace(nameId, index);
+				return index;
+			}
+
+			bool erase(uint32_t index, uint32_t generation) {
+				if(!get(index, generation)) return false;
+
+				Slot& slot = m_Slots[index];
+				auto [it, end] = m_Names.equal_range(slot.nameId);
+				while(it->second != index) ++it;
+				m_Names.erase(it);
+				slot.asset.reset();
+				slot.name.clear();
+				// Skip 0 when wrapping, it is the null generation
+				if(++slot.generation == 0) slot.generation = 1;
+				m_Free.push_back(index);
+				return true;
+			}
+
+			size_t size() const { return m_Slots.size() - m_Free.size(); }
+
+		private:
+			std::vector<Slot> m_Slots;
+			std::vector<uint32_t> m_Free;
+			// More than one slot per id if names collide
+			std::unordered_multimap<AssetNameId, uint32_t> m_Names;
+		};
+	}
+
+	// Owns every asset, one table per asset type. An asset is named when
+	// it is created and the name is unique per type. Looking a name up
+	// costs one hash of the name, resolving a handle is two array indexes
+	// and a generation compare.
+	//
+	// Not thread safe, use it from one thread.
+	class AssetManager {
+	private:
+		AssetManager() = default;
+
+	public:
+		// Constructs T with T::construct_asset(path, args...), which
+		// returns a std::optional<T>. Creating a name that already exists
+		// returns the existing asset without loading anything. nullopt if
+		// the asset couldn't be constructed.
+		template<typename T, typename... Args>
+		std::optional<AssetHandle<T>> create(std::string_view name, const std::string& path, Args&&... args) {
+			static_assert(std::is_same_v<decltype(T::construct_asset(path, std::forward<Args>(args)...)), std::optional<T>>,
+				"T must have a static function 'T::construct_asset(const std::string&, ...)' that returns a std::optional<T>");
+			static_assert(std::is_move_constructible_v<T>, "T must be move constructible");
+
+			if(auto existing = find<T>(name); existing.valid()) return existing;
+
+			if(std::optional<T> data = T::construct_asset(path, std::forward<Args>(args)...)) {
+				return add<T>(name, std::move(*data));
+			}
+
+			log::ErrorFrom("AssetManager", "Failed to create asset '", name, "' from '", path, "'");
+			return std::nullopt;
+		}
+
+		// Takes ownership of an asset made elsewhere. The name must not be in use.
+		template<typename T>
+		AssetHandle<T> add(std::string_view name, T&& asset) {
+			const AssetNameId nameId = HashAssetName(name);
+			auto& assets = table<T>();
+			OGL_ASSERT(!assets.find(nameId, name), "An asset with this name already exists");
+
+			const uint32_t index = assets.insert(nameId, name, std::make_unique<T>(std::move(asset)));
+			return AssetHandle<T>(index, assets.slot(index).generation);
+		}
+
+		// A null handle if there is no T called name
+		template<typename T>
+		AssetHandle<T> find(std::string_view name) const {
+			const auto* assets = find_table<T>();
+			if(!assets) return {};
+
+			auto index = assets->find(HashAssetName(name), name);
+			if(!index) return {};
+			return AssetHandle<T>(*index, assets->slot(*index).generation);
+		}
+
+		template<typename T>
+		T* get(AssetHandle<T> handle) const {
+			const auto* assets = find_table<T>();
+			return assets ? assets->get(handle.m_Index, handle.m_Generation) : nullptr;
+		}
+
+		// Destroys the asset, every handle to it stops resolving. Returns
+		// false if it was already freed.
+		template<typename T>
+		bool free(AssetHandle<T> handle) {
+			auto* assets = find_table<T>();
+			return assets && assets->erase(handle.m_Index, handle.m_Generation);
+		}
+
+		template<typename T>
+		bool free(std::string_view name) { return free(find<T>(name)); }
+
+		// Live assets of type T
+		template<typename T>
+		size_t size() const {
+			const auto* assets = find_table<T>();
+			return assets ? assets->size() : 0;
+		}
+
+		static AssetManager& instance() {
+			static AssetManager inst{};
+			return inst;
+		}
+
+	private:
+		template<typename T>
+		friend class AssetHandle;
+
+		template<typename T>
+		intern::AssetTable<T>& table() {
+			const uint32_t type = intern::type_index<T>();
+			if(type >= m_Tables.size()) m_Tables.resize(type + 1);
+			if(!m_Tables[type]) m_Tables[type] = std::make_unique<intern::AssetTable<T>>();
+			return static_cast<intern::AssetTable<T>&>(*m_Tables[type]);
+		}
+
+		template<typename T>
+		const intern::AssetTable<T>* find_table() const {
+			const uint32_t type = intern::type_index<T>();
+			if(type >= m_Tables.size()) return nullptr;
+			return static_cast<const intern::AssetTable<T>*>(m_Tables[type].get());
+		}
+
+		template<typename T>
+		intern::AssetTable<T>* find_table() {
+			return const_cast<intern::AssetTable<T>*>(std::as_const(*this).find_table<T>());
+		}
+
+		// Indexed by intern::type_index
+		std::vector<std::unique_ptr<intern::AssetTableBase>> m_Tables;
+	};
+
+	template<typename T>
+	T* AssetHandle<T>::get_ptr() const {
+		return AssetManager::instance().get(*this);
+	}
+
+	template<typename T>
+	const std::string& AssetHandle<T>::name() const {
+		static const std::string s_NoName;
+		const auto* assets = AssetManager::instance().find_table<T>();
+		if(!assets || !assets->get(m_Index, m_Generation)) return s_NoName;
+		return assets->slot(m_Index).name;
+	}
+}
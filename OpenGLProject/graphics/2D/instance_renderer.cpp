@@ -3,7 +3,11 @@
 #include "math/matrix.h"
 #include "log.h"
 #include <algorithm>
-#include <sstream>
+#include <chrono>
+#include <cstring>
+#include <execution>
+#include <numeric>
+#include <thread>
 
 // Vertices should be specified in a clockwise manner starting 
 // at the bottom left corner:
@@ -38,182 +42,357 @@ namespace ogl {
 		buffer.unmap_indices();
 	}
 
-	BatchRenderer2D::BatchRenderer2D(const GraphicsContext& context) : m_BatchVBO(OGL_2D_BATCH_MAX_VERTS * sizeof(SpriteVertex), BufferUsage::DynamicDraw),
-		m_BatchIBO(OGL_2D_BATCH_MAX_INDICES, BufferUsage::StaticDraw), m_MaxTextureSlots(context.maxFragmentTextureSlots)
+	// Leaves positions as they are, used for full vertices
+	static constexpr SpritePackFrame s_IdentityPackFrame = { { 0.0f, 0.0f, 0.0f }, { 1.0f, 1.0f, 1.0f } };
+
+	// Uniform buffer binding point of the FrameData block
+	static constexpr uint32_t s_FrameDataBinding = 0;
+
+	static size_t BatchBufferSize(const BatchRenderer2DSettings& settings) {
+		if(settings.mode == SpriteRenderMode::Instanced) 
+			return OGL_2D_BATCH_MAX_SPRITES * sizeof(SpriteInstance);
+		if(settings.packedVertices)
+			return OGL_2D_BATCH_MAX_VERTS * sizeof(SpriteVertexPacked);
+		return OGL_2D_BATCH_MAX_VERTS * sizeof(SpriteVertex);
+	}
+
+	static VertexBuffer CreateBatchBuffer(const BatchRenderer2DSettings& settings) {
+		const size_t size = BatchBufferSize(settings);
+		return settings.ringStreaming ? VertexBuffer(BufferRingDesc{ size, settings.ringSegments })
+		                              : VertexBuffer(size, BufferUsage::DynamicDraw);
+	}
+
+	// Points the sprite attributes of vao at vbo and, if builder is given,
+	// names them for the shader.
+	static void SetSpriteAttribs(VertexArray& vao, VertexBuffer& vbo, SpriteRenderMode mode, bool packed, ShaderBuilder* builder) {
+		if(mode == SpriteRenderMode::Vertices) {
+			constexpr uint32_t vertPosIndex      = 0;
+			constexpr uint32_t vertColIndex      = 1;
+			constexpr uint32_t vertTexCoordIndex = 2;
+			constexpr uint32_t vertTexIdIndex    = 3;
+
+			if(packed) {
+				// Same shader inputs, the normalised attributes still arrive as floats
+				using V = SpriteVertexPacked;
+				vao.set_attrib<Vector3<int16_t>>(vertPosIndex,       vbo, sizeof(V), offsetof(V, position), true);
+				vao.set_attrib<Vector4<uint8_t>>(vertColIndex,       vbo, sizeof(V), offsetof(V, colour), true);
+				vao.set_attrib<Vector2<uint16_t>>(vertTexCoordIndex, vbo, sizeof(V), offsetof(V, texCoord), true);
+				vao.set_attrib<uint8_t>(vertTexIdIndex,              vbo, sizeof(V), offsetof(V, texId));
+			}
+			else {
+				vao.set_attrib<Vector3f>(vertPosIndex,      vbo, sizeof(SpriteVertex), offsetof(SpriteVertex, position));
+				vao.set_attrib<Vector4f>(vertColIndex,      vbo, sizeof(SpriteVertex), offsetof(SpriteVertex, colour));
+				vao.set_attrib<Vector2f>(vertTexCoordIndex, vbo, sizeof(SpriteVertex), offsetof(SpriteVertex, texCoord));
+				vao.set_attrib<texslot_t>(vertTexIdIndex,   vbo, sizeof(SpriteVertex), offsetof(SpriteVertex, texId));
+			}
+			if(builder) {
+				builder->specify_attrib(vertPosIndex, "vert_pos");
+				builder->specify_attrib(vertColIndex, "vert_colour");
+				builder->specify_attrib(vertTexCoordIndex, "vert_texCoord");
+				builder->specify_attrib(vertTexIdIndex, "vert_texId");
+			}
+		}
+		else {
+			constexpr uint32_t instPosIndex       = 0;
+			constexpr uint32_t instSizeIndex      = 1;
+			constexpr uint32_t instColIndex       = 2;
+			constexpr uint32_t instTexCoordsIndex = 3;
+			constexpr uint32_t instTexIdIndex     = 4;
+
+			vao.set_attrib<Vector3f>(instPosIndex,         vbo, sizeof(SpriteInstance), offsetof(SpriteInstance, position));
+			vao.set_attrib<Vector2f>(instSizeIndex,        vbo, sizeof(SpriteInstance), offsetof(SpriteInstance, size));
+			vao.set_attrib<Vector4<uint8_t>>(instColIndex, vbo, sizeof(SpriteInstance), offsetof(SpriteInstance, colour), true);
+			vao.set_attrib<Vector4f>(instTexCoordsIndex,   vbo, sizeof(SpriteInstance), offsetof(SpriteInstance, texCoords));
+			vao.set_attrib<texslot_t>(instTexIdIndex,      vbo, sizeof(SpriteInstance), offsetof(SpriteInstance, texId));
+			for(uint32_t id = instPosIndex; id <= instTexIdIndex; id++) {
+				vao.set_attrib_divisor(id, 1);
+			}
+			if(builder) {
+				builder->specify_attrib(instPosIndex, "inst_pos");
+				builder->specify_attrib(instSizeIndex, "inst_size");
+				builder->specify_attrib(instColIndex, "inst_colour");
+				builder->specify_attrib(instTexCoordsIndex, "inst_texCoords");
+				builder->specify_attrib(instTexIdIndex, "inst_texId");
+			}
+		}
+	}
+
+	// Shared by both vertex shaders, see update_frame_data
+	static const char* s_FrameDataShader = 
+		"#pragma once\n"
+		"layout(std140, row_major) uniform FrameData {\n"
+		"	mat4 u_projection;\n"
+		"};\n";
+
+	static const char* s_VertexModeShader = 
+		"#version 330 core\n"
+		"in vec3 vert_pos;\n"
+		"in vec4 vert_colour;\n"
+		"in vec2 vert_texCoord;\n"
+		"in uint vert_texId;\n"
+
+		"out vec4 colour;\n"
+		"out vec2 texCoord;\n"
+		"flat out uint texId;\n"
+
+		"#include \"ogl/frame_data.glsl\"\n"
+		// Packed positions are relative to the pack frame, for full
+		// vertices the frame is origin 0 and scale 1
+		"uniform vec3 u_packOrigin;\n"
+		"uniform vec3 u_packScale;\n"
+		"\n"
+		"void main() {\n"
+		"	gl_Position = u_projection * vec4(u_packOrigin + vert_pos * u_packScale, 1.0);\n"
+		"	colour = vert_colour;\n"
+		"   texCoord = vert_texCoord;\n"
+		"   texId = vert_texId;\n"
+		"}\n";
+
+	// Drawn as a 4 vertex triangle strip, so gl_VertexID maps to the
+	// corners: 0 = bottom left, 1 = top left, 2 = bottom right, 3 = top right
+	static const char* s_InstancedModeShader = 
+		"#version 330 core\n"
+		"in vec3 inst_pos;\n"
+		"in vec2 inst_size;\n"
+		"in vec4 inst_colour;\n"
+		"in vec4 inst_texCoords;\n"
+		"in uint inst_texId;\n"
+
+		"out vec4 colour;\n"
+		"out vec2 texCoord;\n"
+		"flat out uint texId;\n"
+
+		"#include \"ogl/frame_data.glsl\"\n"
+		"\n"
+		"void main() {\n"
+		"	vec2 corner = vec2(gl_VertexID >> 1, gl_VertexID & 1);\n"
+		"	gl_Position = u_projection * vec4(inst_pos.xy + corner * inst_size, inst_pos.z, 1.0);\n"
+		"	colour = inst_colour;\n"
+		"   texCoord = inst_texCoords.xy + corner * inst_texCoords.zw;\n"
+		"   texId = inst_texId;\n"
+		"}\n";
+
+	// SAMPLER_COUNT is the length of u_samplers. 4.00 because indexing a
+	// sampler array with anything but a constant is an error before it.
+	static const char* s_FragmentShader = 
+		"#version 400 core\n"
+		"out vec4 frag_Colour;\n"
+		"\n"
+		"in vec4 colour;\n"
+		"in vec2 texCoord;\n"
+		"flat in uint texId;\n"
+		"\n"
+		"uniform sampler2D u_samplers[${SAMPLER_COUNT}];\n"
+		"\n"
+		"void main() {\n"
+		"   vec4 textureColour = texture(u_samplers[texId], texCoord);\n"
+		"   frag_Colour = textureColour; \n"
+		"}\n";
+
+	BatchRenderer2D::BatchRenderer2D(const GraphicsContext& context, const Settings& settings) : m_Mode(settings.mode), 
+		m_RingStreaming(settings.ringStreaming), 
+		m_PackedVertices(settings.packedVertices && settings.mode == SpriteRenderMode::Vertices), m_BatchVBO(CreateBatchBuffer(settings)),
+		m_BatchIBO(m_Mode == SpriteRenderMode::Vertices ? OGL_2D_BATCH_MAX_INDICES : 0, BufferUsage::StaticDraw), m_FrameUBO(sizeof(Matrix4f)),
+		
+		m_BatchTexSlots(OGL_2D_BATCH_MAX_SPRITES), m_SlotTable(context.maxFragmentTextureSlots * 2), 
+		m_ParallelChunkSize(settings.parallelChunkSize), 
+		m_HardwareThreads(settings.parallelThreads ? settings.parallelThreads : std::thread::hardware_concurrency()), 
+		m_SortSprites(settings.sortSprites), m_CullSprites(settings.cullSprites), 
+		m_MaxTextureSlots(context.maxFragmentTextureSlots)
 	{
-		// Setup index
-		CreateIndexBuffer(m_BatchIBO);
-
-		ShaderBuilder builder;
-		builder.add_vertex_shader(
-			"#version 330 core\n"
-			"in vec3 vert_pos;\n"
-			"in vec4 vert_colour;\n"
-			"in vec2 vert_texCoord;\n"
-			"in uint vert_texId;\n"
-
-			"out vec4 colour;\n"
-			"out vec2 texCoord;\n"
-			"flat out uint texId;\n"
-
-			"uniform mat4 u_projection;"
-			"\n"
-			"void main() {\n"
-			"	gl_Position = u_projection * vec4(vert_pos, 1.0);\n"
-			"	colour = vert_colour;\n"
-			"   texCoord = vert_texCoord;\n"
-			"   texId = vert_texId;\n"
-			"}\n"
-		);
-
-		std::stringstream fragShader;
+		glsl::AddIncludeSource("ogl/frame_data.glsl", s_FrameDataShader);
+		ShaderBuilder builder({ { "SAMPLER_COUNT", m_MaxTextureSlots } });
+
+		if(m_Mode == SpriteRenderMode::Vertices) {
+			// Setup index
+			CreateIndexBuffer(m_BatchIBO);
+			builder.add_vertex_shader(s_VertexModeShader);
+		}
+		else {
+			builder.add_vertex_shader(s_InstancedModeShader);
+		}
+
 		ogl::log::Info("Number of texture slots: ", m_MaxTextureSlots);
-		fragShader << "#version 330 core\n"
-			"out vec4 frag_Colour;\n"
-			"\n"
-			"in vec4 colour;\n"
-			"in vec2 texCoord;"
-			"flat in uint texId;\n"
-			"\n"
-			"uniform sampler2D u_samplers[";
-		fragShader << m_MaxTextureSlots/2;
-		fragShader << "];\n"
-			"\n"
-			"void main() {\n"
-			"   vec4 textureColour = texture(u_samplers[texId], texCoord);\n"
-			"   frag_Colour = textureColour; \n"
-			"}\n";
 
 		glEnable(GL_BLEND);
 		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
- 		builder.add_fragment_shader(fragShader.str());
-
-		m_VAO.set_index_buffer(m_BatchIBO);
-		constexpr uint32_t vertPosIndex      = 0;
-		constexpr uint32_t vertColIndex      = 1;
-		constexpr uint32_t vertTexCoordIndex = 2;
-		constexpr uint32_t vertTexIdIndex    = 3;
+ 		builder.add_fragment_shader(s_FragmentShader);
 
-		m_VAO.set_attrib<Vector3f>(vertPosIndex,      m_BatchVBO, sizeof(SpriteVertex), 0);
-		m_VAO.set_attrib<Vector4f>(vertColIndex,      m_BatchVBO, sizeof(SpriteVertex), sizeof(Vector3f));
-		m_VAO.set_attrib<Vector2f>(vertTexCoordIndex, m_BatchVBO, sizeof(SpriteVertex), sizeof(Vector3f) + sizeof(Vector4f));
-		m_VAO.set_attrib<texslot_t>(vertTexIdIndex,     m_BatchVBO, sizeof(SpriteVertex), sizeof(Vector3f) + sizeof(Vector4f) + sizeof(Vector2f));
-		builder.specify_attrib(vertPosIndex, "vert_pos");
-		builder.specify_attrib(vertColIndex, "vert_colour");
-		builder.specify_attrib(vertTexCoordIndex, "vert_texCoord");
-		builder.specify_attrib(vertTexIdIndex, "vert_texId");
+		if(m_Mode == SpriteRenderMode::Vertices) m_VAO.set_index_buffer(m_BatchIBO);
+		SetSpriteAttribs(m_VAO, m_BatchVBO, m_Mode, m_PackedVertices, &builder);
 
-		auto shader = builder.generate();
-		if(!shader) { OGL_ASSERT(false, "Failed to generate shader."); }
-			m_Shader = std::make_unique<Shader>(std::move(*shader));;
+		// Compiles while whoever made us gets on with something else, it is
+		// only waited for when the shader is first needed (see shader())
+		m_PendingShader = builder.generate_async();
 
 		ogl::log::InfoFrom("BatchRenderer2D", "Using ", m_MaxTextureSlots, " texture slots");
+		
+		map_batch();
+	}
 
-		// Setup samplers
-		{
-			std::vector<int32_t> slots;
-			slots.reserve(m_MaxTextureSlots);
-			for (int32_t i = 0; i < m_MaxTextureSlots; i++) {
-				slots.push_back(i);
-			}
+	BatchRenderer2D::~BatchRenderer2D() {}
 
-			m_Shader->set_uniform_array("u_samplers", slots.data(), slots.size());
+	void BatchRenderer2D::process(const RendererSpriteData& data, const GraphicsContext& context, const SpriteBlend* blend) {
+		if(m_CullSprites) process_culled(data, m_Culler.cull(data, get_view_rect(context)), context, blend);
+		else process_sorted(data, context, blend);
+	}
+
+	void BatchRenderer2D::process(const RendererSpriteData& data, const SpriteGrid& grid, const GraphicsContext& context, const SpriteBlend* blend) {
+		process_culled(data, m_Culler.cull(data, grid, get_view_rect(context)), context, blend);
+	}
+
+	void BatchRenderer2D::process_culled(const RendererSpriteData& data, const RendererSpriteData& visible, const GraphicsContext& context, const SpriteBlend* blend) {
+		m_Stats.culled += data.spriteCount - visible.spriteCount;
+
+		if(blend && m_SortSprites) {
+			const auto& indices = m_Culler.visible();
+			m_CulledBlend.resize(indices.size());
+			for(size_t i = 0; i < indices.size(); i++) m_CulledBlend[i] = blend[indices[i]];
+			blend = m_CulledBlend.data();
 		}
-		
-		m_BatchMappedVBO = m_BatchVBO.map_buffer<SpriteVertex>(BufferMapHint::WriteOnly);
+
+		process_sorted(visible, context, blend);
 	}
 
-	BatchRenderer2D::~BatchRenderer2D() {}
+	void BatchRenderer2D::process_sorted(const RendererSpriteData& data, const GraphicsContext& context, const SpriteBlend* blend) {
+		if(!m_SortSprites) {
+			process_batches(data, context);
+			return;
+		}
+
+		using namespace std::chrono;
+		const auto start = high_resolution_clock::now();
+		const auto sorted = m_Sorter.sort(data, blend);
+		m_Stats.sortTime += duration<float, std::micro>(high_resolution_clock::now() - start).count();
+
+		process_batches(sorted, context);
+	}
 
-	void BatchRenderer2D::process(const RendererSpriteData& data, const GraphicsContext& context) {
+	void BatchRenderer2D::process_batches(const RendererSpriteData& data, const GraphicsContext& context) {
 	
 		// This method will segment the provided data into 
 		// batches and process it.
 
 		// This will hold from where we need to transform the last set of data
 		size_t dataOffset = 0;
+
+		// All sprites in a batch have to be packed relative to the same frame
+		if(m_PackedVertices && m_BatchSpriteCount == 0) m_PackFrame = calc_pack_frame(context);
+
+		// Processes and flushes everything before sprite i
+		auto flushBefore = [&](size_t i) {
+			auto renderData = data.subset(dataOffset, i - dataOffset);
+			transform_data(renderData);
+			flush(context);
+			dataOffset = i;
+		};
+
 		for(size_t i = 0; i < data.spriteCount; i++) {
 
-			if(m_BatchSpriteCount + i == OGL_2D_BATCH_MAX_SPRITES) {
+			if(m_BatchSpriteCount + (i - dataOffset) == OGL_2D_BATCH_MAX_SPRITES) {
 				// If we are limited by batch size we process and flush  
-				auto renderData = data.subset(dataOffset, i - dataOffset);
-				transform_data(renderData);
-				flush(context);
-				dataOffset = i;
+				flushBefore(i);
 			}
 
-			// Check to see if we are at our texture limit
 			auto& tex = *(data.texture + i);
-
-			// We have a new texture
-			// TODO: check for duplicate textures
-			texslot_t id = m_CurrentTexSlot++;
-			tex->set_texid(id);
-
-			if(m_CurrentTexSlot == m_MaxTextureSlots) {
-				// The batch is now full, so we need to flush after processing 
-				// this batch.
-				auto renderData = data.subset(dataOffset, i - dataOffset);
-				transform_data(renderData);
-				flush(context);
-				dataOffset = i;
+			const uint32_t glId = tex->get_renderer_id();
+
+			// Sprites sharing a texture share its slot
+			texslot_t id;
+			if(!m_SlotTable.find(glId, id)) {
+				if(m_CurrentTexSlot == m_MaxTextureSlots) {
+					// We have run out of texture slots, so the new texture
+					// has to go in the next batch
+					flushBefore(i);
+				}
+
+				id = m_CurrentTexSlot++;
+				tex->set_texid(id);
+				m_SlotTable.insert(glId, id);
 			}
+
+			m_BatchTexSlots[m_BatchSpriteCount + (i - dataOffset)] = id;
 		}
 
 		auto renderData = data.offset(dataOffset);
 		transform_data(renderData);
 	}
 
-	// TODO: add specialisation for soa vs. aos
 	void BatchRenderer2D::transform_data(const RendererSpriteData& data) {
-
-		size_t startIndex = m_BatchSpriteCount * 4;
-
-		// TODO: Make this more DOD friendly?
-		size_t vertIndex = startIndex;
-		for (size_t i = 0; i < data.spriteCount; i++) {
-			const auto& pos = data.pos[i];
-			const auto& size = data.size[i];
-			m_BatchMappedVBO[vertIndex + 0].position = pos;
-			m_BatchMappedVBO[vertIndex + 1].position = Vector3f{ pos.x, pos.y + size.y, pos.z };
-			m_BatchMappedVBO[vertIndex + 2].position = Vector3f{ pos.x + size.x, pos.y + size.y, pos.z };
-			m_BatchMappedVBO[vertIndex + 3].position = Vector3f{ pos.x + size.x, pos.y, pos.z };
-			vertIndex += 4;
-		}
-
-		vertIndex = startIndex;
-		for (size_t i = 0; i < data.spriteCount; i++) {
-			const auto& col = data.col[i];
-			m_BatchMappedVBO[vertIndex + 0].colour = col;
-			m_BatchMappedVBO[vertIndex + 1].colour = col;
-			m_BatchMappedVBO[vertIndex + 2].colour = col;
-			m_BatchMappedVBO[vertIndex + 3].colour = col;
-			vertIndex += 4;
-		}
-
-		vertIndex = startIndex;
-		for (size_t i = 0; i < data.spriteCount; i++) {
-			const auto& tc = data.texCoords[i];
-			m_BatchMappedVBO[vertIndex + 0].texCoord = tc.pos;
-			m_BatchMappedVBO[vertIndex + 1].texCoord = tc.pos + Vector2f{ 0.0f, tc.size.y };
-			m_BatchMappedVBO[vertIndex + 2].texCoord = tc.pos + tc.size;
-			m_BatchMappedVBO[vertIndex + 3].texCoord = tc.pos + Vector2f{ tc.size.x, 0.0f };
-			vertIndex += 4;
-		}
-
-		vertIndex = startIndex;
-		auto texIter = data.texture;
-		for (size_t i = 0; i < data.spriteCount; i++) {
-			const auto& texId = i;
-			m_BatchMappedVBO[vertIndex + 0].texId = texId;
-			m_BatchMappedVBO[vertIndex + 1].texId = texId;
-			m_BatchMappedVBO[vertIndex + 2].texId = texId;
-			m_BatchMappedVBO[vertIndex + 3].texId = texId;
-			vertIndex += 4;
+		OGL_DEBUG_ASSERT(m_BatchSpriteCount + data.spriteCount <= OGL_2D_BATCH_MAX_SPRITES);
+		using namespace std::chrono;
+		const auto start = high_resolution_clock::now();
+
+		// Splitting only pays off once there are a few chunks to hand out, and
+		// there is nothing to gain from it with a single hardware thread
+		if(m_ParallelChunkSize && m_HardwareThreads > 1 && data.spriteCount >= m_ParallelChunkSize * 2) {
+			// Four chunks a thread, so one that gets descheduled doesn't hold
+			// up the batch, but big enough that scheduling them stays cheap
+			const size_t targetChunks = m_HardwareThreads * 4;
+			const size_t chunkSize = std::max(m_ParallelChunkSize, (data.spriteCount + targetChunks - 1) / targetChunks);
+			const size_t chunkCount = (data.spriteCount + chunkSize - 1) / chunkSize;
+			m_Chunks.resize(chunkCount);
+			std::iota(m_Chunks.begin(), m_Chunks.end(), 0);
+
+			// Each chunk writes a disjoint range of the VBO, so there is nothing
+			// to synchronise. Only the GL calls in flush need the render thread.
+			std::for_each(std::execution::par, m_Chunks.begin(), m_Chunks.end(), [&](size_t chunk) {
+				const size_t offset = chunk * chunkSize;
+				const size_t count = std::min(chunkSize, data.spriteCount - offset);
+				write_sprites(data.subset(offset, count), m_BatchSpriteCount + offset);
+			});
+		}
+		else {
+			write_sprites(data, m_BatchSpriteCount);
 		}
 
+		const size_t spriteBytes = m_Mode == SpriteRenderMode::Instanced ? sizeof(SpriteInstance) 
+			: 4 * (m_PackedVertices ? sizeof(SpriteVertexPacked) : sizeof(SpriteVertex));
+		m_Stats.vertexBytes += data.spriteCount * spriteBytes;
 		m_BatchSpriteCount += data.spriteCount;
+		m_Stats.sprites += data.spriteCount;
+		m_Stats.vertexTime += duration<float, std::micro>(high_resolution_clock::now() - start).count();
+	}
+
+	void BatchRenderer2D::write_sprites(const RendererSpriteData& data, size_t batchIndex) const {
+		const texslot_t* slots = &m_BatchTexSlots[batchIndex];
+		if(m_PackedVertices) {
+			PackSpriteVertices(data, slots, m_PackFrame, m_BatchMappedPacked.mBegin + batchIndex * 4);
+		}
+		else if(m_Mode == SpriteRenderMode::Vertices) {
+			// Whole quads are written straight into the mapped buffer
+			ExpandSprites(data, slots, m_BatchMappedVBO.mBegin + batchIndex * 4);
+		}
+		else {
+			PackSpriteInstances(data, slots, m_BatchMappedInstances.mBegin + batchIndex);
+		}
+	}
+
+	void BatchRenderer2D::map_batch() {
+		if(m_RingStreaming) {
+			if(m_PackedVertices)
+				m_BatchMappedPacked = m_BatchVBO.acquire_segment<SpriteVertexPacked>();
+			else if(m_Mode == SpriteRenderMode::Vertices)
+				m_BatchMappedVBO = m_BatchVBO.acquire_segment<SpriteVertex>();
+			else
+				m_BatchMappedInstances = m_BatchVBO.acquire_segment<SpriteInstance>();
+			return;
+		}
+
+		if(m_PackedVertices)
+			m_BatchMappedPacked = m_BatchVBO.map_buffer<SpriteVertexPacked>(BufferMapHint::WriteOnly);
+		else if(m_Mode == SpriteRenderMode::Vertices)
+			m_BatchMappedVBO = m_BatchVBO.map_buffer<SpriteVertex>(BufferMapHint::WriteOnly);
+		else
+			m_BatchMappedInstances = m_BatchVBO.map_buffer<SpriteInstance>(BufferMapHint::WriteOnly);
+	}
+
+	ViewRect BatchRenderer2D::get_view_rect(const GraphicsContext& context) const {
+		// Must match the bounds used by calc_ortho_mat
+		const auto w = context.frameBufferWidth / 2.0f;
+		const auto h = context.frameBufferHeight / 2.0f;
+		return ViewRect{ { -w, -h }, { w, h } };
 	}
 
 	Matrix4f BatchRenderer2D::calc_ortho_mat(const GraphicsContext& context) {
@@ -222,19 +401,181 @@ namespace ogl {
 		return Matrix4f::Ortho(-w, w, -h, h, m_Near, m_Far);
 	}
 
-	void BatchRenderer2D::flush(const GraphicsContext& context) {
-		m_BatchVBO.unmap_buffer();
+	std::unique_ptr<StaticSpriteLayer> BatchRenderer2D::create_static_layer(const RendererSpriteData& data) {
+		// Layers use the same batch limits so the shared index buffer covers them
+		std::unique_ptr<StaticSpriteLayer> layer(new StaticSpriteLayer(data, m_Mode, m_MaxTextureSlots, OGL_2D_BATCH_MAX_SPRITES));
+		if(m_Mode == SpriteRenderMode::Vertices) layer->m_VAO.set_index_buffer(m_BatchIBO);
+		// Static layers always use full vertices, their positions can't depend on the view
+		SetSpriteAttribs(layer->m_VAO, layer->m_VBO, m_Mode, false, nullptr);
+		return layer;
+	}
+
+	void BatchRenderer2D::draw_static(StaticSpriteLayer& layer, const GraphicsContext& context) {
+		OGL_DEBUG_ASSERT(layer.m_Mode == m_Mode, "Static layer was created by a different renderer");
+
+		// The pending batch has its textures bound to the same slots
+		if(m_BatchSpriteCount) flush(context);
+
+		m_Stats.staticUploadBytes += layer.upload();
+		if(!layer.size()) return;
+
+		update_frame_data(context);
+		if(m_PackedVertices) set_pack_frame(s_IdentityPackFrame);
+		shader().bind();
+
+		for(const auto& batch : layer.m_Batches) {
+			for(size_t slot = 0; slot < batch.textures.size(); slot++) {
+				batch.textures[slot]->set_texid((texslot_t)slot);
+			}
+
+			if(m_Mode == SpriteRenderMode::Vertices)
+				layer.m_VAO.draw_indices((uint32_t)batch.count * 6, 0, (int32_t)batch.first * 4);
+			else
+				layer.m_VAO.draw_instanced_strip(4, (uint32_t)batch.count, (uint32_t)batch.first);
+			m_Stats.drawCalls++;
+		}
 
-		const auto ortho = calc_ortho_mat(context);
-		m_Shader->set_uniform("u_projection", ortho);
-		m_Shader->bind();
+		m_Stats.staticSprites += layer.size();
+	}
+
+	void BatchRenderer2D::queue_static(StaticSpriteLayer& layer, RenderQueue& queue, const GraphicsContext& context, uint8_t layerKey) {
+		OGL_DEBUG_ASSERT(layer.m_Mode == m_Mode, "Static layer was created by a different renderer");
+
+		m_Stats.staticUploadBytes += layer.upload();
+		if(!layer.size()) return;
+
+		update_frame_data(context);
+		const uint32_t program = shader().get_renderer_id();
 
-		m_VAO.draw_indices(m_BatchSpriteCount * 6, 0);
+		// Static layers are always full vertices, the pack frame of a packed
+		// renderer has to be undone for them
+		uint32_t packOrigin = 0, packScale = 0;
+		if(m_PackedVertices) {
+			packOrigin = queue.push_uniform("u_packOrigin", s_IdentityPackFrame.origin);
+			packScale = queue.push_uniform("u_packScale", s_IdentityPackFrame.scale);
+		}
+
+		for(size_t i = 0; i < layer.m_Batches.size(); i++) {
+			const auto& batch = layer.m_Batches[i];
+			OGL_DEBUG_ASSERT(batch.textures.size() <= OGL_RENDER_MAX_TEXTURES);
+
+			RenderCommand command;
+			command.key = MakeRenderKey(layerKey, program, 0, (uint32_t)i);
+			command.shader = &shader();
+			command.vao = &layer.m_VAO;
+			command.textureCount = (uint32_t)batch.textures.size();
+			for(size_t slot = 0; slot < batch.textures.size(); slot++) {
+				// The queue binds by id, residency only sees the use through this
+				batch.textures[slot]->mark_used();
+				command.textures[slot] = batch.textures[slot]->get_renderer_id();
+			}
+			command.uniformBuffer = m_FrameUBO.get_renderer_id();
+			command.uniformBufferBinding = s_FrameDataBinding;
+			if(m_PackedVertices) {
+				command.uniforms[0] = packOrigin;
+				command.uniforms[1] = packScale;
+				command.uniformCount = 2;
+			}
+
+			if(m_Mode == SpriteRenderMode::Vertices) {
+				command.type = RenderDrawType::Indices;
+				command.count = (uint32_t)batch.count * 6;
+				command.baseVertex = (int32_t)batch.first * 4;
+			}
+			else {
+				command.type = RenderDrawType::InstancedStrip;
+				command.count = 4;
+				command.instanceCount = (uint32_t)batch.count;
+				command.baseInstance = (uint32_t)batch.first;
+			}
+			queue.push(command);
+		}
+
+		m_Stats.staticSprites += layer.size();
+	}
+
+	SpritePackFrame BatchRenderer2D::calc_pack_frame(const GraphicsContext& context) const {
+		const ViewRect view = get_view_rect(context);
+		return MakeSpritePackFrame(view.min, view.max, m_Near, m_Far);
+	}
+
+	void BatchRenderer2D::update_frame_data(const GraphicsContext& context) {
+		// The projection only changes with the frame buffer size or depth
+		// range, so it is rarely uploaded more than once
+		const Matrix4f projection = calc_ortho_mat(context);
+		if(!m_FrameDataValid || std::memcmp(&projection, &m_FrameProjection, sizeof(Matrix4f)) != 0) {
+			m_FrameUBO.set_data(projection);
+			m_FrameProjection = projection;
+			m_FrameDataValid = true;
+		}
+		m_FrameUBO.bind_base(s_FrameDataBinding);
+	}
+
+	void BatchRenderer2D::set_pack_frame(const SpritePackFrame& frame) {
+		shader().set_uniform(m_PackOriginLocation, frame.origin);
+		shader().set_uniform(m_PackScaleLocation, frame.scale);
+	}
+
+	Shader& BatchRenderer2D::shader() {
+		if(m_Shader) return *m_Shader;
+
+		auto shader = m_PendingShader.get();
+		if(!shader) { OGL_ASSERT(false, "Failed to generate shader."); }
+		m_Shader = std::make_unique<Shader>(std::move(*shader));
+
+		// Setup samplers
+		{
+			std::vector<int32_t> slots;
+			slots.reserve(m_MaxTextureSlots);
+			for (int32_t i = 0; i < m_MaxTextureSlots; i++) {
+				slots.push_back(i);
+			}
+
+			m_Shader->set_uniform_array("u_samplers", slots.data(), slots.size());
+		}
+
+		m_Shader->set_uniform_block_binding("FrameData", s_FrameDataBinding);
+		if(m_Mode == SpriteRenderMode::Vertices) {
+			m_PackOriginLocation = m_Shader->uniform_location("u_packOrigin");
+			m_PackScaleLocation = m_Shader->uniform_location("u_packScale");
+			set_pack_frame(s_IdentityPackFrame);
+		}
+		return *m_Shader;
+	}
+
+	void BatchRenderer2D::flush(const GraphicsContext& context) {
+		if(m_RingStreaming) m_BatchVBO.unmap_segment();
+		else m_BatchVBO.unmap_buffer();
+		m_Stats.flushes++;
+
+		if(m_BatchSpriteCount) {
+			update_frame_data(context);
+			if(m_PackedVertices) set_pack_frame(m_PackFrame);
+			shader().bind();
+
+			// With a ring buffer the batch lives in the current segment
+			const uint32_t segment = m_RingStreaming ? m_BatchVBO.segment_index() : 0;
+			if(m_Mode == SpriteRenderMode::Vertices)
+				m_VAO.draw_indices(m_BatchSpriteCount * 6, 0, segment * OGL_2D_BATCH_MAX_VERTS);
+			else
+				m_VAO.draw_instanced_strip(4, m_BatchSpriteCount, segment * OGL_2D_BATCH_MAX_SPRITES);
+			m_Stats.drawCalls++;
+		}
 
 		// Resetting batch counters
 		m_BatchSpriteCount = 0;
 		m_CurrentTexSlot = 0;
-		m_BatchVBO.orphan();
-		m_BatchMappedVBO = m_BatchVBO.map_buffer<SpriteVertex>(BufferMapHint::WriteOnly);
+		m_SlotTable.clear();
+
+		if(m_RingStreaming) {
+			m_BatchVBO.fence_segment();
+			const size_t stalls = m_BatchVBO.segment_stalls();
+			map_batch();
+			m_Stats.ringStalls += m_BatchVBO.segment_stalls() - stalls;
+		}
+		else {
+			m_BatchVBO.orphan();
+			map_batch();
+		}
 	}
 }
@@ -1,68 +1,212 @@
-#pragma once
-
-#include "core.h"
-#include "util/greedy_vector.h"
-#include "math/vector.h"
-
-#include "graphics/context.h"
-#include "graphics/texture.h"
-#include "graphics/buffer.h"
-#include "graphics/vertex_array.h"
-#include "graphics/shader.h"
-#include "tex_coords.h"
-#include "sprite_data.h"
-
-#define OGL_2D_BATCH_MAX_SPRITES 10'000
-#define OGL_2D_BATCH_MAX_VERTS OGL_2D_BATCH_MAX_SPRITES * 4
-#define OGL_2D_BATCH_MAX_INDICES OGL_2D_BATCH_MAX_SPRITES * 6
-
-namespace ogl {
-
-	class BatchRenderer2D {
-		public:
-
-			struct SpriteVertex {
-				Vector3f position;
-				Vector4f colour;
-				Vector2f texCoord;
-				texslot_t texId;
-			};
-
-			BatchRenderer2D(const GraphicsContext& context);
-			BatchRenderer2D(const BatchRenderer2D&) = delete;
-			BatchRenderer2D(BatchRenderer2D&&) = delete;
-			~BatchRenderer2D();
-		
-			// process takes a RendererSpriteData struct and processes it for
-			// rendering. With an instanced renderer the sprite data should be sorted by
-			// texture to maxmise efficiency.
-			void process(const RendererSpriteData&, const GraphicsContext&);
-
-			// Always make sure this is called before the end of each frame
-			// To make sure no buffered data is lying around
-			void flush(const GraphicsContext&);
-
-			float get_near() { return m_Near; }
-			void set_near(float n) { m_Near = n; }
-
-			float get_far() { return m_Far; }
-			void set_far(float f) { m_Far = f; }
-
-		private:
-			void transform_data(const RendererSpriteData& data);
-			Matrix4f calc_ortho_mat(const GraphicsContext& ctx);
-
-			VertexBuffer m_BatchVBO;
-			IndexBuffer m_BatchIBO;
-			VertexArray m_VAO;
-			std::unique_ptr<Shader> m_Shader;
-
-			MemView<SpriteVertex> m_BatchMappedVBO;
-			size_t m_BatchSpriteCount = 0;
-			int32_t m_CurrentTexSlot = 0;
-			const int m_MaxTextureSlots;
-
-			float m_Near = -1.0f;
-			float m_Far = 100.0f;
-	};
-}
+#pragma once
+
+#include "core.h"
+#include "util/greedy_vector.h"
+#include "math/vector.h"
+
+#include "graphics/context.h"
+#include "graphics/texture.h"
+#include "graphics/buffer.h"
+#include "graphics/vertex_array.h"
+#include "graphics/shader.h"
+#include "graphics/render_queue.h"
+#include "tex_coords.h"
+#include "sprite_data.h"
+#include "sprite_vertex.h"
+#include "texture_slot_table.h"
+#include "sprite_sort.h"
+#include "sprite_cull.h"
+#include "sprite_grid.h"
+#include "static_sprite_layer.h"
+
+#define OGL_2D_BATCH_MAX_SPRITES 10'000
+#define OGL_2D_BATCH_MAX_VERTS OGL_2D_BATCH_MAX_SPRITES * 4
+#define OGL_2D_BATCH_MAX_INDICES OGL_2D_BATCH_MAX_SPRITES * 6
+
+namespace ogl {
+
+	struct BatchRenderer2DSettings {
+		SpriteRenderMode mode = SpriteRenderMode::Vertices;
+		// Use SpriteVertexPacked instead of SpriteVertex in Vertices mode. 
+		// Vertices more than 1.5 view sizes off screen get clamped.
+		bool packedVertices = false;
+		// Stream batches through a persistently mapped ring buffer instead of 
+		// unmapping, orphaning and remapping the VBO on every flush.
+		bool ringStreaming = true;
+		uint32_t ringSegments = 3;
+		// The vertex data of a batch is generated in parallel, in a few chunks
+		// per hardware thread but never fewer sprites a chunk than this.
+		// 0 disables this, as does a machine with a single hardware thread.
+		size_t parallelChunkSize = 256;
+		// Threads batches are split for, 0 uses the hardware thread count
+		size_t parallelThreads = 0;
+		// Sort sprites by depth and texture before batching (see SpriteSorter)
+		bool sortSprites = false;
+		// Skip sprites outside of the view before generating any vertices
+		bool cullSprites = false;
+	};
+
+	struct BatchRenderer2DStats {
+		size_t sprites = 0;
+		// Sprites removed by culling, these are not counted in sprites
+		size_t culled = 0;
+		// Every flush ends a batch, drawCalls only counts the non empty ones
+		size_t flushes = 0;
+		size_t drawCalls = 0;
+		// Bytes of vertex/instance data written for the GPU
+		size_t vertexBytes = 0;
+		// Times the CPU had to wait for the GPU to free a ring segment
+		size_t ringStalls = 0;
+		// Sprites drawn from static layers, not counted in sprites
+		size_t staticSprites = 0;
+		// Bytes sent to update static layers
+		size_t staticUploadBytes = 0;
+		// Time spent in the sort pre-pass in microseconds
+		float sortTime = 0.0f;
+		// Time spent writing vertex/instance data in microseconds
+		float vertexTime = 0.0f;
+	};
+
+	class BatchRenderer2D {
+		public:
+
+			using SpriteVertex = ogl::SpriteVertex;
+			using SpriteInstance = ogl::SpriteInstance;
+			using Stats = BatchRenderer2DStats;
+			using Settings = BatchRenderer2DSettings;
+
+			BatchRenderer2D(const GraphicsContext& context, const Settings& settings = Settings{});
+			BatchRenderer2D(const BatchRenderer2D&) = delete;
+			BatchRenderer2D(BatchRenderer2D&&) = delete;
+			~BatchRenderer2D();
+		
+			// process takes a RendererSpriteData struct and processes it for
+			// rendering. With an instanced renderer the sprite data should be sorted by
+			// texture to maxmise efficiency. If sortSprites is enabled this is done
+			// here, blend (one per sprite, optional) is then used to pick which
+			// sprites have to stay in back to front order.
+			// If cullSprites is enabled, sprites outside of the view (see get_view_rect)
+			// are dropped first.
+			void process(const RendererSpriteData&, const GraphicsContext&, const SpriteBlend* blend = nullptr);
+
+			// Same as above but the visible sprites are found with a query on grid,
+			// which must have been built from the sprite data, instead of testing 
+			// every sprite. Culling always happens here, whatever cullSprites is.
+			void process(const RendererSpriteData&, const SpriteGrid& grid, const GraphicsContext&, const SpriteBlend* blend = nullptr);
+
+			// Builds a static layer from data, batched for this renderer. The layer
+			// must not outlive the renderer.
+			std::unique_ptr<StaticSpriteLayer> create_static_layer(const RendererSpriteData& data);
+
+			// Uploads the dirty ranges of layer and draws it. Anything processed
+			// but not yet flushed is flushed first so draw order is kept.
+			void draw_static(StaticSpriteLayer& layer, const GraphicsContext&);
+
+			// Uploads the dirty ranges of layer and pushes a command per batch to
+			// queue instead of drawing. The upload needs GL, so this has to be
+			// called on the render thread. Batches of a layer keep their order,
+			// give layers that overlap different layerKeys to order them.
+			// Processed sprites can't be queued, their buffer space is reused as
+			// soon as they are flushed.
+			void queue_static(StaticSpriteLayer& layer, RenderQueue& queue, const GraphicsContext&, uint8_t layerKey = 0);
+
+			// Always make sure this is called before the end of each frame
+			// To make sure no buffered data is lying around
+			void flush(const GraphicsContext&);
+
+			float get_near() { return m_Near; }
+			void set_near(float n) { m_Near = n; }
+
+			float get_far() { return m_Far; }
+			void set_far(float f) { m_Far = f; }
+
+			SpriteRenderMode get_mode() const { return m_Mode; }
+
+			// The shader is compiled in the background (see
+			// ShaderBuilder::generate_async) and the first draw waits for it.
+			// True if it is done and drawing won't wait. Never blocks.
+			bool is_ready() { return m_Shader || m_PendingShader.is_ready(); }
+
+			// The area of the world visible with the projection used by flush
+			ViewRect get_view_rect(const GraphicsContext& ctx) const;
+
+			// The buffer batches are streamed through, for tools that inspect it
+			uint32_t get_vertex_buffer_id() const { return m_BatchVBO.get_renderer_id(); }
+
+			// Stats accumulate until reset_stats is called, so call it once
+			// per frame to get per frame numbers.
+			const Stats& get_stats() const { return m_Stats; }
+			void reset_stats() { m_Stats = Stats{}; }
+
+		private:
+			// visible is data after culling, blend is remapped to match it
+			void process_culled(const RendererSpriteData& data, const RendererSpriteData& visible, const GraphicsContext&, const SpriteBlend* blend);
+			void process_sorted(const RendererSpriteData&, const GraphicsContext&, const SpriteBlend* blend);
+			void process_batches(const RendererSpriteData&, const GraphicsContext&);
+			void transform_data(const RendererSpriteData& data);
+			// Writes data into the mapped VBO starting at sprite batchIndex.
+			// Safe to call from multiple threads for disjoint ranges.
+			void write_sprites(const RendererSpriteData& data, size_t batchIndex) const;
+			void map_batch();
+			Matrix4f calc_ortho_mat(const GraphicsContext& ctx);
+			// Uploads the projection to the FrameData block if it changed and
+			// binds the block's buffer
+			void update_frame_data(const GraphicsContext& ctx);
+			// Vertices mode only, sets the frame vertex positions are relative to
+			void set_pack_frame(const SpritePackFrame& frame);
+			SpritePackFrame calc_pack_frame(const GraphicsContext& ctx) const;
+			// The shader, waits for it to finish compiling the first time
+			Shader& shader();
+
+			const SpriteRenderMode m_Mode;
+			const bool m_RingStreaming;
+			const bool m_PackedVertices;
+
+			VertexBuffer m_BatchVBO;
+			IndexBuffer m_BatchIBO;
+			VertexArray m_VAO;
+			std::unique_ptr<Shader> m_Shader;
+			// Until the first call of shader()
+			PendingShader m_PendingShader;
+			// Holds the FrameData uniform block, the projection last sent to it
+			// is kept so unchanged frames don't upload it again
+			UniformBuffer m_FrameUBO;
+			Matrix4f m_FrameProjection;
+			bool m_FrameDataValid = false;
+			int32_t m_PackOriginLocation = -1;
+			int32_t m_PackScaleLocation = -1;
+
+			// Only the view matching m_Mode is ever mapped
+			MemView<SpriteVertex> m_BatchMappedVBO;
+			MemView<SpriteInstance> m_BatchMappedInstances;
+			MemView<SpriteVertexPacked> m_BatchMappedPacked;
+			// Frame the packed positions of the current batch are relative to
+			SpritePackFrame m_PackFrame;
+			// Texture slot of every sprite in the current batch, indexed 
+			// the same way as the sprites in the mapped VBO
+			std::vector<texslot_t> m_BatchTexSlots;
+			// Texture slots already handed out in the current batch
+			TextureSlotTable m_SlotTable;
+			const size_t m_ParallelChunkSize;
+			// Threads to split batches for. Hardware threads are queried once,
+			// it isn't free on every platform.
+			const size_t m_HardwareThreads;
+			const bool m_SortSprites;
+			SpriteSorter m_Sorter;
+			const bool m_CullSprites;
+			SpriteCuller m_Culler;
+			// Blend modes of the visible sprites, compacted alongside them
+			std::vector<SpriteBlend> m_CulledBlend;
+			// Chunk indices handed to the parallel algorithms, kept around
+			// so we don't allocate every batch
+			std::vector<size_t> m_Chunks;
+			size_t m_BatchSpriteCount = 0;
+			int32_t m_CurrentTexSlot = 0;
+			const int m_MaxTextureSlots;
+
+			float m_Near = -1.0f;
+			float m_Far = 100.0f;
+
+			Stats m_Stats;
+	};
+}
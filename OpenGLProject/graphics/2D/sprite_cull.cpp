@@ -0,0 +1,107 @@
+#include "sprite_cull.h"
+#include "sprite_grid.h"
+
+#include <algorithm>
+
+#ifdef OGL_ARCH_X86
+	#include <emmintrin.h>
+#endif
+
+namespace ogl {
+
+	static inline bool Overlaps(const Vector3f& pos, const Vector2f& size, const ViewRect& view) {
+		return pos.x < view.max.x && pos.x + size.x > view.min.x &&
+		       pos.y < view.max.y && pos.y + size.y > view.min.y;
+	}
+
+	size_t CullSprites(const RendererSpriteData& data, const ViewRect& view, uint32_t* out) {
+		size_t visible = 0;
+		size_t i = 0;
+
+#ifdef OGL_ARCH_X86
+		// SSE2 is always there on x86-64, so no runtime dispatch needed. Four
+		// sprites are tested at a time: the AoS positions and sizes are 
+		// transposed into x, y, w, h registers and the overlap test gives a 4
+		// bit mask of the survivors.
+		const __m128 minX = _mm_set1_ps(view.min.x);
+		const __m128 minY = _mm_set1_ps(view.min.y);
+		const __m128 maxX = _mm_set1_ps(view.max.x);
+		const __m128 maxY = _mm_set1_ps(view.max.y);
+
+		for(; i + 4 <= data.spriteCount; i += 4) {
+			const float* p = &data.pos[i].x;
+			const float* s = &data.size[i].x;
+
+			// p = x0 y0 z0 x1 | y1 z1 x2 y2 | z2 x3 y3 z3
+			const __m128 p0 = _mm_loadu_ps(p);
+			const __m128 p1 = _mm_loadu_ps(p + 4);
+			const __m128 p2 = _mm_loadu_ps(p + 8);
+			const __m128 x01y01 = _mm_shuffle_ps(p0, p0, _MM_SHUFFLE(1, 0, 3, 0)); // x0 x1 x0 y0
+			const __m128 x23 = _mm_shuffle_ps(p1, p2, _MM_SHUFFLE(1, 1, 2, 2));     // x2 x2 x3 x3
+			const __m128 x = _mm_shuffle_ps(x01y01, x23, _MM_SHUFFLE(2, 0, 1, 0));  // x0 x1 x2 x3
+			const __m128 y01 = _mm_shuffle_ps(p0, p1, _MM_SHUFFLE(0, 0, 1, 1));     // y0 y0 y1 y1
+			const __m128 y23 = _mm_shuffle_ps(p1, p2, _MM_SHUFFLE(2, 2, 3, 3));     // y2 y2 y3 y3
+			const __m128 y = _mm_shuffle_ps(y01, y23, _MM_SHUFFLE(2, 0, 2, 0));     // y0 y1 y2 y3
+
+			// s = w0 h0 w1 h1 | w2 h2 w3 h3
+			const __m128 s0 = _mm_loadu_ps(s);
+			const __m128 s1 = _mm_loadu_ps(s + 4);
+			const __m128 w = _mm_shuffle_ps(s0, s1, _MM_SHUFFLE(2, 0, 2, 0));
+			const __m128 h = _mm_shuffle_ps(s0, s1, _MM_SHUFFLE(3, 1, 3, 1));
+
+			const __m128 inX = _mm_and_ps(_mm_cmplt_ps(x, maxX), _mm_cmpgt_ps(_mm_add_ps(x, w), minX));
+			const __m128 inY = _mm_and_ps(_mm_cmplt_ps(y, maxY), _mm_cmpgt_ps(_mm_add_ps(y, h), minY));
+			int mask = _mm_movemask_ps(_mm_and_ps(inX, inY));
+
+			while(mask) {
+				const int bit = mask & -mask;
+				const uint32_t lane = bit == 1 ? 0 : bit == 2 ? 1 : bit == 4 ? 2 : 3;
+				out[visible++] = (uint32_t)i + lane;
+				mask ^= bit;
+			}
+		}
+#endif
+
+		for(; i < data.spriteCount; i++) {
+			if(Overlaps(data.pos[i], data.size[i], view)) out[visible++] = (uint32_t)i;
+		}
+
+		return visible;
+	}
+
+	RendererSpriteData SpriteCuller::cull(const RendererSpriteData& data, const ViewRect& view) {
+		m_Visible.resize(data.spriteCount);
+		const size_t count = CullSprites(data, view, m_Visible.data());
+		m_Visible.resize(count);
+		return gather(data);
+	}
+
+	RendererSpriteData SpriteCuller::cull(const RendererSpriteData& data, const SpriteGrid& grid, const ViewRect& view) {
+		m_Visible.clear();
+		grid.query(view, m_Visible);
+		// Cells come back in arbitrary order, restore the submission order
+		std::sort(m_Visible.begin(), m_Visible.end());
+		OGL_DEBUG_ASSERT(m_Visible.empty() || m_Visible.back() < data.spriteCount, "SpriteGrid does not match the sprite data");
+		return gather(data);
+	}
+
+	RendererSpriteData SpriteCuller::gather(const RendererSpriteData& data) {
+		const size_t count = m_Visible.size();
+		m_Pos.resize(count);
+		m_Size.resize(count);
+		m_Col.resize(count);
+		m_TexCoords.resize(count);
+		m_Textures.resize(count);
+		for(size_t i = 0; i < count; i++) {
+			const uint32_t src = m_Visible[i];
+			m_Pos[i] = data.pos[src];
+			m_Size[i] = data.size[src];
+			m_Col[i] = data.col[src];
+			m_TexCoords[i] = data.texCoords[src];
+			// Avoid touching the ref count when the texture is already there
+			if(m_Textures[i].get() != data.texture[src].get()) m_Textures[i] = data.texture[src];
+		}
+
+		return RendererSpriteData(m_Pos.data(), m_Size.data(), m_Col.data(), m_TexCoords.data(), m_Textures.data(), count);
+	}
+}
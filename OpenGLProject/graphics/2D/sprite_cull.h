@@ -0,0 +1,51 @@
+#pragma once
+
+#include <vector>
+
+#include "core.h"
+#include "math/vector.h"
+#include "sprite_data.h"
+
+namespace ogl {
+
+	// Axis aligned rectangle in world space
+	struct ViewRect {
+		Vector2f min;
+		Vector2f max;
+	};
+
+	// Writes the index of every sprite whose bounds overlap view to out and 
+	// returns how many there are. out must have room for data.spriteCount
+	// indices. Sprites are treated as the rect [pos, pos + size].
+	size_t CullSprites(const RendererSpriteData& data, const ViewRect& view, uint32_t* out);
+
+	class SpriteGrid;
+
+	// SpriteCuller removes sprites outside of a view rect before any vertex
+	// data is generated for them.
+	class SpriteCuller {
+	public:
+		// Returns the visible sprites. The returned data points into the culler
+		// and is only valid until the next call to cull.
+		RendererSpriteData cull(const RendererSpriteData& data, const ViewRect& view);
+
+		// Same as above but the visible sprites come from a query on grid, which
+		// must have been built from data. The order of data is kept.
+		RendererSpriteData cull(const RendererSpriteData& data, const SpriteGrid& grid, const ViewRect& view);
+
+		// visible()[i] is the index in the input of the i'th visible sprite
+		const std::vector<uint32_t>& visible() const { return m_Visible; }
+
+	private:
+		RendererSpriteData gather(const RendererSpriteData& data);
+
+		std::vector<uint32_t> m_Visible;
+
+		// Compacted copies of the SoA arrays
+		std::vector<Vector3f> m_Pos;
+		std::vector<Vector2f> m_Size;
+		std::vector<Vector4f> m_Col;
+		std::vector<TexCoords> m_TexCoords;
+		std::vector<std::shared_ptr<Texture2D>> m_Textures;
+	};
+}
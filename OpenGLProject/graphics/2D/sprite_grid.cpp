@@ -0,0 +1,122 @@
+#include "sprite_grid.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ogl {
+
+	SpriteGrid::SpriteGrid(float cellSize) : m_CellSize(cellSize), m_InvCellSize(1.0f / cellSize) {
+		OGL_ASSERT(cellSize > 0.0f, "SpriteGrid cell size must be positive");
+	}
+
+	void SpriteGrid::build(const RendererSpriteData& data) {
+		clear();
+		m_Entries.resize(data.spriteCount);
+		for(uint32_t i = 0; i < data.spriteCount; i++) insert(i, data.pos[i], data.size[i]);
+	}
+
+	void SpriteGrid::insert(uint32_t index, const Vector3f& pos, const Vector2f& size) {
+		if(index >= m_Entries.size()) m_Entries.resize((size_t)index + 1);
+		OGL_DEBUG_ASSERT(m_Entries[index].cell == s_NoCell, "Sprite is already in the grid");
+
+		auto& entry = m_Entries[index];
+		entry.min = Vector2f{ pos.x, pos.y };
+		entry.max = Vector2f{ pos.x + size.x, pos.y + size.y };
+		m_MaxSize.x = std::max(m_MaxSize.x, size.x);
+		m_MaxSize.y = std::max(m_MaxSize.y, size.y);
+
+		link(index, CellKey(to_cell(pos.x), to_cell(pos.y)));
+		m_Count++;
+	}
+
+	void SpriteGrid::update(uint32_t index, const Vector3f& pos, const Vector2f& size) {
+		OGL_DEBUG_ASSERT(contains(index), "Sprite is not in the grid");
+
+		auto& entry = m_Entries[index];
+		entry.min = Vector2f{ pos.x, pos.y };
+		entry.max = Vector2f{ pos.x + size.x, pos.y + size.y };
+		m_MaxSize.x = std::max(m_MaxSize.x, size.x);
+		m_MaxSize.y = std::max(m_MaxSize.y, size.y);
+
+		const uint64_t cell = CellKey(to_cell(pos.x), to_cell(pos.y));
+		if(cell == entry.cell) return;
+		unlink(index);
+		link(index, cell);
+	}
+
+	void SpriteGrid::remove(uint32_t index) {
+		OGL_DEBUG_ASSERT(contains(index), "Sprite is not in the grid");
+		unlink(index);
+		m_Count--;
+	}
+
+	void SpriteGrid::clear() {
+		m_Entries.clear();
+		m_Cells.clear();
+		m_MaxSize = Vector2f{ 0.0f, 0.0f };
+		m_Count = 0;
+	}
+
+	size_t SpriteGrid::query(const ViewRect& rect, std::vector<uint32_t>& out) const {
+		const size_t start = out.size();
+
+		const auto test = [&](const std::vector<uint32_t>& indices) {
+			for(const uint32_t i : indices) {
+				const auto& e = m_Entries[i];
+				if(e.min.x < rect.max.x && e.max.x > rect.min.x && e.min.y < rect.max.y && e.max.y > rect.min.y)
+					out.push_back(i);
+			}
+		};
+
+		// A sprite in a cell left of or below the rect can still reach into it
+		const int32_t x0 = to_cell(rect.min.x - m_MaxSize.x), x1 = to_cell(rect.max.x);
+		const int32_t y0 = to_cell(rect.min.y - m_MaxSize.y), y1 = to_cell(rect.max.y);
+		const uint64_t cellsInRect = (uint64_t)((int64_t)x1 - x0 + 1) * (uint64_t)((int64_t)y1 - y0 + 1);
+
+		// When zoomed far out it's cheaper to walk the occupied cells
+		if(cellsInRect > m_Cells.size()) {
+			for(const auto& [key, indices] : m_Cells) {
+				const int32_t x = (int32_t)(key >> 32), y = (int32_t)(uint32_t)key;
+				if(x >= x0 && x <= x1 && y >= y0 && y <= y1) test(indices);
+			}
+		} else {
+			for(int32_t y = y0; y <= y1; y++) {
+				for(int32_t x = x0; x <= x1; x++) {
+					const auto it = m_Cells.find(CellKey(x, y));
+					if(it != m_Cells.end()) test(it->second);
+				}
+			}
+		}
+
+		return out.size() - start;
+	}
+
+	int32_t SpriteGrid::to_cell(float v) const {
+		// Clamp so far away sprites share the edge cells instead of overflowing
+		const float c = std::floor(v * m_InvCellSize);
+		return (int32_t)std::clamp(c, (float)INT32_MIN / 2, (float)INT32_MAX / 2);
+	}
+
+	void SpriteGrid::link(uint32_t index, uint64_t cell) {
+		auto& indices = m_Cells[cell];
+		m_Entries[index].cell = cell;
+		m_Entries[index].slot = (uint32_t)indices.size();
+		indices.push_back(index);
+	}
+
+	void SpriteGrid::unlink(uint32_t index) {
+		auto& entry = m_Entries[index];
+		const auto it = m_Cells.find(entry.cell);
+		OGL_DEBUG_ASSERT(it != m_Cells.end());
+		auto& indices = it->second;
+
+		// Swap remove, the moved sprite takes over the slot
+		const uint32_t last = indices.back();
+		indices[entry.slot] = last;
+		m_Entries[last].slot = entry.slot;
+		indices.pop_back();
+		if(indices.empty()) m_Cells.erase(it);
+
+		entry.cell = s_NoCell;
+	}
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <vector>
+#include <unordered_map>
+
+#include "core.h"
+#include "math/vector.h"
+#include "sprite_data.h"
+#include "sprite_cull.h"
+
+namespace ogl {
+
+	// SpriteGrid is a sparse uniform grid (spatial hash) of sprite indices.
+	// Only cells that hold sprites are allocated, so the world doesn't need
+	// bounds. Each sprite lives in exactly one cell, the one containing its
+	// min corner, and queries are widened by the largest sprite size seen so
+	// sprites overlapping into neighbouring cells are still found. This keeps
+	// updates O(1) but means cellSize should be at least the size of a typical
+	// sprite, a few huge sprites make every query visit more cells.
+	class SpriteGrid {
+	public:
+		SpriteGrid(float cellSize);
+
+		// Clears the grid and inserts every sprite in data, sprite i gets index i
+		void build(const RendererSpriteData& data);
+
+		// index must not already be in the grid
+		void insert(uint32_t index, const Vector3f& pos, const Vector2f& size);
+
+		// Moves a sprite, cheap when it stays in the same cell
+		void update(uint32_t index, const Vector3f& pos, const Vector2f& size);
+
+		void remove(uint32_t index);
+
+		void clear();
+
+		// Appends the index of every sprite overlapping rect to out, in no
+		// particular order, and returns how many were added. Costs
+		// O(cells in rect + sprites in those cells) rather than O(total).
+		size_t query(const ViewRect& rect, std::vector<uint32_t>& out) const;
+
+		bool contains(uint32_t index) const { return index < m_Entries.size() && m_Entries[index].cell != s_NoCell; }
+
+		float cell_size() const { return m_CellSize; }
+		size_t size() const { return m_Count; }
+		size_t cell_count() const { return m_Cells.size(); }
+
+	private:
+		struct Entry {
+			Vector2f min;
+			Vector2f max;
+			uint64_t cell = s_NoCell;
+			// Position in the cell's index list
+			uint32_t slot = 0;
+		};
+
+		// Key of cell (INT32_MAX, INT32_MAX), to_cell clamps to half the int
+		// range so it is never used by a sprite
+		static constexpr uint64_t s_NoCell = 0x7fffffff7fffffffull;
+
+		int32_t to_cell(float v) const;
+		static uint64_t CellKey(int32_t x, int32_t y) { return ((uint64_t)(uint32_t)x << 32) | (uint32_t)y; }
+
+		void link(uint32_t index, uint64_t cell);
+		void unlink(uint32_t index);
+
+		float m_CellSize;
+		float m_InvCellSize;
+		// Largest sprite width and height in the grid, never shrinks until clear
+		Vector2f m_MaxSize{ 0.0f, 0.0f };
+
+		std::vector<Entry> m_Entries;
+		std::unordered_map<uint64_t, std::vector<uint32_t>> m_Cells;
+		size_t m_Count = 0;
+	};
+}
@@ -0,0 +1,100 @@
+#include "sprite_sort.h"
+
+#include <cstring>
+
+namespace ogl {
+
+	// Maps a float to an unsigned int with the same ordering, so keys can be
+	// compared (and radix sorted) as plain integers.
+	static inline uint32_t FloatToSortable(float value) {
+		uint32_t bits;
+		std::memcpy(&bits, &value, sizeof(bits));
+		return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+	}
+
+	uint64_t MakeSpriteSortKey(float depth, uint32_t textureId, SpriteBlend blend) {
+		const uint64_t d = FloatToSortable(depth);
+		if(blend == SpriteBlend::Opaque) {
+			return ((uint64_t)(textureId & 0x7FFFFFFFu) << 32) | d;
+		}
+
+		// The sort is stable, so translucent sprites at the same depth keep the
+		// order they were submitted in
+		return (1ull << 63) | d;
+	}
+
+	RendererSpriteData SpriteSorter::sort(const RendererSpriteData& data, const SpriteBlend* blend) {
+		const size_t count = data.spriteCount;
+		m_Keys.resize(count);
+		m_KeysTemp.resize(count);
+		m_Order.resize(count);
+		m_OrderTemp.resize(count);
+
+		for(size_t i = 0; i < count; i++) {
+			const auto b = blend ? blend[i] : SpriteBlend::Translucent;
+			m_Keys[i] = MakeSpriteSortKey(data.pos[i].z, data.texture[i]->get_renderer_id(), b);
+			m_Order[i] = (uint32_t)i;
+		}
+
+		radix_sort(count);
+
+		// Gather the SoA arrays into sorted order
+		m_Pos.resize(count);
+		m_Size.resize(count);
+		m_Col.resize(count);
+		m_TexCoords.resize(count);
+		m_Textures.resize(count);
+		for(size_t i = 0; i < count; i++) {
+			const uint32_t src = m_Order[i];
+			m_Pos[i] = data.pos[src];
+			m_Size[i] = data.size[src];
+			m_Col[i] = data.col[src];
+			m_TexCoords[i] = data.texCoords[src];
+			// Copying a shared_ptr touches the ref count atomically, in a mostly
+			// static scene the same texture is usually already there
+			if(m_Textures[i].get() != data.texture[src].get()) m_Textures[i] = data.texture[src];
+		}
+
+		return RendererSpriteData(m_Pos.data(), m_Size.data(), m_Col.data(), m_TexCoords.data(), m_Textures.data(), count);
+	}
+
+	// LSD radix sort on 8 bit digits. Digits every key has in common (often
+	// most of them, e.g. when every sprite is at the same depth) are skipped.
+	void SpriteSorter::radix_sort(size_t count) {
+		constexpr int digitBits = 8;
+		constexpr int passes = 64 / digitBits;
+
+		uint32_t histograms[passes][256] = {};
+		for(size_t i = 0; i < count; i++) {
+			const uint64_t key = m_Keys[i];
+			for(int pass = 0; pass < passes; pass++) {
+				histograms[pass][(key >> (pass * digitBits)) & 0xFF]++;
+			}
+		}
+
+		for(int pass = 0; pass < passes; pass++) {
+			auto& histogram = histograms[pass];
+			const int shift = pass * digitBits;
+
+			// Every key has the same digit, this pass wouldn't move anything
+			if(count == 0 || histogram[(m_Keys[0] >> shift) & 0xFF] == count) continue;
+
+			uint32_t offset = 0;
+			for(auto& bucket : histogram) {
+				const uint32_t size = bucket;
+				bucket = offset;
+				offset += size;
+			}
+
+			for(size_t i = 0; i < count; i++) {
+				const uint64_t key = m_Keys[i];
+				const uint32_t dst = histogram[(key >> shift) & 0xFF]++;
+				m_KeysTemp[dst] = key;
+				m_OrderTemp[dst] = m_Order[i];
+			}
+
+			m_Keys.swap(m_KeysTemp);
+			m_Order.swap(m_OrderTemp);
+		}
+	}
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <vector>
+
+#include "core.h"
+#include "sprite_data.h"
+
+namespace ogl {
+
+	// Opaque sprites can be drawn in any order, so they are only grouped by
+	// texture. Translucent sprites have to be drawn back to front.
+	enum class SpriteBlend : uint8_t {
+		Opaque,
+		Translucent
+	};
+
+	// Builds the 64 bit sort key for a sprite. Keys sort opaque sprites before
+	// translucent ones:
+	//
+	//   Opaque:      [63] 0 | [62..32] texture id | [31..0]  depth
+	//   Translucent: [63] 1 | [62..32] unused     | [31..0]  depth
+	//
+	// Depth is pos.z, smaller values are further away so they sort first.
+	// Translucent sprites at equal depth are not grouped by texture, that
+	// would change the order they blend in.
+	uint64_t MakeSpriteSortKey(float depth, uint32_t textureId, SpriteBlend blend);
+
+	// SpriteSorter reorders RendererSpriteData so sprites sharing a texture end
+	// up next to each other, which minimises texture slot churn and flushes in
+	// BatchRenderer2D, while keeping translucent sprites back to front.
+	class SpriteSorter {
+	public:
+		// Returns the sorted sprites. The returned data points into the sorter
+		// and is only valid until the next call to sort. If blend is null every
+		// sprite is treated as translucent.
+		RendererSpriteData sort(const RendererSpriteData& data, const SpriteBlend* blend = nullptr);
+
+		// order()[i] is the index in the input of the i'th sorted sprite
+		const std::vector<uint32_t>& order() const { return m_Order; }
+
+	private:
+		void radix_sort(size_t count);
+
+		std::vector<uint64_t> m_Keys, m_KeysTemp;
+		std::vector<uint32_t> m_Order, m_OrderTemp;
+
+		// Sorted copies of the SoA arrays
+		std::vector<Vector3f> m_Pos;
+		std::vector<Vector2f> m_Size;
+		std::vector<Vector4f> m_Col;
+		std::vector<TexCoords> m_TexCoords;
+		std::vector<std::shared_ptr<Texture2D>> m_Textures;
+	};
+}
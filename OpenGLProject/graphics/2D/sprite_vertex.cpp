@@ -0,0 +1,159 @@
+#include "sprite_vertex.h"
+
+#ifdef OGL_ARCH_X86
+	#include <immintrin.h>
+#endif
+
+// Vertices are written in the same order as the index buffer expects:
+//
+//     1 *--------------* 2
+//       |              |
+//       |              |
+//     0 *--------------* 3
+
+namespace ogl {
+
+	void ExpandSprites(const RendererSpriteData& data, const texslot_t* slots, SpriteVertex* out) {
+		for (size_t i = 0; i < data.spriteCount; i++) {
+			const auto& pos = data.pos[i];
+			const auto& size = data.size[i];
+			const auto& col = data.col[i];
+			const auto& tc = data.texCoords[i];
+			const auto texId = slots[i];
+
+			const float right = pos.x + size.x;
+			const float top = pos.y + size.y;
+			const float u1 = tc.pos.x + tc.size.x;
+			const float v1 = tc.pos.y + tc.size.y;
+
+			SpriteVertex* quad = out + i * 4;
+			quad[0] = SpriteVertex{ { pos.x, pos.y, pos.z }, col, { tc.pos.x, tc.pos.y }, texId };
+			quad[1] = SpriteVertex{ { pos.x, top,   pos.z }, col, { tc.pos.x, v1       }, texId };
+			quad[2] = SpriteVertex{ { right, top,   pos.z }, col, { u1,       v1       }, texId };
+			quad[3] = SpriteVertex{ { right, pos.y, pos.z }, col, { u1,       tc.pos.y }, texId };
+		}
+	}
+
+	static inline uint8_t NormaliseToU8(float value) {
+		value = value < 0.0f ? 0.0f : (value > 1.0f ? 1.0f : value);
+		return (uint8_t)(value * 255.0f + 0.5f);
+	}
+
+	SpritePackFrame MakeSpritePackFrame(const Vector2f& viewMin, const Vector2f& viewMax, float zNear, float zFar) {
+		const Vector3f origin = { (viewMin.x + viewMax.x) / 2.0f, (viewMin.y + viewMax.y) / 2.0f, (zNear + zFar) / 2.0f };
+		const Vector3f scale = { 
+			(viewMax.x - viewMin.x) / 2.0f * sprite_pack_view_range, 
+			(viewMax.y - viewMin.y) / 2.0f * sprite_pack_view_range, 
+			(zFar - zNear) / 2.0f 
+		};
+		return SpritePackFrame{ origin, scale };
+	}
+
+	static inline int16_t NormaliseToS16(float value) {
+		value = value < -1.0f ? -1.0f : (value > 1.0f ? 1.0f : value);
+		return (int16_t)(value * 32767.0f + (value < 0.0f ? -0.5f : 0.5f));
+	}
+
+	static inline uint16_t NormaliseToU16(float value) {
+		value = value < 0.0f ? 0.0f : (value > 1.0f ? 1.0f : value);
+		return (uint16_t)(value * 65535.0f + 0.5f);
+	}
+
+	void PackSpriteVertices(const RendererSpriteData& data, const texslot_t* slots, const SpritePackFrame& frame, SpriteVertexPacked* out) {
+		const Vector3f inv = { 1.0f / frame.scale.x, 1.0f / frame.scale.y, 1.0f / frame.scale.z };
+		size_t i = 0;
+
+#ifdef OGL_ARCH_X86
+		// Same maths as the scalar loop below, including the round half away
+		// from zero, so the output is identical. Each quad is exactly four
+		// 16 byte registers: (x | y << 16, z | texId << 16, colour, u | v << 16)
+		const __m128 origin = _mm_setr_ps(frame.origin.x, frame.origin.y, frame.origin.x, frame.origin.y);
+		const __m128 invScale = _mm_setr_ps(inv.x, inv.y, inv.x, inv.y);
+		const __m128 zero = _mm_setzero_ps();
+		const __m128 one = _mm_set1_ps(1.0f);
+		const __m128 half = _mm_set1_ps(0.5f);
+		const __m128 signBit = _mm_set1_ps(-0.0f);
+
+		if ((uintptr_t)out % 16 == 0) {
+			__m128i* dst = reinterpret_cast<__m128i*>(out);
+			for (; i < data.spriteCount; i++) {
+				const auto& pos = data.pos[i];
+				const auto& size = data.size[i];
+				const auto& col = data.col[i];
+				const auto& tc = data.texCoords[i];
+				OGL_DEBUG_ASSERT(slots[i] <= UINT8_MAX, "Texture slot does not fit in a packed vertex");
+
+				// x0 y0 x1 y1 as snorm16
+				__m128 p = _mm_setr_ps(pos.x, pos.y, pos.x + size.x, pos.y + size.y);
+				p = _mm_mul_ps(_mm_sub_ps(p, origin), invScale);
+				p = _mm_mul_ps(_mm_min_ps(_mm_max_ps(p, _mm_set1_ps(-1.0f)), one), _mm_set1_ps(32767.0f));
+				p = _mm_add_ps(p, _mm_or_ps(_mm_and_ps(p, signBit), half));
+				alignas(16) int32_t xy[4];
+				_mm_store_si128(reinterpret_cast<__m128i*>(xy), _mm_cvttps_epi32(p));
+
+				// u0 v0 u1 v1 as unorm16
+				__m128 t = _mm_setr_ps(tc.pos.x, tc.pos.y, tc.pos.x + tc.size.x, tc.pos.y + tc.size.y);
+				t = _mm_add_ps(_mm_mul_ps(_mm_min_ps(_mm_max_ps(t, zero), one), _mm_set1_ps(65535.0f)), half);
+				alignas(16) int32_t uv[4];
+				_mm_store_si128(reinterpret_cast<__m128i*>(uv), _mm_cvttps_epi32(t));
+
+				// rgba as unorm8, every lane is in [0, 255] so the packs can't saturate
+				__m128 c = _mm_loadu_ps(&col.x);
+				c = _mm_add_ps(_mm_mul_ps(_mm_min_ps(_mm_max_ps(c, zero), one), _mm_set1_ps(255.0f)), half);
+				const __m128i c16 = _mm_packs_epi32(_mm_cvttps_epi32(c), _mm_setzero_si128());
+				const int32_t colour = _mm_cvtsi128_si32(_mm_packus_epi16(c16, _mm_setzero_si128()));
+
+				const int32_t zId = (uint16_t)NormaliseToS16((pos.z - frame.origin.z) * inv.z) | (int32_t)(slots[i] << 16);
+				const auto word = [](int32_t lo, int32_t hi) { return (int32_t)((uint32_t)(uint16_t)lo | ((uint32_t)hi << 16)); };
+
+				_mm_stream_si128(dst + 0, _mm_setr_epi32(word(xy[0], xy[1]), zId, colour, word(uv[0], uv[1])));
+				_mm_stream_si128(dst + 1, _mm_setr_epi32(word(xy[0], xy[3]), zId, colour, word(uv[0], uv[3])));
+				_mm_stream_si128(dst + 2, _mm_setr_epi32(word(xy[2], xy[3]), zId, colour, word(uv[2], uv[3])));
+				_mm_stream_si128(dst + 3, _mm_setr_epi32(word(xy[2], xy[1]), zId, colour, word(uv[2], uv[1])));
+				dst += 4;
+			}
+			_mm_sfence();
+			return;
+		}
+#endif
+
+		for (; i < data.spriteCount; i++) {
+			const auto& pos = data.pos[i];
+			const auto& size = data.size[i];
+			const auto& col = data.col[i];
+			const auto& tc = data.texCoords[i];
+			OGL_DEBUG_ASSERT(slots[i] <= UINT8_MAX, "Texture slot does not fit in a packed vertex");
+			const uint8_t texId = (uint8_t)slots[i];
+
+			const int16_t x0 = NormaliseToS16((pos.x - frame.origin.x) * inv.x);
+			const int16_t y0 = NormaliseToS16((pos.y - frame.origin.y) * inv.y);
+			const int16_t x1 = NormaliseToS16((pos.x + size.x - frame.origin.x) * inv.x);
+			const int16_t y1 = NormaliseToS16((pos.y + size.y - frame.origin.y) * inv.y);
+			const int16_t z = NormaliseToS16((pos.z - frame.origin.z) * inv.z);
+			const uint16_t u0 = NormaliseToU16(tc.pos.x);
+			const uint16_t v0 = NormaliseToU16(tc.pos.y);
+			const uint16_t u1 = NormaliseToU16(tc.pos.x + tc.size.x);
+			const uint16_t v1 = NormaliseToU16(tc.pos.y + tc.size.y);
+			const Vector4<uint8_t> colour = { NormaliseToU8(col.x), NormaliseToU8(col.y), NormaliseToU8(col.z), NormaliseToU8(col.w) };
+
+			SpriteVertexPacked* quad = out + i * 4;
+			quad[0] = SpriteVertexPacked{ { x0, y0, z }, texId, 0, colour, { u0, v0 } };
+			quad[1] = SpriteVertexPacked{ { x0, y1, z }, texId, 0, colour, { u0, v1 } };
+			quad[2] = SpriteVertexPacked{ { x1, y1, z }, texId, 0, colour, { u1, v1 } };
+			quad[3] = SpriteVertexPacked{ { x1, y0, z }, texId, 0, colour, { u1, v0 } };
+		}
+	}
+
+	void PackSpriteInstances(const RendererSpriteData& data, const texslot_t* slots, SpriteInstance* out) {
+		for (size_t i = 0; i < data.spriteCount; i++) {
+			const auto& col = data.col[i];
+			out[i] = SpriteInstance{ 
+				data.pos[i], 
+				data.size[i], 
+				{ NormaliseToU8(col.x), NormaliseToU8(col.y), NormaliseToU8(col.z), NormaliseToU8(col.w) },
+				data.texCoords[i], 
+				slots[i] 
+			};
+		}
+	}
+}
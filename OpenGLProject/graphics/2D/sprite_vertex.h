@@ -0,0 +1,83 @@
+#pragma once
+
+#include "core.h"
+#include "math/vector.h"
+#include "graphics/texture.h"
+#include "sprite_data.h"
+
+namespace ogl {
+
+	// Vertices: each sprite is expanded into 4 SpriteVertex entries on the CPU
+	// and drawn with a static index buffer.
+	// Instanced: each sprite is uploaded as a single SpriteInstance and the 
+	// vertex shader expands it into a quad.
+	enum class SpriteRenderMode {
+		Vertices,
+		Instanced
+	};
+
+	// SpriteVertex is the per-vertex layout uploaded by BatchRenderer2D.
+	// Each sprite expands to 4 of these (see instance_renderer.cpp for the
+	// winding order).
+	struct SpriteVertex {
+		Vector3f position;
+		Vector4f colour;
+		Vector2f texCoord;
+		texslot_t texId;
+	};
+
+	static_assert(sizeof(SpriteVertex) == 40, "SpriteVertex should be tightly packed");
+
+	// Positions in a SpriteVertexPacked are stored relative to a frame, the
+	// world position is origin + position * scale with position in [-1, 1].
+	struct SpritePackFrame {
+		Vector3f origin;
+		Vector3f scale;
+	};
+
+	// Pack frames made for a view are this many times its size, so positions
+	// up to 1.5 view sizes past its edges are stored exactly (within ~0.1px
+	// at 1080p) and only sprites far off screen get clamped.
+	constexpr float sprite_pack_view_range = 4.0f;
+
+	// The frame BatchRenderer2D packs vertices in for a view, z spans [zNear, zFar]
+	SpritePackFrame MakeSpritePackFrame(const Vector2f& viewMin, const Vector2f& viewMax, float zNear, float zFar);
+
+	// SpriteVertexPacked is the compact alternative to SpriteVertex, 16 bytes
+	// instead of 40. Every attribute is a normalised integer so the shader 
+	// still sees floats: snorm16 positions in a SpritePackFrame, unorm8 colour
+	// and unorm16 texture coordinates, which therefore must be in [0, 1].
+	struct SpriteVertexPacked {
+		Vector3<int16_t> position;
+		uint8_t texId;
+		uint8_t padding;
+		Vector4<uint8_t> colour;
+		Vector2<uint16_t> texCoord;
+	};
+
+	static_assert(sizeof(SpriteVertexPacked) == 16, "SpriteVertexPacked should be tightly packed");
+
+	// SpriteInstance is the per-sprite record used by the instanced mode of
+	// BatchRenderer2D. The vertex shader expands it into a quad, so one of
+	// these replaces 4 SpriteVertex entries (44 bytes instead of 160).
+	struct SpriteInstance {
+		Vector3f position;
+		Vector2f size;
+		Vector4<uint8_t> colour; // normalised RGBA8
+		TexCoords texCoords;
+		texslot_t texId;
+	};
+
+	static_assert(sizeof(SpriteInstance) == 44, "SpriteInstance should be tightly packed");
+
+	// Writes 4 vertices per sprite in data to out, a whole quad at a time.
+	// slots must hold one texture slot per sprite in data.
+	void ExpandSprites(const RendererSpriteData& data, const texslot_t* slots, SpriteVertex* out);
+
+	// Writes 4 packed vertices per sprite in data to out, in the same order as
+	// ExpandSprites. Positions outside of frame are clamped to it.
+	void PackSpriteVertices(const RendererSpriteData& data, const texslot_t* slots, const SpritePackFrame& frame, SpriteVertexPacked* out);
+
+	// Writes one SpriteInstance per sprite in data to out.
+	void PackSpriteInstances(const RendererSpriteData& data, const texslot_t* slots, SpriteInstance* out);
+}
@@ -0,0 +1,121 @@
+#include "static_sprite_layer.h"
+
+#include <algorithm>
+
+namespace ogl {
+
+	// Dirty ranges closer than this many sprites are uploaded as one range,
+	// a few extra bytes are cheaper than another glBufferSubData call
+	static constexpr size_t s_DirtyMergeGap = 64;
+
+	StaticSpriteLayer::StaticSpriteLayer(const RendererSpriteData& data, SpriteRenderMode mode, int32_t maxTextureSlots, size_t maxBatchSprites)
+		: m_Mode(mode), m_MaxTextureSlots(maxTextureSlots), m_SpriteCount(data.spriteCount), m_Slots(data.spriteCount),
+		m_VBO(std::max<size_t>(data.spriteCount, 1) * (mode == SpriteRenderMode::Vertices ? 4 * sizeof(SpriteVertex) : sizeof(SpriteInstance)), BufferUsage::DynamicDraw)
+	{
+		if(m_Mode == SpriteRenderMode::Vertices) m_Vertices.resize(m_SpriteCount * 4);
+		else m_Instances.resize(m_SpriteCount);
+
+		// Split into batches the same way BatchRenderer2D does, a new batch
+		// starts when either the sprites or the texture slots run out
+		for(size_t i = 0; i < m_SpriteCount; i++) {
+			if(m_Batches.empty() || m_Batches.back().count == maxBatchSprites)
+				m_Batches.push_back(Batch{ i, 0, {} });
+
+			if(!find_slot(m_Batches.back(), data.texture[i], m_Slots[i])) {
+				m_Batches.push_back(Batch{ i, 0, {} });
+				find_slot(m_Batches.back(), data.texture[i], m_Slots[i]);
+			}
+			m_Batches.back().count++;
+		}
+
+		if(m_SpriteCount) {
+			write_sprites(0, data, m_Slots.data());
+			m_Dirty.emplace_back(0, m_SpriteCount);
+		}
+	}
+
+	bool StaticSpriteLayer::set_sprites(size_t first, const RendererSpriteData& data) {
+		OGL_DEBUG_ASSERT(first + data.spriteCount <= m_SpriteCount, "set_sprites is out of range");
+
+		size_t count = 0;
+		bool fits = true;
+		for(; count < data.spriteCount; count++) {
+			const size_t i = first + count;
+			if(!find_slot(batch_of(i), data.texture[count], m_Slots[i])) {
+				fits = false;
+				break;
+			}
+		}
+
+		if(count) {
+			write_sprites(first, data.subset(0, count), &m_Slots[first]);
+			m_Dirty.emplace_back(first, first + count);
+		}
+
+		return fits;
+	}
+
+	size_t StaticSpriteLayer::upload() {
+		if(m_Dirty.empty()) return 0;
+
+		std::sort(m_Dirty.begin(), m_Dirty.end());
+
+		const size_t bytes = sprite_bytes();
+		uint8_t* src = m_Mode == SpriteRenderMode::Vertices ? (uint8_t*)m_Vertices.data() : (uint8_t*)m_Instances.data();
+		size_t sent = 0;
+
+		auto range = m_Dirty.front();
+		auto send = [&]() {
+			const size_t size = (range.second - range.first) * bytes;
+			m_VBO.send_data(src + range.first * bytes, size, range.first * bytes);
+			sent += size;
+		};
+
+		for(size_t i = 1; i < m_Dirty.size(); i++) {
+			if(m_Dirty[i].first <= range.second + s_DirtyMergeGap) {
+				range.second = std::max(range.second, m_Dirty[i].second);
+			}
+			else {
+				send();
+				range = m_Dirty[i];
+			}
+		}
+		send();
+
+		m_Dirty.clear();
+		m_UploadedBytes += sent;
+		return sent;
+	}
+
+	bool StaticSpriteLayer::find_slot(Batch& batch, const std::shared_ptr<Texture2D>& texture, texslot_t& slot) {
+		const uint32_t glId = texture->get_renderer_id();
+		for(size_t i = 0; i < batch.textures.size(); i++) {
+			if(batch.textures[i]->get_renderer_id() == glId) {
+				slot = (texslot_t)i;
+				return true;
+			}
+		}
+
+		if(batch.textures.size() == (size_t)m_MaxTextureSlots) return false;
+
+		slot = (texslot_t)batch.textures.size();
+		batch.textures.push_back(texture);
+		return true;
+	}
+
+	StaticSpriteLayer::Batch& StaticSpriteLayer::batch_of(size_t sprite) {
+		auto it = std::upper_bound(m_Batches.begin(), m_Batches.end(), sprite,
+			[](size_t i, const Batch& batch) { return i < batch.first; });
+		OGL_DEBUG_ASSERT(it != m_Batches.begin());
+		return *(it - 1);
+	}
+
+	void StaticSpriteLayer::write_sprites(size_t first, const RendererSpriteData& data, const texslot_t* slots) {
+		if(m_Mode == SpriteRenderMode::Vertices) ExpandSprites(data, slots, &m_Vertices[first * 4]);
+		else PackSpriteInstances(data, slots, &m_Instances[first]);
+	}
+
+	size_t StaticSpriteLayer::sprite_bytes() const {
+		return m_Mode == SpriteRenderMode::Vertices ? 4 * sizeof(SpriteVertex) : sizeof(SpriteInstance);
+	}
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <vector>
+
+#include "core.h"
+#include "graphics/buffer.h"
+#include "graphics/vertex_array.h"
+#include "graphics/texture.h"
+#include "sprite_data.h"
+#include "sprite_vertex.h"
+
+namespace ogl {
+
+	// StaticSpriteLayer keeps the vertex data for sprites that rarely change
+	// (tilemaps, backgrounds) in a GPU buffer of its own. The vertices are
+	// generated once and only the ranges touched by set_sprites are uploaded
+	// again, so drawing an unchanged layer costs no vertex work at all.
+	// Create one with BatchRenderer2D::create_static_layer and draw it with
+	// BatchRenderer2D::draw_static.
+	class StaticSpriteLayer {
+	public:
+		StaticSpriteLayer(const StaticSpriteLayer&) = delete;
+		StaticSpriteLayer(StaticSpriteLayer&&) = delete;
+
+		// Overwrites sprites [first, first + data.spriteCount). Textures may only
+		// change to ones that still fit in the texture slots of the draw batch a
+		// sprite was built into. If one doesn't, false is returned, the sprites
+		// before it have been updated and the layer should be rebuilt.
+		bool set_sprites(size_t first, const RendererSpriteData& data);
+
+		// Sends the dirty ranges to the GPU and returns the number of bytes sent
+		size_t upload();
+
+		size_t size() const { return m_SpriteCount; }
+		size_t batch_count() const { return m_Batches.size(); }
+		bool is_dirty() const { return !m_Dirty.empty(); }
+		// Total bytes sent with upload, including the initial upload
+		size_t uploaded_bytes() const { return m_UploadedBytes; }
+
+	private:
+		friend class BatchRenderer2D;
+
+		StaticSpriteLayer(const RendererSpriteData& data, SpriteRenderMode mode, int32_t maxTextureSlots, size_t maxBatchSprites);
+
+		// Sprites [first, first + count) are drawn together with textures[i]
+		// bound to slot i.
+		struct Batch {
+			size_t first;
+			size_t count;
+			std::vector<std::shared_ptr<Texture2D>> textures;
+		};
+
+		// Finds or adds the slot for texture in batch, returns false if full
+		bool find_slot(Batch& batch, const std::shared_ptr<Texture2D>& texture, texslot_t& slot);
+		Batch& batch_of(size_t sprite);
+		void write_sprites(size_t first, const RendererSpriteData& data, const texslot_t* slots);
+		size_t sprite_bytes() const;
+
+		const SpriteRenderMode m_Mode;
+		const int32_t m_MaxTextureSlots;
+		size_t m_SpriteCount;
+
+		// CPU copy of the buffer contents, only the one matching m_Mode is used
+		std::vector<SpriteVertex> m_Vertices;
+		std::vector<SpriteInstance> m_Instances;
+		std::vector<Batch> m_Batches;
+		// Sprite ranges [begin, end) changed since the last upload
+		std::vector<std::pair<size_t, size_t>> m_Dirty;
+		std::vector<texslot_t> m_Slots;
+		size_t m_UploadedBytes = 0;
+
+		VertexBuffer m_VBO;
+		VertexArray m_VAO;
+	};
+}
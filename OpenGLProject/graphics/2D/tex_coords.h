@@ -1,10 +1,10 @@
-#pragma once
-#include "math/vector.h"
-
-namespace ogl {
-
-	struct TexCoords {
-		Vector2f pos;
-		Vector2f size;
-	};
-}
+#pragma once
+#include "math/vector.h"
+
+namespace ogl {
+
+	struct TexCoords {
+		Vector2f pos;
+		Vector2f size;
+	};
+}
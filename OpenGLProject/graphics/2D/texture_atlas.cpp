@@ -0,0 +1,186 @@
+#include "texture_atlas.h"
+
+#include <algorithm>
+#include <numeric>
+#include <limits>
+#include <cstring>
+
+namespace ogl {
+
+	SkylinePacker::SkylinePacker(int width, int height) : m_Width(width), m_Height(height) {
+		reset();
+	}
+
+	void SkylinePacker::reset() {
+		m_Skyline.clear();
+		m_Skyline.push_back(Segment{ 0, 0, m_Width });
+		m_UsedArea = 0;
+	}
+
+	int SkylinePacker::used_height() const {
+		int height = 0;
+		for(const auto& seg : m_Skyline) height = std::max(height, seg.y);
+		return height;
+	}
+
+	int SkylinePacker::fit(size_t index, int width, int height) const {
+		const int x = m_Skyline[index].x;
+		if(x + width > m_Width) return -1;
+
+		// The rect rests on the highest segment it spans
+		int y = 0;
+		int widthLeft = width;
+		for(size_t i = index; widthLeft > 0; i++) {
+			y = std::max(y, m_Skyline[i].y);
+			if(y + height > m_Height) return -1;
+			widthLeft -= m_Skyline[i].width;
+		}
+
+		return y;
+	}
+
+	std::optional<Vector2i> SkylinePacker::insert(int width, int height) {
+		if(width <= 0 || height <= 0) return std::nullopt;
+
+		int bestTop = std::numeric_limits<int>::max();
+		int bestSegmentWidth = std::numeric_limits<int>::max();
+		size_t bestIndex = m_Skyline.size();
+		int bestY = 0;
+
+		// Pick the lowest top edge, and the narrowest segment when tied
+		for(size_t i = 0; i < m_Skyline.size(); i++) {
+			const int y = fit(i, width, height);
+			if(y < 0) continue;
+
+			const int top = y + height;
+			if(top < bestTop || (top == bestTop && m_Skyline[i].width < bestSegmentWidth)) {
+				bestTop = top;
+				bestSegmentWidth = m_Skyline[i].width;
+				bestIndex = i;
+				bestY = y;
+			}
+		}
+
+		if(bestIndex == m_Skyline.size()) return std::nullopt;
+
+		const int x = m_Skyline[bestIndex].x;
+		add_level(bestIndex, x, bestY, width, height);
+		m_UsedArea += (size_t)width * (size_t)height;
+		return Vector2i{ x, bestY };
+	}
+
+	void SkylinePacker::add_level(size_t index, int x, int y, int width, int height) {
+		m_Skyline.insert(m_Skyline.begin() + index, Segment{ x, y + height, width });
+
+		// Shrink or remove the segments now covered by the new one
+		const int right = x + width;
+		for(size_t i = index + 1; i < m_Skyline.size();) {
+			auto& seg = m_Skyline[i];
+			if(seg.x >= right) break;
+
+			const int segRight = seg.x + seg.width;
+			if(segRight <= right) {
+				m_Skyline.erase(m_Skyline.begin() + i);
+				continue;
+			}
+
+			seg.width = segRight - right;
+			seg.x = right;
+			break;
+		}
+
+		// Merge neighbours that ended up at the same height
+		for(size_t i = 0; i + 1 < m_Skyline.size();) {
+			if(m_Skyline[i].y == m_Skyline[i + 1].y) {
+				m_Skyline[i].width += m_Skyline[i + 1].width;
+				m_Skyline.erase(m_Skyline.begin() + i + 1);
+			}
+			else i++;
+		}
+	}
+
+	TextureAtlas::TextureAtlas(int width, int height, int padding) 
+		: m_Packer(width, height), m_Image(width, height), m_Padding(padding) {
+		// Start fully transparent so unused space doesn't show up when filtering
+		std::memset(m_Image.data, 0, (size_t)width * (size_t)height * sizeof(Image::pixel_t));
+	}
+
+	std::optional<TexCoords> TextureAtlas::insert(const ImageView& image) {
+		const auto pos = m_Packer.insert(image.width + m_Padding * 2, image.height + m_Padding * 2);
+		if(!pos) return std::nullopt;
+
+		blit(image, *pos);
+
+		const float w = (float)m_Image.width;
+		const float h = (float)m_Image.height;
+		return TexCoords{ 
+			{ (pos->x + m_Padding) / w, (pos->y + m_Padding) / h }, 
+			{ image.width / w, image.height / h } 
+		};
+	}
+
+	std::optional<std::vector<TexCoords>> TextureAtlas::insert_all(const std::vector<const Image*>& images) {
+		std::vector<size_t> order(images.size());
+		std::iota(order.begin(), order.end(), 0);
+		std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+			if(images[a]->height != images[b]->height) return images[a]->height > images[b]->height;
+			return images[a]->width > images[b]->width;
+		});
+
+		// Pack into a copy first, nothing is committed unless everything fits
+		SkylinePacker packer = m_Packer;
+		std::vector<Vector2i> positions(images.size());
+		for(size_t index : order) {
+			const auto pos = packer.insert(images[index]->width + m_Padding * 2, images[index]->height + m_Padding * 2);
+			if(!pos) return std::nullopt;
+			positions[index] = *pos;
+		}
+		m_Packer = std::move(packer);
+
+		const float w = (float)m_Image.width;
+		const float h = (float)m_Image.height;
+		std::vector<TexCoords> coords(images.size());
+		for(size_t i = 0; i < images.size(); i++) {
+			const Image& image = *images[i];
+			blit(image, positions[i]);
+			coords[i] = TexCoords{
+				{ (positions[i].x + m_Padding) / w, (positions[i].y + m_Padding) / h },
+				{ image.width / w, image.height / h }
+			};
+		}
+
+		return coords;
+	}
+
+	void TextureAtlas::blit(const ImageView& image, Vector2i pos) {
+		const size_t stride = (size_t)m_Image.width;
+		const int x = pos.x + m_Padding;
+		const int y = pos.y + m_Padding;
+
+		// Rows of the image, with the first and last texel repeated sideways
+		for(int row = 0; row < image.height; row++) {
+			const Image::pixel_t* src = image.row(row);
+			Image::pixel_t* dst = m_Image.data + (size_t)(y + row) * stride + x;
+			std::memcpy(dst, src, (size_t)image.width * sizeof(Image::pixel_t));
+			std::fill(dst - m_Padding, dst, src[0]);
+			std::fill(dst + image.width, dst + image.width + m_Padding, src[image.width - 1]);
+		}
+
+		// Then the first and last rows, corners included, repeated up and down
+		const size_t paddedWidth = (size_t)image.width + (size_t)m_Padding * 2;
+		const Image::pixel_t* bottom = m_Image.data + (size_t)y * stride + pos.x;
+		const Image::pixel_t* top = m_Image.data + (size_t)(y + image.height - 1) * stride + pos.x;
+		for(int i = 0; i < m_Padding; i++) {
+			std::memcpy(m_Image.data + (size_t)(pos.y + i) * stride + pos.x, bottom, paddedWidth * sizeof(Image::pixel_t));
+			std::memcpy(m_Image.data + (size_t)(y + image.height + i) * stride + pos.x, top, paddedWidth * sizeof(Image::pixel_t));
+		}
+
+		m_PixelsUsed += (size_t)image.width * (size_t)image.height;
+	}
+
+	float TextureAtlas::occupancy() const {
+		const int height = m_Packer.used_height();
+		if(!height) return 0.0f;
+		return (float)m_PixelsUsed / ((float)m_Image.width * (float)height);
+	}
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <optional>
+#include <vector>
+
+#include "core.h"
+#include "math/vector.h"
+#include "util/image.h"
+#include "tex_coords.h"
+
+namespace ogl {
+
+	// SkylinePacker packs rectangles into a fixed size area using the
+	// skyline bottom-left heuristic. It only hands out positions, it does 
+	// not know about pixels.
+	class SkylinePacker {
+	public:
+		SkylinePacker(int width, int height);
+
+		// Returns the bottom left corner the rect was placed at, or nullopt
+		// if it does not fit anywhere.
+		std::optional<Vector2i> insert(int width, int height);
+		void reset();
+
+		int width() const { return m_Width; }
+		int height() const { return m_Height; }
+		// Area of all the rects inserted so far
+		size_t used_area() const { return m_UsedArea; }
+		// Height of the tallest point of the skyline
+		int used_height() const;
+
+	private:
+		struct Segment {
+			int x, y, width;
+		};
+
+		// Returns the height the rect would sit at if placed at segment
+		// index, or -1 if it doesn't fit there.
+		int fit(size_t index, int width, int height) const;
+		void add_level(size_t index, int x, int y, int width, int height);
+
+		int m_Width, m_Height;
+		size_t m_UsedArea = 0;
+		std::vector<Segment> m_Skyline;
+	};
+
+	// TextureAtlas copies many small Images into one large Image so they can
+	// share a single Texture2D (and a single texture slot). Images are stored
+	// bottom row first, so the returned TexCoords can be used as is.
+	class TextureAtlas {
+	public:
+		// padding is the number of pixels kept around each image. They are
+		// filled with copies of the image's edge texels, so filtering at the
+		// edge samples the image itself instead of a neighbour or nothing.
+		// Reduced mips still bleed once a texel spans more than the padding.
+		TextureAtlas(int width, int height, int padding = 1);
+
+		// Incremental insert. Returns nullopt if the image doesn't fit.
+		// Takes an Image or a view of part of one.
+		std::optional<TexCoords> insert(const ImageView& image);
+
+		// Offline packing. Inserting the tallest images first packs a lot
+		// tighter than inserting them in any order. The coords are returned
+		// in the same order as images. Returns nullopt if they don't all fit,
+		// the atlas is left as it was then.
+		std::optional<std::vector<TexCoords>> insert_all(const std::vector<const Image*>& images);
+
+		const Image& image() const { return m_Image; }
+
+		// Fraction of the rows used so far that is covered by images 
+		// (excluding padding). Useful for picking an atlas size.
+		float occupancy() const;
+
+	private:
+		// Copies image to the packed rect at pos and extrudes it into the padding
+		void blit(const ImageView& image, Vector2i pos);
+
+		SkylinePacker m_Packer;
+		Image m_Image;
+		const int m_Padding;
+		size_t m_PixelsUsed = 0;
+	};
+}
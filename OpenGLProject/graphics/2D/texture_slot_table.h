@@ -0,0 +1,74 @@
+#pragma once
+
+#include <vector>
+
+#include "core.h"
+#include "graphics/texture.h"
+
+namespace ogl {
+
+	// TextureSlotTable maps GL texture ids to the texture slot they were bound
+	// to in the current batch. It is an open addressing table with linear 
+	// probing. Entries are stamped with a generation so clearing the table
+	// between batches is O(1).
+	class TextureSlotTable {
+	public:
+		// capacity is rounded up to a power of two and should be at least
+		// twice the number of slots so probe chains stay short.
+		TextureSlotTable(size_t capacity) {
+			size_t size = 1;
+			while(size < capacity) size <<= 1;
+			m_Entries.resize(size);
+			m_Mask = size - 1;
+		}
+
+		// Returns true and sets slot if glId already has a slot in this batch.
+		bool find(uint32_t glId, texslot_t& slot) const {
+			for(size_t i = hash(glId);; i = (i + 1) & m_Mask) {
+				const auto& entry = m_Entries[i];
+				if(entry.generation != m_Generation) return false;
+				if(entry.glId == glId) {
+					slot = entry.slot;
+					return true;
+				}
+			}
+		}
+
+		// glId must not already be in the table.
+		void insert(uint32_t glId, texslot_t slot) {
+			OGL_DEBUG_ASSERT(m_Count < m_Entries.size(), "TextureSlotTable is full");
+			size_t i = hash(glId);
+			while(m_Entries[i].generation == m_Generation) i = (i + 1) & m_Mask;
+			m_Entries[i] = Entry{ glId, slot, m_Generation };
+			m_Count++;
+		}
+
+		void clear() {
+			m_Count = 0;
+			if(++m_Generation == 0) {
+				// The generation wrapped so old entries could look valid again
+				std::fill(m_Entries.begin(), m_Entries.end(), Entry{});
+				m_Generation = 1;
+			}
+		}
+
+		size_t size() const { return m_Count; }
+
+	private:
+		size_t hash(uint32_t glId) const {
+			// GL ids are usually small and sequential, Fibonacci hashing spreads them out
+			return (size_t)((glId * 2654435769u) >> 16) & m_Mask;
+		}
+
+		struct Entry {
+			uint32_t glId = 0;
+			texslot_t slot = 0;
+			uint32_t generation = 0;
+		};
+
+		std::vector<Entry> m_Entries;
+		size_t m_Mask;
+		size_t m_Count = 0;
+		uint32_t m_Generation = 1;
+	};
+}
@@ -1,172 +1,310 @@
-#pragma once
-
-#include <glad/glad.h>
-
-#include "core.h"
-#include "util/memview.h"
-
-namespace ogl {
-
-	// TODO: fill out
-	enum class BufferType : GLenum {
-		VertexBuffer = GL_ARRAY_BUFFER,
-		IndexBuffer = GL_ELEMENT_ARRAY_BUFFER
-	};
-
-	// Rare = Modified once, not used much by GPU
-	// Static = Modified once, used a lot by GPU
-	// Dynamic = Modified lots, used a lot by GPU
-	// 
-	// Draw = Modified by application, used by GPU
-	// Read = Modified by GPU, used by application
-	// NoTouchy = Modified by GPU, used by GPU
-	//
-	// Do not rely on these values being mapped to GL values
-	// just use the provided BufferUsageTypeToGL func.
-	enum class BufferUsage : GLenum {
-		RareDraw = GL_STREAM_DRAW, 
-		StaticDraw = GL_STATIC_DRAW,
-		DynamicDraw = GL_DYNAMIC_DRAW,
-
-		RareRead = GL_STREAM_READ,
-		StaticRead = GL_STREAM_READ,
-		DynamicRead= GL_DYNAMIC_READ,
-
-		RareNoTouchy = GL_STREAM_COPY,
-		StaticNoTouchy = GL_STATIC_COPY,
-		DynamicNoTouchy = GL_DYNAMIC_COPY,
-	};
-
-	enum class BufferMapHint : GLenum {
-		ReadOnly = GL_READ_ONLY,
-		WriteOnly = GL_WRITE_ONLY,
-		ReadWrite = GL_READ_WRITE
-	};
-
-	constexpr GLenum BufferTypeToGL(BufferType bt) { return (GLenum) bt; }
-	constexpr GLenum BufferUsageToGL(BufferUsage bu) { return (GLenum) bu; }
-	constexpr GLenum BufferMapHintToGL(BufferMapHint bmh) { return (GLenum) bmh; }
-
-	template<BufferType BT>
-	class Buffer {
-	public:
-		Buffer(size_t byte_size, BufferUsage bu);
-		Buffer(void* data, size_t byte_size, BufferUsage bu);
-		Buffer(const Buffer<BT>&) = delete;
-		Buffer(Buffer<BT>&& other);
-		virtual ~Buffer();
-
-		void bind();
-		void unbind();
-		void send_data(void* data, size_t byte_size, size_t byte_offset);
-		void orphan();
-		
-		template<typename T> MemView<T> map_buffer(BufferMapHint hint);
-		void unmap_buffer();
-
-		// returns the size of the buffer in bytes
-		size_t size() const { return m_Size; }
-
-	private:
-		uint32_t m_GlId;
-		const BufferUsage m_Usage;
-		size_t m_Size;
-	};
-
-	template<BufferType BT>
-	Buffer<BT>::Buffer(size_t size, BufferUsage bu) : m_Usage(bu), m_Size(size) {
-		glGenBuffers(1, &m_GlId);
-		bind();
-		glBufferData(BufferTypeToGL(BT), size, nullptr, BufferUsageToGL(bu));
-	}
-
-	template<BufferType BT>
-	Buffer<BT>::Buffer(void* data, size_t byte_size, BufferUsage bu) : m_Usage(bu), m_Size(byte_size) {
-		glGenBuffers(1, &m_GlId);
-		bind();
-		glBufferData(BufferTypeToGL(BT), m_Size, data, BufferUsageToGL(bu));
-	}
-
-	template<BufferType BT>
-	Buffer<BT>::Buffer(Buffer<BT>&& other) : m_GlId(other.m_GlId) {
-		other.m_GlId = 0;
-	}
-	
-	template<BufferType BT>
-	Buffer<BT>::~Buffer() {
-		glDeleteBuffers(1, &m_GlId);
-	}
-
-	template<BufferType BT>
-	void Buffer<BT>::bind() { glBindBuffer(BufferTypeToGL(BT), m_GlId); }
-
-	template<BufferType BT>
-	void Buffer<BT>::unbind() { glBindBuffer(BufferTypeToGL(BT), 0); }
-
-	// send_data will send the specified data to the buffer in the GPU. The offset specified
-	// is the offset in bytes into the buffer.
-	template<BufferType BT>
-	void Buffer<BT>::send_data(void* data, size_t byte_size, size_t byte_offset) {
-#if OGL_DEBUG
-		if(m_Usage != BufferUsage::DynamicDraw) { OGL_DEBUG_WARN("send_data is not recommended for usages other than DynamicDraw."); }
-#endif
-		OGL_DEBUG_ASSERT(byte_offset + byte_size <= m_Size);
-
-		bind();
-		glBufferSubData(BufferTypeToGL(BT), byte_offset, byte_size, data); 
-		unbind();
-	}
-
-	template<BufferType BT>
-	void Buffer<BT>::orphan() {
-		// TODO: Some usage checks should probably be done here
-		bind();
-		glBufferData(BufferTypeToGL(BT), m_Size, nullptr, BufferUsageToGL(m_Usage));
-		unbind();
-	}
-
-	// TODO: maybe use blobify for mapping data? If not at least magic-get?
-
-	template<BufferType BT>
-	template<typename T>
-	MemView<T> Buffer<BT>::map_buffer(BufferMapHint hint) {
-		bind();
-		void* ptr = glMapBuffer(BufferTypeToGL(BT), BufferMapHintToGL(hint));
-		unbind();
-
-		OGL_DEBUG_ASSERT(m_Size % sizeof(T) == 0);
-		OGL_DEBUG_ASSERT((size_t)ptr % alignof(T) == 0);
-
-		size_t count = m_Size / sizeof(T);
-		T* tptr = ::new (ptr) T[m_Size / sizeof(T)];
-		return MemView<T>(tptr, count);
-	}
-
-	template<BufferType BT>
-	void Buffer<BT>::unmap_buffer() {
-		bind();
-		glUnmapBuffer(BufferTypeToGL(BT));
-		unbind();
-	}
-
-	class VertexBuffer : public Buffer<BufferType::VertexBuffer> {
-	public:
-		VertexBuffer(size_t size, BufferUsage bu) : Buffer(size, bu) {}
-		VertexBuffer(void* data, size_t byte_size, BufferUsage bu) : Buffer(data, byte_size, bu) {}
-	};
-
-	class IndexBuffer : public Buffer<BufferType::IndexBuffer> { 
-	private:
-		using super = Buffer<BufferType::IndexBuffer>;
-	public:
-		using index_type = uint32_t;
-		IndexBuffer(size_t size, BufferUsage bu) : Buffer(size * sizeof(index_type), bu) {}
-		IndexBuffer(index_type* data, size_t count, BufferUsage bu) : Buffer(data, count * sizeof(index_type), bu) {}
-		
-		MemView<index_type> map_indices(BufferMapHint hint) { return super::map_buffer<index_type>(hint); }
-		void unmap_indices() { super::unmap_buffer(); }
-		void send_indices(index_type* data, size_t count, size_t offset) {
-			super::send_data(data, count * sizeof(index_type), offset * sizeof(index_type)); 
-		}
-	};
-}
+#pragma once
+
+#include <glad/glad.h>
+#include <vector>
+
+#include "core.h"
+#include "util/memview.h"
+#include "gl_state.h"
+
+namespace ogl {
+
+	// TODO: fill out
+	enum class BufferType : GLenum {
+		VertexBuffer = GL_ARRAY_BUFFER,
+		IndexBuffer = GL_ELEMENT_ARRAY_BUFFER,
+		UniformBuffer = GL_UNIFORM_BUFFER
+	};
+
+	// Rare = Modified once, not used much by GPU
+	// Static = Modified once, used a lot by GPU
+	// Dynamic = Modified lots, used a lot by GPU
+	// 
+	// Draw = Modified by application, used by GPU
+	// Read = Modified by GPU, used by application
+	// NoTouchy = Modified by GPU, used by GPU
+	//
+	// Do not rely on these values being mapped to GL values
+	// just use the provided BufferUsageTypeToGL func.
+	enum class BufferUsage : GLenum {
+		RareDraw = GL_STREAM_DRAW, 
+		StaticDraw = GL_STATIC_DRAW,
+		DynamicDraw = GL_DYNAMIC_DRAW,
+
+		RareRead = GL_STREAM_READ,
+		StaticRead = GL_STREAM_READ,
+		DynamicRead= GL_DYNAMIC_READ,
+
+		RareNoTouchy = GL_STREAM_COPY,
+		StaticNoTouchy = GL_STATIC_COPY,
+		DynamicNoTouchy = GL_DYNAMIC_COPY,
+
+		// Not a GL usage. Used by ring buffers (see BufferRingDesc), which
+		// are persistently mapped when the driver supports it.
+		RingStream = 0,
+	};
+
+	enum class BufferMapHint : GLenum {
+		ReadOnly = GL_READ_ONLY,
+		WriteOnly = GL_WRITE_ONLY,
+		ReadWrite = GL_READ_WRITE
+	};
+
+	constexpr GLenum BufferTypeToGL(BufferType bt) { return (GLenum) bt; }
+	constexpr GLenum BufferUsageToGL(BufferUsage bu) { 
+		return bu == BufferUsage::RingStream ? GL_STREAM_DRAW : (GLenum) bu; 
+	}
+	constexpr GLenum BufferMapHintToGL(BufferMapHint bmh) { return (GLenum) bmh; }
+
+	// A ring buffer is split into segmentCount segments of segmentSize bytes.
+	// Each batch is written into the next segment while the GPU may still be
+	// reading the previous ones, and a fence per segment stops the CPU from
+	// overwriting data that hasn't been drawn yet.
+	struct BufferRingDesc {
+		size_t segmentSize;
+		uint32_t segmentCount = 3;
+	};
+
+	template<BufferType BT>
+	class Buffer {
+	public:
+		Buffer(size_t byte_size, BufferUsage bu);
+		Buffer(void* data, size_t byte_size, BufferUsage bu);
+		// Creates a ring buffer. With GL_ARB_buffer_storage the whole buffer is 
+		// mapped once (persistent and coherent) and never unmapped. Otherwise each
+		// segment is mapped unsynchronised, relying on the fences instead.
+		Buffer(const BufferRingDesc& desc);
+		Buffer(const Buffer<BT>&) = delete;
+		Buffer(Buffer<BT>&& other);
+		virtual ~Buffer();
+
+		void bind();
+		void unbind();
+		void send_data(void* data, size_t byte_size, size_t byte_offset);
+		void orphan();
+		
+		template<typename T> MemView<T> map_buffer(BufferMapHint hint);
+		void unmap_buffer();
+
+		// Ring buffer functions. The order each batch should be:
+		// acquire_segment -> write data -> unmap_segment -> draw -> fence_segment
+
+		// Moves to the next segment, waiting for the GPU if it is still using it
+		template<typename T> MemView<T> acquire_segment();
+		// Makes the writes visible to GL. Does nothing when persistently mapped
+		void unmap_segment();
+		// Must be called after the draw calls that read the current segment
+		void fence_segment();
+
+		bool is_ring() const { return m_SegmentCount > 0; }
+		bool is_persistent() const { return m_PersistentPtr != nullptr; }
+		uint32_t segment_index() const { return m_Segment; }
+		size_t segment_size() const { return m_SegmentSize; }
+		// Number of times acquire_segment had to wait for the GPU
+		size_t segment_stalls() const { return m_SegmentStalls; }
+
+		// returns the size of the buffer in bytes
+		size_t size() const { return m_Size; }
+		uint32_t get_renderer_id() const { return m_GlId; }
+
+	private:
+		uint32_t m_GlId;
+		const BufferUsage m_Usage;
+		size_t m_Size;
+
+		// Ring buffer state, m_SegmentCount is 0 for regular buffers
+		size_t m_SegmentSize = 0;
+		uint32_t m_SegmentCount = 0;
+		uint32_t m_Segment = 0;
+		size_t m_SegmentStalls = 0;
+		void* m_PersistentPtr = nullptr;
+		std::vector<GLsync> m_Fences;
+	};
+
+	template<BufferType BT>
+	Buffer<BT>::Buffer(size_t size, BufferUsage bu) : m_Usage(bu), m_Size(size) {
+		glGenBuffers(1, &m_GlId);
+		glstate::BindBufferForWrite(m_GlId);
+		glBufferData(GL_COPY_WRITE_BUFFER, size, nullptr, BufferUsageToGL(bu));
+	}
+
+	template<BufferType BT>
+	Buffer<BT>::Buffer(void* data, size_t byte_size, BufferUsage bu) : m_Usage(bu), m_Size(byte_size) {
+		glGenBuffers(1, &m_GlId);
+		glstate::BindBufferForWrite(m_GlId);
+		glBufferData(GL_COPY_WRITE_BUFFER, m_Size, data, BufferUsageToGL(bu));
+	}
+
+	template<BufferType BT>
+	Buffer<BT>::Buffer(const BufferRingDesc& desc) : m_Usage(BufferUsage::RingStream), m_Size(desc.segmentSize * desc.segmentCount),
+		m_SegmentSize(desc.segmentSize), m_SegmentCount(desc.segmentCount), m_Fences(desc.segmentCount, nullptr) {
+		OGL_ASSERT(desc.segmentCount > 0, "A ring buffer needs at least one segment");
+		// Start on the last segment so the first acquire lands on segment 0
+		m_Segment = m_SegmentCount - 1;
+
+		glGenBuffers(1, &m_GlId);
+		glstate::BindBufferForWrite(m_GlId);
+		if(GLAD_GL_ARB_buffer_storage) {
+			const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+			glBufferStorage(GL_COPY_WRITE_BUFFER, m_Size, nullptr, flags);
+			m_PersistentPtr = glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, m_Size, flags);
+		}
+		else {
+			OGL_DEBUG_WARN("GL_ARB_buffer_storage is not supported, ring buffer will map each segment.");
+			glBufferData(GL_COPY_WRITE_BUFFER, m_Size, nullptr, BufferUsageToGL(m_Usage));
+		}
+	}
+
+	template<BufferType BT>
+	Buffer<BT>::Buffer(Buffer<BT>&& other) : m_GlId(other.m_GlId), m_Usage(other.m_Usage), m_Size(other.m_Size),
+		m_SegmentSize(other.m_SegmentSize), m_SegmentCount(other.m_SegmentCount), m_Segment(other.m_Segment), 
+		m_SegmentStalls(other.m_SegmentStalls), m_PersistentPtr(other.m_PersistentPtr), m_Fences(std::move(other.m_Fences)) {
+		other.m_GlId = 0;
+		other.m_PersistentPtr = nullptr;
+	}
+	
+	template<BufferType BT>
+	Buffer<BT>::~Buffer() {
+		for(GLsync fence : m_Fences) {
+			if(fence) glDeleteSync(fence);
+		}
+		// Deleting a buffer also unmaps it
+		glDeleteBuffers(1, &m_GlId);
+		glstate::BufferDeleted(m_GlId);
+	}
+
+	template<BufferType BT>
+	void Buffer<BT>::bind() { glstate::BindBuffer(BufferTypeToGL(BT), m_GlId); }
+
+	template<BufferType BT>
+	void Buffer<BT>::unbind() { glstate::BindBuffer(BufferTypeToGL(BT), 0); }
+
+	// send_data will send the specified data to the buffer in the GPU. The offset specified
+	// is the offset in bytes into the buffer.
+	template<BufferType BT>
+	void Buffer<BT>::send_data(void* data, size_t byte_size, size_t byte_offset) {
+#if OGL_DEBUG
+		if(m_Usage != BufferUsage::DynamicDraw) { OGL_DEBUG_WARN("send_data is not recommended for usages other than DynamicDraw."); }
+#endif
+		OGL_DEBUG_ASSERT(byte_offset + byte_size <= m_Size);
+
+		glstate::BindBufferForWrite(m_GlId);
+		glBufferSubData(GL_COPY_WRITE_BUFFER, byte_offset, byte_size, data); 
+	}
+
+	template<BufferType BT>
+	void Buffer<BT>::orphan() {
+		// TODO: Some usage checks should probably be done here
+		glstate::BindBufferForWrite(m_GlId);
+		glBufferData(GL_COPY_WRITE_BUFFER, m_Size, nullptr, BufferUsageToGL(m_Usage));
+	}
+
+	// TODO: maybe use blobify for mapping data? If not at least magic-get?
+
+	template<BufferType BT>
+	template<typename T>
+	MemView<T> Buffer<BT>::map_buffer(BufferMapHint hint) {
+		glstate::BindBufferForWrite(m_GlId);
+		void* ptr = glMapBuffer(GL_COPY_WRITE_BUFFER, BufferMapHintToGL(hint));
+
+		OGL_DEBUG_ASSERT(m_Size % sizeof(T) == 0);
+		OGL_DEBUG_ASSERT((size_t)ptr % alignof(T) == 0);
+
+		size_t count = m_Size / sizeof(T);
+		T* tptr = ::new (ptr) T[m_Size / sizeof(T)];
+		return MemView<T>(tptr, count);
+	}
+
+	template<BufferType BT>
+	void Buffer<BT>::unmap_buffer() {
+		glstate::BindBufferForWrite(m_GlId);
+		glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+	}
+
+	template<BufferType BT>
+	template<typename T>
+	MemView<T> Buffer<BT>::acquire_segment() {
+		OGL_DEBUG_ASSERT(is_ring(), "acquire_segment can only be used on ring buffers");
+		OGL_DEBUG_ASSERT(m_SegmentSize % sizeof(T) == 0);
+
+		m_Segment = (m_Segment + 1) % m_SegmentCount;
+
+		// Wait for the GPU to finish with this segment
+		if(GLsync fence = m_Fences[m_Segment]) {
+			GLenum result = glClientWaitSync(fence, 0, 0);
+			if(result == GL_TIMEOUT_EXPIRED) {
+				m_SegmentStalls++;
+				do {
+					result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1'000'000);
+				} while(result == GL_TIMEOUT_EXPIRED);
+			}
+			glDeleteSync(fence);
+			m_Fences[m_Segment] = nullptr;
+		}
+
+		const size_t offset = m_Segment * m_SegmentSize;
+		void* ptr;
+		if(m_PersistentPtr) {
+			ptr = static_cast<uint8_t*>(m_PersistentPtr) + offset;
+		}
+		else {
+			// The fence already guarantees the GPU is done with this range
+			glstate::BindBufferForWrite(m_GlId);
+			ptr = glMapBufferRange(GL_COPY_WRITE_BUFFER, offset, m_SegmentSize, 
+				GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+		}
+
+		OGL_DEBUG_ASSERT((size_t)ptr % alignof(T) == 0);
+		return MemView<T>(static_cast<T*>(ptr), m_SegmentSize / sizeof(T));
+	}
+
+	template<BufferType BT>
+	void Buffer<BT>::unmap_segment() {
+		OGL_DEBUG_ASSERT(is_ring(), "unmap_segment can only be used on ring buffers");
+		if(!m_PersistentPtr) unmap_buffer();
+	}
+
+	template<BufferType BT>
+	void Buffer<BT>::fence_segment() {
+		OGL_DEBUG_ASSERT(is_ring(), "fence_segment can only be used on ring buffers");
+		OGL_DEBUG_ASSERT(m_Fences[m_Segment] == nullptr);
+		m_Fences[m_Segment] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	}
+
+	class VertexBuffer : public Buffer<BufferType::VertexBuffer> {
+	public:
+		VertexBuffer(size_t size, BufferUsage bu) : Buffer(size, bu) {}
+		VertexBuffer(void* data, size_t byte_size, BufferUsage bu) : Buffer(data, byte_size, bu) {}
+		VertexBuffer(const BufferRingDesc& desc) : Buffer(desc) {}
+	};
+
+	// Backs a std140 uniform block. The data sent must match the block's std140
+	// layout: vec3, vec4 and mat4 members are aligned to 16 bytes and arrays
+	// have every element padded to 16 bytes.
+	class UniformBuffer : public Buffer<BufferType::UniformBuffer> {
+	public:
+		UniformBuffer(size_t size) : Buffer(size, BufferUsage::DynamicDraw) {}
+
+		template<typename T>
+		void set_data(const T& value, size_t byte_offset = 0) { send_data((void*)&value, sizeof(T), byte_offset); }
+
+		// Binds the buffer to a uniform block binding point, see
+		// Shader::set_uniform_block_binding
+		void bind_base(uint32_t binding) { glstate::BindBufferBase(GL_UNIFORM_BUFFER, binding, get_renderer_id()); }
+	};
+
+	class IndexBuffer : public Buffer<BufferType::IndexBuffer> { 
+	private:
+		using super = Buffer<BufferType::IndexBuffer>;
+	public:
+		using index_type = uint32_t;
+		IndexBuffer(size_t size, BufferUsage bu) : Buffer(size * sizeof(index_type), bu) {}
+		IndexBuffer(index_type* data, size_t count, BufferUsage bu) : Buffer(data, count * sizeof(index_type), bu) {}
+		
+		MemView<index_type> map_indices(BufferMapHint hint) { return super::map_buffer<index_type>(hint); }
+		void unmap_indices() { super::unmap_buffer(); }
+		void send_indices(index_type* data, size_t count, size_t offset) {
+			super::send_data(data, count * sizeof(index_type), offset * sizeof(index_type)); 
+		}
+	};
+}
@@ -0,0 +1,160 @@
+#include "gl_state.h"
+
+#include <vector>
+#include <utility>
+#include <unordered_map>
+
+namespace ogl::glstate {
+
+	namespace {
+
+		// State that hasn't been set through glstate since the last Invalidate
+		constexpr uint32_t s_Unknown = -1U;
+
+		struct State {
+			uint32_t program = s_Unknown;
+			uint32_t vertexArray = s_Unknown;
+			// (target, buffer), GL_ELEMENT_ARRAY_BUFFER isn't in here as it
+			// belongs to the bound vertex array
+			std::vector<std::pair<GLenum, uint32_t>> buffers;
+			// ((target << 32) | index, buffer)
+			std::vector<std::pair<uint64_t, uint32_t>> indexedBuffers;
+			// Element buffer of each vertex array
+			std::unordered_map<uint32_t, uint32_t> elementBuffers;
+			uint32_t activeTexture = s_Unknown;
+			std::vector<uint32_t> textures;
+
+			GLStateStats stats;
+		};
+
+		State s_State;
+
+		template<typename K>
+		uint32_t& Slot(std::vector<std::pair<K, uint32_t>>& slots, K key) {
+			for(auto& [k, value] : slots) {
+				if(k == key) return value;
+			}
+			return slots.emplace_back(key, s_Unknown).second;
+		}
+
+		uint32_t& ElementBuffer() {
+			// Without a known vertex array there is nowhere to keep it
+			static uint32_t s_Scratch;
+			if(s_State.vertexArray == s_Unknown) return s_Scratch = s_Unknown;
+			return s_State.elementBuffers.try_emplace(s_State.vertexArray, s_Unknown).first->second;
+		}
+
+		uint32_t& BufferSlot(GLenum target) {
+			return target == GL_ELEMENT_ARRAY_BUFFER ? ElementBuffer() : Slot(s_State.buffers, target);
+		}
+
+		uint32_t& TextureSlot(uint32_t unit) {
+			if(unit >= s_State.textures.size()) s_State.textures.resize(unit + 1, s_Unknown);
+			return s_State.textures[unit];
+		}
+
+		// Sets bound to value, returns false if it already was
+		bool Change(uint32_t& bound, uint32_t value, size_t& made, size_t& elided) {
+			if(bound == value) {
+				elided++;
+				return false;
+			}
+			bound = value;
+			made++;
+			return true;
+		}
+	}
+
+	void UseProgram(uint32_t program) {
+		auto& stats = s_State.stats;
+		if(Change(s_State.program, program, stats.programBinds, stats.programBindsElided))
+			glUseProgram(program);
+	}
+
+	void BindVertexArray(uint32_t vao) {
+		auto& stats = s_State.stats;
+		if(Change(s_State.vertexArray, vao, stats.vertexArrayBinds, stats.vertexArrayBindsElided))
+			glBindVertexArray(vao);
+	}
+
+	void BindBuffer(GLenum target, uint32_t buffer) {
+		auto& stats = s_State.stats;
+		if(Change(BufferSlot(target), buffer, stats.bufferBinds, stats.bufferBindsElided))
+			glBindBuffer(target, buffer);
+	}
+
+	void BindBufferBase(GLenum target, uint32_t index, uint32_t buffer) {
+		auto& stats = s_State.stats;
+		if(Change(Slot(s_State.indexedBuffers, ((uint64_t)target << 32) | index), buffer, stats.bufferBinds, stats.bufferBindsElided)) {
+			glBindBufferBase(target, index, buffer);
+			// Binding an indexed target binds the generic one as well
+			BufferSlot(target) = buffer;
+		}
+	}
+
+	void BindBufferForWrite(uint32_t buffer) {
+		BindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+	}
+
+	void ActiveTexture(uint32_t unit) {
+		auto& stats = s_State.stats;
+		if(Change(s_State.activeTexture, unit, stats.activeTextures, stats.activeTexturesElided))
+			glActiveTexture(GL_TEXTURE0 + unit);
+	}
+
+	void BindTexture(uint32_t texture) {
+		auto& stats = s_State.stats;
+		if(s_State.activeTexture == s_Unknown) ActiveTexture(0);
+		if(Change(TextureSlot(s_State.activeTexture), texture, stats.textureBinds, stats.textureBindsElided))
+			glBindTexture(GL_TEXTURE_2D, texture);
+	}
+
+	void BindTextureUnit(uint32_t unit, uint32_t texture) {
+		if(TextureSlot(unit) == texture) {
+			s_State.stats.textureBindsElided++;
+			return;
+		}
+		ActiveTexture(unit);
+		BindTexture(texture);
+	}
+
+	void ProgramDeleted(uint32_t program) {
+		// A deleted program stays in use until something else is bound, and
+		// its id can be handed out again, so the binding is no longer known
+		if(s_State.program == program) s_State.program = s_Unknown;
+	}
+
+	void VertexArrayDeleted(uint32_t vao) {
+		if(s_State.vertexArray == vao) s_State.vertexArray = 0;
+		s_State.elementBuffers.erase(vao);
+	}
+
+	void BufferDeleted(uint32_t buffer) {
+		// Bindings of the current context go back to 0, attachments to other
+		// vertex arrays keep pointing at the dead name
+		for(auto& [target, bound] : s_State.buffers) {
+			if(bound == buffer) bound = 0;
+		}
+		for(auto& [target, bound] : s_State.indexedBuffers) {
+			if(bound == buffer) bound = 0;
+		}
+		for(auto& [vao, bound] : s_State.elementBuffers) {
+			if(bound == buffer) bound = vao == s_State.vertexArray ? 0 : s_Unknown;
+		}
+	}
+
+	void TextureDeleted(uint32_t texture) {
+		for(auto& bound : s_State.textures) {
+			if(bound == texture) bound = 0;
+		}
+	}
+
+	void Invalidate() {
+		const GLStateStats stats = s_State.stats;
+		s_State = State{};
+		s_State.stats = stats;
+	}
+
+	const GLStateStats& Stats() { return s_State.stats; }
+	void ResetStats() { s_State.stats = GLStateStats{}; }
+}
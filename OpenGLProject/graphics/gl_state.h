@@ -0,0 +1,64 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include "core.h"
+
+namespace ogl {
+
+	struct GLStateStats {
+		// Calls made, and calls skipped because they would have set the
+		// state to what it already was
+		size_t programBinds = 0;
+		size_t programBindsElided = 0;
+		size_t vertexArrayBinds = 0;
+		size_t vertexArrayBindsElided = 0;
+		size_t bufferBinds = 0;
+		size_t bufferBindsElided = 0;
+		size_t activeTextures = 0;
+		size_t activeTexturesElided = 0;
+		size_t textureBinds = 0;
+		size_t textureBindsElided = 0;
+	};
+
+	// glstate mirrors the GL binding state the engine uses: the program, the
+	// vertex array, the buffer bound to each target and indexed binding, the
+	// active texture unit and the 2D texture of every unit. Binds that would
+	// change nothing are skipped. It only works if every bind and delete of
+	// these objects goes through here, so never call glBind*, glUseProgram or
+	// glActiveTexture directly.
+	//
+	// Nothing is unbound after use any more. Buffer uploads and maps use
+	// GL_COPY_WRITE_BUFFER (see BindBufferForWrite) so they can never change
+	// the element buffer of whatever vertex array is bound.
+	namespace glstate {
+
+		void UseProgram(uint32_t program);
+		void BindVertexArray(uint32_t vao);
+		void BindBuffer(GLenum target, uint32_t buffer);
+		void BindBufferBase(GLenum target, uint32_t index, uint32_t buffer);
+		// Binds buffer to the target used for uploading and mapping
+		void BindBufferForWrite(uint32_t buffer);
+		void ActiveTexture(uint32_t unit);
+		// Binds texture to the active unit
+		void BindTexture(uint32_t texture);
+		// Makes unit active and binds texture to it, the active unit is only
+		// changed if texture isn't already bound there
+		void BindTextureUnit(uint32_t unit, uint32_t texture);
+
+		// Deleting an object unbinds it everywhere it was bound, these keep
+		// the mirrored state in step. They don't delete anything.
+		void ProgramDeleted(uint32_t program);
+		void VertexArrayDeleted(uint32_t vao);
+		void BufferDeleted(uint32_t buffer);
+		void TextureDeleted(uint32_t texture);
+
+		// Forgets everything, the next bind of anything is always made. Call
+		// when a context is made current or after GL was used directly.
+		void Invalidate();
+
+		// Stats accumulate until ResetStats, call it once per frame
+		const GLStateStats& Stats();
+		void ResetStats();
+	}
+}
@@ -0,0 +1,505 @@
+#include "headless_gl.h"
+
+#include <glad/glad.h>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "log.h"
+#include "graphics/gl_state.h"
+#include "graphics/shader_cache.h"
+
+namespace ogl::headless {
+
+	namespace {
+
+		struct State {
+			HeadlessGLDesc desc;
+			HeadlessGLStats stats;
+			std::vector<const char*> calls;
+
+			GLuint nextId = 1;
+			uintptr_t nextSync = 1;
+
+			std::unordered_map<GLuint, std::vector<uint8_t>> buffers;
+			std::unordered_map<GLenum, GLuint> boundBuffers;
+			std::unordered_map<uint64_t, GLuint> indexedBuffers;
+			std::unordered_set<GLuint> textures;
+			std::unordered_set<GLuint> vertexArrays;
+			std::unordered_set<GLuint> shaders;
+			std::unordered_set<GLuint> programs;
+			std::unordered_map<GLuint, std::unordered_map<std::string, GLint>> uniformLocations;
+			std::unordered_map<GLuint, std::unordered_map<std::string, GLuint>> uniformBlocks;
+
+			GLuint activeTexture = 0;
+			std::vector<GLuint> boundTextures;
+			GLuint program = 0;
+			GLuint vertexArray = 0;
+			std::unordered_set<GLenum> enabled;
+			GLenum blendSrc = GL_ONE, blendDst = GL_ZERO;
+			GLint viewport[4] = {};
+		};
+
+		std::unique_ptr<State> s_State;
+		// Puts back the entry points that were there before Init
+		std::vector<std::function<void()>> s_Restore;
+
+		template<typename PFN>
+		void Install(PFN& slot, std::common_type_t<PFN> fn) {
+			s_Restore.push_back([&slot, old = slot] { slot = old; });
+			slot = fn;
+		}
+
+		void StateChange(bool changed) {
+			s_State->stats.stateChanges++;
+			if(!changed) s_State->stats.redundantStateChanges++;
+		}
+
+		std::vector<uint8_t>* BoundBuffer(GLenum target) {
+			const auto it = s_State->buffers.find(s_State->boundBuffers[target]);
+			return it == s_State->buffers.end() ? nullptr : &it->second;
+		}
+
+		size_t BytesPerPixel(GLenum format, GLenum type) {
+			size_t components;
+			switch(format) {
+				case GL_RED: case GL_RED_INTEGER: case GL_DEPTH_COMPONENT: components = 1; break;
+				case GL_RG: case GL_RG_INTEGER: components = 2; break;
+				case GL_RGB: case GL_BGR: case GL_RGB_INTEGER: components = 3; break;
+				default: components = 4; break;
+			}
+
+			switch(type) {
+				case GL_UNSIGNED_SHORT: case GL_SHORT: case GL_HALF_FLOAT: return components * 2;
+				case GL_UNSIGNED_INT: case GL_INT: case GL_FLOAT: return components * 4;
+				default: return components;
+			}
+		}
+
+		// Entry points that only need to exist. Only the signature is taken
+		// from the glad function pointer type.
+		template<typename PFN> struct Ignore;
+		template<typename R, typename... Args>
+		struct Ignore<R (APIENTRY*)(Args...)> {
+			static R APIENTRY Call(Args...) { return R(); }
+		};
+
+		template<typename PFN> struct Uniform;
+		template<typename... Args>
+		struct Uniform<void (APIENTRY*)(Args...)> {
+			static void APIENTRY Call(Args...) { s_State->stats.uniformCalls++; }
+		};
+
+		/* Objects */
+
+		void GenObjects(GLsizei n, GLuint* ids, std::unordered_set<GLuint>& set) {
+			for(GLsizei i = 0; i < n; i++) {
+				ids[i] = s_State->nextId++;
+				set.insert(ids[i]);
+			}
+		}
+
+		void APIENTRY GenBuffers(GLsizei n, GLuint* ids) {
+			for(GLsizei i = 0; i < n; i++) {
+				ids[i] = s_State->nextId++;
+				s_State->buffers[ids[i]];
+			}
+		}
+
+		void APIENTRY DeleteBuffers(GLsizei n, const GLuint* ids) {
+			for(GLsizei i = 0; i < n; i++) {
+				s_State->buffers.erase(ids[i]);
+				for(auto& [target, bound] : s_State->boundBuffers) {
+					if(bound == ids[i]) bound = 0;
+				}
+			}
+		}
+
+		void APIENTRY GenTextures(GLsizei n, GLuint* ids) { GenObjects(n, ids, s_State->textures); }
+		void APIENTRY DeleteTextures(GLsizei n, const GLuint* ids) { for(GLsizei i = 0; i < n; i++) s_State->textures.erase(ids[i]); }
+		void APIENTRY GenVertexArrays(GLsizei n, GLuint* ids) { GenObjects(n, ids, s_State->vertexArrays); }
+		void APIENTRY DeleteVertexArrays(GLsizei n, const GLuint* ids) { for(GLsizei i = 0; i < n; i++) s_State->vertexArrays.erase(ids[i]); }
+
+		GLuint APIENTRY CreateShader(GLenum) {
+			const GLuint id = s_State->nextId++;
+			s_State->shaders.insert(id);
+			return id;
+		}
+
+		void APIENTRY DeleteShader(GLuint id) { s_State->shaders.erase(id); }
+
+		GLuint APIENTRY CreateProgram() {
+			const GLuint id = s_State->nextId++;
+			s_State->programs.insert(id);
+			return id;
+		}
+
+		void APIENTRY DeleteProgram(GLuint id) {
+			s_State->programs.erase(id);
+			s_State->uniformLocations.erase(id);
+			s_State->uniformBlocks.erase(id);
+		}
+
+		/* Buffers */
+
+		void APIENTRY BufferData(GLenum target, GLsizeiptr size, const void* data, GLenum) {
+			auto* buffer = BoundBuffer(target);
+			if(!buffer) return;
+			buffer->assign(size, 0);
+			if(data) {
+				memcpy(buffer->data(), data, size);
+				s_State->stats.bufferUploadBytes += size;
+			}
+		}
+
+		void APIENTRY BufferStorage(GLenum target, GLsizeiptr size, const void* data, GLbitfield) {
+			BufferData(target, size, data, 0);
+		}
+
+		void APIENTRY BufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data) {
+			auto* buffer = BoundBuffer(target);
+			if(!buffer || offset + size > (GLintptr)buffer->size()) return;
+			memcpy(buffer->data() + offset, data, size);
+			s_State->stats.bufferUploadBytes += size;
+		}
+
+		void* APIENTRY MapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access) {
+			auto* buffer = BoundBuffer(target);
+			if(!buffer || offset + length > (GLintptr)buffer->size()) return nullptr;
+			if(access & GL_MAP_WRITE_BIT) s_State->stats.mappedWriteBytes += length;
+			return buffer->data() + offset;
+		}
+
+		void* APIENTRY MapBuffer(GLenum target, GLenum access) {
+			auto* buffer = BoundBuffer(target);
+			if(!buffer) return nullptr;
+			return MapBufferRange(target, 0, buffer->size(), access == GL_READ_ONLY ? GL_MAP_READ_BIT : GL_MAP_WRITE_BIT);
+		}
+
+		GLboolean APIENTRY UnmapBuffer(GLenum) { return GL_TRUE; }
+
+		/* State */
+
+		void APIENTRY BindBuffer(GLenum target, GLuint id) {
+			auto& bound = s_State->boundBuffers[target];
+			StateChange(bound != id);
+			bound = id;
+		}
+
+		// Also binds the generic binding point, like GL does
+		void APIENTRY BindBufferBase(GLenum target, GLuint index, GLuint id) {
+			auto& bound = s_State->indexedBuffers[((uint64_t)target << 32) | index];
+			StateChange(bound != id);
+			bound = id;
+			s_State->boundBuffers[target] = id;
+		}
+
+		void APIENTRY BindVertexArray(GLuint id) {
+			StateChange(s_State->vertexArray != id);
+			s_State->vertexArray = id;
+		}
+
+		void APIENTRY UseProgram(GLuint id) {
+			StateChange(s_State->program != id);
+			s_State->program = id;
+		}
+
+		void APIENTRY ActiveTexture(GLenum unit) {
+			const GLuint index = unit - GL_TEXTURE0;
+			StateChange(s_State->activeTexture != index);
+			s_State->activeTexture = index;
+			if(index >= s_State->boundTextures.size()) s_State->boundTextures.resize(index + 1, 0);
+		}
+
+		void APIENTRY BindTexture(GLenum, GLuint id) {
+			auto& bound = s_State->boundTextures[s_State->activeTexture];
+			StateChange(bound != id);
+			bound = id;
+		}
+
+		void APIENTRY Enable(GLenum cap) { StateChange(s_State->enabled.insert(cap).second); }
+		void APIENTRY Disable(GLenum cap) { StateChange(s_State->enabled.erase(cap) != 0); }
+
+		void APIENTRY BlendFunc(GLenum src, GLenum dst) {
+			StateChange(s_State->blendSrc != src || s_State->blendDst != dst);
+			s_State->blendSrc = src;
+			s_State->blendDst = dst;
+		}
+
+		void APIENTRY Viewport(GLint x, GLint y, GLsizei w, GLsizei h) {
+			auto& v = s_State->viewport;
+			StateChange(v[0] != x || v[1] != y || v[2] != w || v[3] != h);
+			v[0] = x; v[1] = y; v[2] = w; v[3] = h;
+		}
+
+		/* Textures */
+
+		void APIENTRY TexImage2D(GLenum, GLint, GLint, GLsizei width, GLsizei height, GLint, GLenum format, GLenum type, const void* data) {
+			if(data) s_State->stats.textureUploadBytes += (size_t)width * height * BytesPerPixel(format, type);
+		}
+
+		void APIENTRY CompressedTexImage2D(GLenum, GLint, GLenum, GLsizei, GLsizei, GLint, GLsizei imageSize, const void* data) {
+			if(data) s_State->stats.textureUploadBytes += (size_t)imageSize;
+		}
+
+		/* Shaders */
+
+		void APIENTRY GetShaderiv(GLuint, GLenum name, GLint* value) {
+			*value = name == GL_COMPILE_STATUS ? GL_TRUE : 0;
+		}
+
+		void APIENTRY GetProgramiv(GLuint, GLenum name, GLint* value) {
+			*value = name == GL_LINK_STATUS ? GL_TRUE : 0;
+		}
+
+		void APIENTRY GetInfoLog(GLuint, GLsizei size, GLsizei* length, GLchar* log) {
+			if(length) *length = 0;
+			if(size > 0) log[0] = '\0';
+		}
+
+		GLint APIENTRY GetUniformLocation(GLuint program, const GLchar* name) {
+			auto& locations = s_State->uniformLocations[program];
+			return locations.emplace(name, (GLint)locations.size()).first->second;
+		}
+
+		GLuint APIENTRY GetUniformBlockIndex(GLuint program, const GLchar* name) {
+			auto& blocks = s_State->uniformBlocks[program];
+			return blocks.emplace(name, (GLuint)blocks.size()).first->second;
+		}
+
+		/* Draws */
+
+		void APIENTRY DrawElements(GLenum, GLsizei count, GLenum, const void*) {
+			s_State->stats.drawCalls++;
+			s_State->stats.vertices += count;
+		}
+
+		void APIENTRY DrawElementsBaseVertex(GLenum mode, GLsizei count, GLenum type, const void* indices, GLint) {
+			DrawElements(mode, count, type, indices);
+		}
+
+		void APIENTRY DrawArraysInstanced(GLenum, GLint, GLsizei count, GLsizei instances) {
+			s_State->stats.drawCalls++;
+			s_State->stats.vertices += (size_t)count * instances;
+			s_State->stats.instances += instances;
+		}
+
+		void APIENTRY DrawArraysInstancedBaseInstance(GLenum mode, GLint first, GLsizei count, GLsizei instances, GLuint) {
+			DrawArraysInstanced(mode, first, count, instances);
+		}
+
+		/* Queries and sync */
+
+		void APIENTRY GetIntegerv(GLenum name, GLint* value) {
+			switch(name) {
+				case GL_MAJOR_VERSION: *value = OGL_TARGET_GL_MAJOR; break;
+				case GL_MINOR_VERSION: *value = OGL_TARGET_GL_MINOR; break;
+				case GL_MAX_TEXTURE_IMAGE_UNITS: *value = s_State->desc.textureSlots; break;
+				case GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS: *value = s_State->desc.textureSlots * 2; break;
+				default: *value = 0; break;
+			}
+		}
+
+		GLenum APIENTRY GetError() { return GL_NO_ERROR; }
+
+		// Nothing ever runs on a GPU, so every fence is signalled straight away
+		GLsync APIENTRY FenceSync(GLenum, GLbitfield) { return (GLsync)s_State->nextSync++; }
+		GLenum APIENTRY ClientWaitSync(GLsync, GLbitfield, GLuint64) { return GL_ALREADY_SIGNALED; }
+
+#ifdef GLAD_DEBUG
+		void RecordCall(const char* name, void*, int, ...) {
+			if(!s_State) return;
+			s_State->stats.calls++;
+			if(s_State->desc.recordCalls) s_State->calls.push_back(name);
+		}
+#endif
+	}
+
+	GraphicsContext Init(const HeadlessGLDesc& desc) {
+		OGL_ASSERT(!s_State, "The headless GL backend is already active");
+		s_State = std::make_unique<State>();
+		s_State->desc = desc;
+		s_State->boundTextures.resize(1, 0);
+
+		Install(glad_glGenBuffers, &GenBuffers);
+		Install(glad_glDeleteBuffers, &DeleteBuffers);
+		Install(glad_glGenTextures, &GenTextures);
+		Install(glad_glDeleteTextures, &DeleteTextures);
+		Install(glad_glGenVertexArrays, &GenVertexArrays);
+		Install(glad_glDeleteVertexArrays, &DeleteVertexArrays);
+		Install(glad_glCreateShader, &CreateShader);
+		Install(glad_glDeleteShader, &DeleteShader);
+		Install(glad_glCreateProgram, &CreateProgram);
+		Install(glad_glDeleteProgram, &DeleteProgram);
+
+		Install(glad_glBufferData, &BufferData);
+		Install(glad_glBufferStorage, &BufferStorage);
+		Install(glad_glBufferSubData, &BufferSubData);
+		Install(glad_glMapBuffer, &MapBuffer);
+		Install(glad_glMapBufferRange, &MapBufferRange);
+		Install(glad_glUnmapBuffer, &UnmapBuffer);
+
+		Install(glad_glBindBuffer, &BindBuffer);
+		Install(glad_glBindBufferBase, &BindBufferBase);
+		Install(glad_glBindVertexArray, &BindVertexArray);
+		Install(glad_glUseProgram, &UseProgram);
+		Install(glad_glActiveTexture, &ActiveTexture);
+		Install(glad_glBindTexture, &BindTexture);
+		Install(glad_glEnable, &Enable);
+		Install(glad_glDisable, &Disable);
+		Install(glad_glBlendFunc, &BlendFunc);
+		Install(glad_glViewport, &Viewport);
+
+		Install(glad_glTexImage2D, &TexImage2D);
+		Install(glad_glCompressedTexImage2D, &CompressedTexImage2D);
+		Install(glad_glGetShaderiv, &GetShaderiv);
+		Install(glad_glGetProgramiv, &GetProgramiv);
+		Install(glad_glGetShaderInfoLog, &GetInfoLog);
+		Install(glad_glGetProgramInfoLog, &GetInfoLog);
+		Install(glad_glGetUniformLocation, &GetUniformLocation);
+		Install(glad_glGetUniformBlockIndex, &GetUniformBlockIndex);
+		Install(glad_glUniformBlockBinding, &Ignore<PFNGLUNIFORMBLOCKBINDINGPROC>::Call);
+		Install(glad_glGetActiveUniform, &Ignore<PFNGLGETACTIVEUNIFORMPROC>::Call);
+
+		Install(glad_glDrawElements, &DrawElements);
+		Install(glad_glDrawElementsBaseVertex, &DrawElementsBaseVertex);
+		Install(glad_glDrawArraysInstanced, &DrawArraysInstanced);
+		Install(glad_glDrawArraysInstancedBaseInstance, &DrawArraysInstancedBaseInstance);
+
+		Install(glad_glGetIntegerv, &GetIntegerv);
+		Install(glad_glGetError, &GetError);
+		Install(glad_glFenceSync, &FenceSync);
+		Install(glad_glClientWaitSync, &ClientWaitSync);
+		Install(glad_glDeleteSync, &Ignore<PFNGLDELETESYNCPROC>::Call);
+
+		Install(glad_glShaderSource, &Ignore<PFNGLSHADERSOURCEPROC>::Call);
+		Install(glad_glCompileShader, &Ignore<PFNGLCOMPILESHADERPROC>::Call);
+		Install(glad_glAttachShader, &Ignore<PFNGLATTACHSHADERPROC>::Call);
+		Install(glad_glDetachShader, &Ignore<PFNGLDETACHSHADERPROC>::Call);
+		Install(glad_glBindAttribLocation, &Ignore<PFNGLBINDATTRIBLOCATIONPROC>::Call);
+		Install(glad_glLinkProgram, &Ignore<PFNGLLINKPROGRAMPROC>::Call);
+		Install(glad_glTexParameteri, &Ignore<PFNGLTEXPARAMETERIPROC>::Call);
+		Install(glad_glGenerateMipmap, &Ignore<PFNGLGENERATEMIPMAPPROC>::Call);
+		Install(glad_glPixelStorei, &Ignore<PFNGLPIXELSTOREIPROC>::Call);
+		Install(glad_glEnableVertexAttribArray, &Ignore<PFNGLENABLEVERTEXATTRIBARRAYPROC>::Call);
+		Install(glad_glVertexAttribPointer, &Ignore<PFNGLVERTEXATTRIBPOINTERPROC>::Call);
+		Install(glad_glVertexAttribIPointer, &Ignore<PFNGLVERTEXATTRIBIPOINTERPROC>::Call);
+		Install(glad_glVertexAttribDivisor, &Ignore<PFNGLVERTEXATTRIBDIVISORPROC>::Call);
+		Install(glad_glClear, &Ignore<PFNGLCLEARPROC>::Call);
+		Install(glad_glClearColor, &Ignore<PFNGLCLEARCOLORPROC>::Call);
+		Install(glad_glDebugMessageCallback, &Ignore<PFNGLDEBUGMESSAGECALLBACKPROC>::Call);
+
+		Install(glad_glUniform1i, &Uniform<PFNGLUNIFORM1IPROC>::Call);
+		Install(glad_glUniform2i, &Uniform<PFNGLUNIFORM2IPROC>::Call);
+		Install(glad_glUniform3i, &Uniform<PFNGLUNIFORM3IPROC>::Call);
+		Install(glad_glUniform4i, &Uniform<PFNGLUNIFORM4IPROC>::Call);
+		Install(glad_glUniform1ui, &Uniform<PFNGLUNIFORM1UIPROC>::Call);
+		Install(glad_glUniform2ui, &Uniform<PFNGLUNIFORM2UIPROC>::Call);
+		Install(glad_glUniform3ui, &Uniform<PFNGLUNIFORM3UIPROC>::Call);
+		Install(glad_glUniform4ui, &Uniform<PFNGLUNIFORM4UIPROC>::Call);
+		Install(glad_glUniform1f, &Uniform<PFNGLUNIFORM1FPROC>::Call);
+		Install(glad_glUniform2f, &Uniform<PFNGLUNIFORM2FPROC>::Call);
+		Install(glad_glUniform3f, &Uniform<PFNGLUNIFORM3FPROC>::Call);
+		Install(glad_glUniform4f, &Uniform<PFNGLUNIFORM4FPROC>::Call);
+		Install(glad_glUniform1iv, &Uniform<PFNGLUNIFORM1IVPROC>::Call);
+		Install(glad_glUniform2iv, &Uniform<PFNGLUNIFORM2IVPROC>::Call);
+		Install(glad_glUniform3iv, &Uniform<PFNGLUNIFORM3IVPROC>::Call);
+		Install(glad_glUniform4iv, &Uniform<PFNGLUNIFORM4IVPROC>::Call);
+		Install(glad_glUniform1uiv, &Uniform<PFNGLUNIFORM1UIVPROC>::Call);
+		Install(glad_glUniform2uiv, &Uniform<PFNGLUNIFORM2UIVPROC>::Call);
+		Install(glad_glUniform3uiv, &Uniform<PFNGLUNIFORM3UIVPROC>::Call);
+		Install(glad_glUniform4uiv, &Uniform<PFNGLUNIFORM4UIVPROC>::Call);
+		Install(glad_glUniform1fv, &Uniform<PFNGLUNIFORM1FVPROC>::Call);
+		Install(glad_glUniform2fv, &Uniform<PFNGLUNIFORM2FVPROC>::Call);
+		Install(glad_glUniform3fv, &Uniform<PFNGLUNIFORM3FVPROC>::Call);
+		Install(glad_glUniform4fv, &Uniform<PFNGLUNIFORM4FVPROC>::Call);
+		Install(glad_glUniformMatrix4fv, &Uniform<PFNGLUNIFORMMATRIX4FVPROC>::Call);
+		Install(glad_glProgramUniform1i, &Uniform<PFNGLPROGRAMUNIFORM1IPROC>::Call);
+		Install(glad_glProgramUniform2i, &Uniform<PFNGLPROGRAMUNIFORM2IPROC>::Call);
+		Install(glad_glProgramUniform3i, &Uniform<PFNGLPROGRAMUNIFORM3IPROC>::Call);
+		Install(glad_glProgramUniform4i, &Uniform<PFNGLPROGRAMUNIFORM4IPROC>::Call);
+		Install(glad_glProgramUniform1ui, &Uniform<PFNGLPROGRAMUNIFORM1UIPROC>::Call);
+		Install(glad_glProgramUniform2ui, &Uniform<PFNGLPROGRAMUNIFORM2UIPROC>::Call);
+		Install(glad_glProgramUniform3ui, &Uniform<PFNGLPROGRAMUNIFORM3UIPROC>::Call);
+		Install(glad_glProgramUniform4ui, &Uniform<PFNGLPROGRAMUNIFORM4UIPROC>::Call);
+		Install(glad_glProgramUniform1f, &Uniform<PFNGLPROGRAMUNIFORM1FPROC>::Call);
+		Install(glad_glProgramUniform2f, &Uniform<PFNGLPROGRAMUNIFORM2FPROC>::Call);
+		Install(glad_glProgramUniform3f, &Uniform<PFNGLPROGRAMUNIFORM3FPROC>::Call);
+		Install(glad_glProgramUniform4f, &Uniform<PFNGLPROGRAMUNIFORM4FPROC>::Call);
+		Install(glad_glProgramUniform1iv, &Uniform<PFNGLPROGRAMUNIFORM1IVPROC>::Call);
+		Install(glad_glProgramUniform2iv, &Uniform<PFNGLPROGRAMUNIFORM2IVPROC>::Call);
+		Install(glad_glProgramUniform3iv, &Uniform<PFNGLPROGRAMUNIFORM3IVPROC>::Call);
+		Install(glad_glProgramUniform4iv, &Uniform<PFNGLPROGRAMUNIFORM4IVPROC>::Call);
+		Install(glad_glProgramUniform1uiv, &Uniform<PFNGLPROGRAMUNIFORM1UIVPROC>::Call);
+		Install(glad_glProgramUniform2uiv, &Uniform<PFNGLPROGRAMUNIFORM2UIVPROC>::Call);
+		Install(glad_glProgramUniform3uiv, &Uniform<PFNGLPROGRAMUNIFORM3UIVPROC>::Call);
+		Install(glad_glProgramUniform4uiv, &Uniform<PFNGLPROGRAMUNIFORM4UIVPROC>::Call);
+		Install(glad_glProgramUniform1fv, &Uniform<PFNGLPROGRAMUNIFORM1FVPROC>::Call);
+		Install(glad_glProgramUniform2fv, &Uniform<PFNGLPROGRAMUNIFORM2FVPROC>::Call);
+		Install(glad_glProgramUniform3fv, &Uniform<PFNGLPROGRAMUNIFORM3FVPROC>::Call);
+		Install(glad_glProgramUniform4fv, &Uniform<PFNGLPROGRAMUNIFORM4FVPROC>::Call);
+		Install(glad_glProgramUniformMatrix4fv, &Uniform<PFNGLPROGRAMUNIFORMMATRIX4FVPROC>::Call);
+
+		// Feature flags gladLoadGL would have set
+		Install(GLAD_GL_VERSION_3_3, 1);
+		Install(GLAD_GL_VERSION_4_0, 1);
+		Install(GLAD_GL_VERSION_4_1, 1);
+		Install(GLAD_GL_VERSION_4_2, 1);
+		Install(GLAD_GL_VERSION_4_3, 1);
+		Install(GLAD_GL_ARB_buffer_storage, desc.bufferStorage ? 1 : 0);
+		Install(GLAD_GL_KHR_parallel_shader_compile, 0);
+		Install(GLAD_GL_EXT_texture_compression_s3tc, 1);
+		Install(GLAD_GL_EXT_texture_sRGB, 1);
+
+#ifdef GLAD_DEBUG
+		glad_set_post_callback((GLADcallback)RecordCall);
+#endif
+
+		glstate::Invalidate();
+		shadercache::Invalidate();
+		log::InfoFrom("HeadlessGL", "Using the headless GL backend, nothing will be drawn");
+
+		return GraphicsContext{
+			/* .GL = */ { /* .majorVersion = */ OGL_TARGET_GL_MAJOR, /* .minorVersion = */ OGL_TARGET_GL_MINOR },
+			/* .maxTotalTextureSlots = */ desc.textureSlots * 2,
+			/* .maxFragmentTextureSlots = */ desc.textureSlots,
+			/* .frameBufferWidth = */ desc.frameBufferWidth,
+			/* .frameBufferHeight = */ desc.frameBufferHeight
+		};
+	}
+
+	void Shutdown() {
+		for(auto it = s_Restore.rbegin(); it != s_Restore.rend(); it++) (*it)();
+		s_Restore.clear();
+		s_State.reset();
+		glstate::Invalidate();
+		shadercache::Invalidate();
+	}
+
+	bool IsActive() { return s_State != nullptr; }
+
+	const HeadlessGLStats& Stats() {
+		OGL_DEBUG_ASSERT(s_State, "The headless GL backend is not active");
+		return s_State->stats;
+	}
+
+	void ResetStats() {
+		OGL_DEBUG_ASSERT(s_State, "The headless GL backend is not active");
+		s_State->stats = HeadlessGLStats{};
+		s_State->calls.clear();
+	}
+
+	const std::vector<const char*>& Calls() {
+		OGL_DEBUG_ASSERT(s_State, "The headless GL backend is not active");
+		return s_State->calls;
+	}
+
+	const std::vector<uint8_t>* BufferContents(uint32_t glId) {
+		if(!s_State) return nullptr;
+		const auto it = s_State->buffers.find(glId);
+		return it == s_State->buffers.end() ? nullptr : &it->second;
+	}
+}
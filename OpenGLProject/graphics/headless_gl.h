@@ -0,0 +1,64 @@
+#pragma once
+
+#include <vector>
+
+#include "core.h"
+#include "graphics/context.h"
+
+namespace ogl {
+
+	struct HeadlessGLDesc {
+		int frameBufferWidth = 1920;
+		int frameBufferHeight = 1080;
+		// Reported for GL_MAX_TEXTURE_IMAGE_UNITS, the combined count is double
+		int textureSlots = 16;
+		// Report GL_ARB_buffer_storage so persistently mapped buffers are used
+		bool bufferStorage = true;
+		// Keep the name of every GL call in order, see headless::Calls
+		bool recordCalls = false;
+	};
+
+	struct HeadlessGLStats {
+		// Every GL call made. Needs glad's debug callbacks (GLAD_DEBUG)
+		size_t calls = 0;
+		size_t drawCalls = 0;
+		// Vertices submitted by draw calls, instanced draws count every instance
+		size_t vertices = 0;
+		size_t instances = 0;
+		// Bytes passed to glBufferData, glBufferSubData and glBufferStorage
+		size_t bufferUploadBytes = 0;
+		// Bytes mapped for writing. Persistent maps are only counted once, when
+		// they are created, as writes through them can't be seen
+		size_t mappedWriteBytes = 0;
+		size_t textureUploadBytes = 0;
+		// Binds, enables and other state setting calls. Redundant ones set the
+		// state to the value it already had.
+		size_t stateChanges = 0;
+		size_t redundantStateChanges = 0;
+		size_t uniformCalls = 0;
+	};
+
+	// The headless backend replaces the GL entry points glad would load with
+	// functions that emulate just enough of GL for the renderer to run without
+	// a context or a display. Buffer contents are kept in memory and calls,
+	// uploads, draws and state changes are counted, so renderer hot paths can
+	// be tested and benchmarked deterministically on machines without a GPU.
+	namespace headless {
+
+		// Installs the backend and returns a context to create renderers with.
+		// Must be called instead of loading GL, not as well as.
+		GraphicsContext Init(const HeadlessGLDesc& desc = HeadlessGLDesc{});
+		// Restores the GL entry points and frees everything the backend holds.
+		void Shutdown();
+		bool IsActive();
+
+		const HeadlessGLStats& Stats();
+		void ResetStats();
+
+		// Names of the calls made since the last ResetStats, if recordCalls is set
+		const std::vector<const char*>& Calls();
+
+		// Contents of a buffer object, nullptr if there is no such buffer
+		const std::vector<uint8_t>* BufferContents(uint32_t glId);
+	}
+}
@@ -0,0 +1,102 @@
+#include "render_queue.h"
+
+#include <chrono>
+#include <algorithm>
+
+namespace ogl {
+
+	void RenderQueue::push(const RenderCommand& command) {
+		OGL_DEBUG_ASSERT(command.shader && command.vao, "Render commands need a shader and a vertex array");
+		std::lock_guard lock(m_Mutex);
+		m_Commands.push_back(command);
+	}
+
+	void RenderQueue::push(const RenderCommand* commands, size_t count) {
+		std::lock_guard lock(m_Mutex);
+		m_Commands.insert(m_Commands.end(), commands, commands + count);
+	}
+
+	size_t RenderQueue::size() const {
+		std::lock_guard lock(m_Mutex);
+		return m_Commands.size();
+	}
+
+	void RenderQueue::submit() {
+		std::lock_guard lock(m_Mutex);
+		m_Stats = Stats{};
+		m_Stats.commands = m_Commands.size();
+
+		// Sorting (key, index) pairs is cheaper than moving whole commands
+		// around, the index also keeps commands with equal keys in push order
+		using namespace std::chrono;
+		const auto start = high_resolution_clock::now();
+		m_Order.resize(m_Commands.size());
+		for(size_t i = 0; i < m_Commands.size(); i++) m_Order[i] = { m_Commands[i].key, (uint32_t)i };
+		std::sort(m_Order.begin(), m_Order.end());
+		m_Stats.sortTime = duration<float, std::micro>(high_resolution_clock::now() - start).count();
+
+		// Binds go through glstate, which skips the redundant ones. The
+		// difference in its stats is what this submit did.
+		const GLStateStats before = glstate::Stats();
+		m_UniformState.clear();
+
+		for(const auto& [key, index] : m_Order) {
+			const RenderCommand& command = m_Commands[index];
+			OGL_DEBUG_ASSERT(command.textureCount <= OGL_RENDER_MAX_TEXTURES && command.uniformCount <= OGL_RENDER_MAX_UNIFORMS);
+
+			command.shader->bind();
+			for(uint32_t i = 0; i < command.uniformCount; i++) {
+				set_uniform(*command.shader, m_Uniforms[command.uniforms[i]]);
+			}
+
+			if(command.uniformBuffer) glstate::BindBufferBase(GL_UNIFORM_BUFFER, command.uniformBufferBinding, command.uniformBuffer);
+			command.vao->bind();
+			for(uint32_t slot = 0; slot < command.textureCount; slot++) {
+				glstate::BindTextureUnit(slot, command.textures[slot]);
+			}
+
+			if(command.type == RenderDrawType::Indices) 
+				command.vao->draw_indices(command.count, command.offset, command.baseVertex);
+			else 
+				command.vao->draw_instanced_strip(command.count, command.instanceCount, command.baseInstance);
+			m_Stats.drawCalls++;
+		}
+
+		const GLStateStats& after = glstate::Stats();
+		m_Stats.programBinds = after.programBinds - before.programBinds;
+		m_Stats.programBindsElided = after.programBindsElided - before.programBindsElided;
+		m_Stats.vaoBinds = after.vertexArrayBinds - before.vertexArrayBinds;
+		m_Stats.vaoBindsElided = after.vertexArrayBindsElided - before.vertexArrayBindsElided;
+		m_Stats.textureBinds = after.textureBinds - before.textureBinds;
+		m_Stats.textureBindsElided = after.textureBindsElided - before.textureBindsElided;
+		// Uniform buffers are the only buffers bound here
+		m_Stats.uniformBufferBinds = after.bufferBinds - before.bufferBinds;
+		m_Stats.uniformBufferBindsElided = after.bufferBindsElided - before.bufferBindsElided;
+
+		m_Commands.clear();
+		m_Uniforms.clear();
+	}
+
+	void RenderQueue::set_uniform(Shader& shader, const Uniform& uniform) {
+		const uint32_t program = shader.get_renderer_id();
+
+		auto it = std::find_if(m_UniformState.begin(), m_UniformState.end(), [&](const UniformState& state) {
+			return state.program == program && std::strcmp(state.uniform->name, uniform.name) == 0;
+		});
+
+		if(it != m_UniformState.end()) {
+			const Uniform& last = *it->uniform;
+			if(last.size == uniform.size && std::memcmp(last.value, uniform.value, uniform.size) == 0) {
+				m_Stats.uniformSetsElided++;
+				return;
+			}
+			it->uniform = &uniform;
+		}
+		else {
+			m_UniformState.push_back(UniformState{ program, &uniform });
+		}
+
+		uniform.apply(shader, uniform.name, uniform.value);
+		m_Stats.uniformSets++;
+	}
+}
@@ -0,0 +1,162 @@
+#pragma once
+
+#include <mutex>
+#include <vector>
+#include <cstring>
+#include <type_traits>
+
+#include "core.h"
+#include "graphics/shader.h"
+#include "graphics/vertex_array.h"
+
+#define OGL_RENDER_MAX_TEXTURES 32
+#define OGL_RENDER_MAX_UNIFORMS 4
+
+namespace ogl {
+
+	enum class RenderDrawType : uint8_t {
+		// VertexArray::draw_indices
+		Indices,
+		// VertexArray::draw_instanced_strip
+		InstancedStrip
+	};
+
+	// Builds a sort key that groups commands by layer, then program, then
+	// texture, with order breaking ties:
+	//
+	//   [63..56] layer | [55..40] program | [39..24] texture | [23..0] order
+	//
+	// Commands whose draw order matters (translucent sprites, batches of the
+	// same layer) should pass the same program and texture so only order
+	// decides between them.
+	inline uint64_t MakeRenderKey(uint8_t layer, uint32_t program, uint32_t texture, uint32_t order) {
+		return ((uint64_t)layer << 56) | ((uint64_t)(program & 0xffff) << 40)
+			| ((uint64_t)(texture & 0xffff) << 24) | (order & 0xffffff);
+	}
+
+	// A draw packet. Everything a draw needs is in the command so commands can be
+	// reordered freely by their key. The shader, vertex array and textures must
+	// stay alive until the queue is submitted.
+	struct RenderCommand {
+		uint64_t key = 0;
+		Shader* shader = nullptr;
+		VertexArray* vao = nullptr;
+
+		// GL ids of the textures bound to slots [0, textureCount). Binding by
+		// id skips Texture2D::mark_used, whoever pushes the command calls it.
+		uint32_t textures[OGL_RENDER_MAX_TEXTURES];
+		uint32_t textureCount = 0;
+
+		// GL id of a uniform buffer bound to uniformBufferBinding for the
+		// draw, 0 leaves the binding alone
+		uint32_t uniformBuffer = 0;
+		uint32_t uniformBufferBinding = 0;
+
+		// Ids returned by RenderQueue::push_uniform, set before the draw
+		uint32_t uniforms[OGL_RENDER_MAX_UNIFORMS];
+		uint32_t uniformCount = 0;
+
+		RenderDrawType type = RenderDrawType::Indices;
+		// Index count for Indices, vertex count for InstancedStrip
+		uint32_t count = 0;
+		// Byte offset into the index buffer for Indices, unused otherwise
+		uint32_t offset = 0;
+		int32_t baseVertex = 0;
+		uint32_t instanceCount = 0;
+		uint32_t baseInstance = 0;
+	};
+
+	struct RenderQueueStats {
+		size_t commands = 0;
+		size_t drawCalls = 0;
+		// Binds and uniform sets issued, and the ones skipped because the
+		// state was already set (see glstate for binds)
+		size_t programBinds = 0;
+		size_t programBindsElided = 0;
+		size_t vaoBinds = 0;
+		size_t vaoBindsElided = 0;
+		size_t textureBinds = 0;
+		size_t textureBindsElided = 0;
+		size_t uniformBufferBinds = 0;
+		size_t uniformBufferBindsElided = 0;
+		size_t uniformSets = 0;
+		size_t uniformSetsElided = 0;
+		// Time spent sorting in microseconds
+		float sortTime = 0.0f;
+	};
+
+	// RenderQueue collects draw commands over a frame and then draws them all in
+	// one pass, sorted by key. Sorting puts commands sharing state next to each
+	// other, glstate then skips the binds that would change nothing and the
+	// queue skips uniform sets that would. Commands and uniforms can be pushed from any thread,
+	// submit must be called on the thread owning the GL context.
+	class RenderQueue {
+	public:
+		using Stats = RenderQueueStats;
+
+		RenderQueue() = default;
+		RenderQueue(const RenderQueue&) = delete;
+		RenderQueue(RenderQueue&&) = delete;
+
+		void push(const RenderCommand& command);
+		// Pushes count commands taking the lock once
+		void push(const RenderCommand* commands, size_t count);
+
+		// Copies value into the queue and returns an id for RenderCommand::uniforms.
+		// One id can be shared by any number of commands. name must stay valid
+		// until submit, string literals are the usual choice.
+		template<typename T>
+		uint32_t push_uniform(const char* name, const T& value);
+
+		// Sorts and draws every command pushed since the last submit, then clears
+		// the queue. Stats are reset and describe this submit only.
+		void submit();
+
+		size_t size() const;
+		const Stats& get_stats() const { return m_Stats; }
+
+	private:
+		struct Uniform {
+			static constexpr size_t s_MaxSize = 64;
+
+			const char* name;
+			void (*apply)(Shader&, const char*, const void*);
+			uint32_t size;
+			alignas(16) uint8_t value[s_MaxSize];
+		};
+
+		// The last value set for a uniform of a program during this submit
+		struct UniformState {
+			uint32_t program;
+			const Uniform* uniform;
+		};
+
+		void set_uniform(Shader& shader, const Uniform& uniform);
+
+		mutable std::mutex m_Mutex;
+		std::vector<RenderCommand> m_Commands;
+		std::vector<Uniform> m_Uniforms;
+
+		// Submit state, kept around so we don't allocate every frame
+		std::vector<std::pair<uint64_t, uint32_t>> m_Order;
+		std::vector<UniformState> m_UniformState;
+		Stats m_Stats;
+	};
+
+	template<typename T>
+	uint32_t RenderQueue::push_uniform(const char* name, const T& value) {
+		static_assert(sizeof(T) <= Uniform::s_MaxSize, "Uniform value is too large to queue");
+		static_assert(alignof(T) <= 16, "Uniform value is over aligned");
+		static_assert(std::is_trivially_copyable_v<T>, "Uniform values are copied with memcpy");
+
+		Uniform uniform;
+		uniform.name = name;
+		uniform.apply = [](Shader& shader, const char* name, const void* value) { shader.set_uniform(name, *(const T*)value); };
+		uniform.size = sizeof(T);
+		std::memcpy(uniform.value, &value, sizeof(T));
+
+		std::lock_guard lock(m_Mutex);
+		m_Uniforms.push_back(uniform);
+		return (uint32_t)m_Uniforms.size() - 1;
+	}
+}
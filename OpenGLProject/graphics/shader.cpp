@@ -1,20 +1,82 @@
 #include "shader.h"
 #include <optional>
+#include <algorithm>
+
+#include "util/hash.h"
+#include "graphics/shader_cache.h"
 
 namespace ogl {
 
 
-	Shader::Shader(uint32_t id) : m_ProgramId(id) {}
-	Shader::Shader(Shader&& other) : m_ProgramId(other.m_ProgramId) { other.m_ProgramId = 0; }
-	Shader::~Shader() { if(m_ProgramId) glDeleteProgram(m_ProgramId); }
+	// Uniform names are short, so FNV-1a is cheaper than anything fancier
+	static uint64_t HashUniformName(const char* name) { return HashFNV1a(std::string_view(name)); }
+
+	Shader::Shader(uint32_t id) : m_ProgramId(id) { reflect_uniforms(); }
+	Shader::Shader(Shader&& other) : m_ProgramId(other.m_ProgramId), m_Uniforms(std::move(other.m_Uniforms)) { other.m_ProgramId = 0; }
+	Shader::~Shader() { 
+		if(!m_ProgramId) return;
+		glDeleteProgram(m_ProgramId); 
+		glstate::ProgramDeleted(m_ProgramId);
+	}
 
 	Shader& Shader::operator=(Shader&& other) {
 		std::swap(m_ProgramId, other.m_ProgramId);
+		std::swap(m_Uniforms, other.m_Uniforms);
 		return *this;
 	}
 
-	void Shader::bind() { glUseProgram(m_ProgramId); }
-	void Shader::unbind() { glUseProgram(0); }
+	void Shader::bind() { glstate::UseProgram(m_ProgramId); }
+	void Shader::unbind() { glstate::UseProgram(0); }
+
+	void Shader::reflect_uniforms() {
+		int32_t count = 0, maxLength = 0;
+		glGetProgramiv(m_ProgramId, GL_ACTIVE_UNIFORMS, &count);
+		glGetProgramiv(m_ProgramId, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+
+		std::string name(std::max(maxLength, 1), '\0');
+		for(int32_t i = 0; i < count; i++) {
+			int32_t length = 0, size = 0;
+			GLenum type;
+			glGetActiveUniform(m_ProgramId, i, (GLsizei)name.size(), &length, &size, &type, name.data());
+
+			// Uniforms in blocks have no location
+			const int32_t location = glGetUniformLocation(m_ProgramId, name.c_str());
+			if(location == -1) continue;
+
+			std::string uniform(name.data(), length);
+			// Arrays are reported as "name[0]", but are usually set by name
+			if(size > 1 && uniform.size() > 3 && uniform.compare(uniform.size() - 3, 3, "[0]") == 0) {
+				std::string base = uniform.substr(0, uniform.size() - 3);
+				m_Uniforms.push_back({ HashUniformName(base.c_str()), location, std::move(base) });
+			}
+			m_Uniforms.push_back({ HashUniformName(uniform.c_str()), location, std::move(uniform) });
+		}
+
+		std::sort(m_Uniforms.begin(), m_Uniforms.end(), [](const UniformLocation& a, const UniformLocation& b) { return a.hash < b.hash; });
+	}
+
+	int32_t Shader::uniform_location(const char* name) {
+		const uint64_t hash = HashUniformName(name);
+		auto it = std::lower_bound(m_Uniforms.begin(), m_Uniforms.end(), hash, 
+			[](const UniformLocation& uniform, uint64_t hash) { return uniform.hash < hash; });
+
+		for(auto match = it; match != m_Uniforms.end() && match->hash == hash; match++) {
+			if(match->name == name) return match->location;
+		}
+
+		// Not reflected, e.g. an element of an array. Ask GL once and remember
+		// the answer either way.
+		const int32_t location = glGetUniformLocation(m_ProgramId, name);
+		m_Uniforms.insert(it, { hash, location, name });
+		return location;
+	}
+
+	bool Shader::set_uniform_block_binding(const char* blockName, uint32_t binding) {
+		const uint32_t index = glGetUniformBlockIndex(m_ProgramId, blockName);
+		if(index == GL_INVALID_INDEX) return false;
+		glUniformBlockBinding(m_ProgramId, index, binding);
+		return true;
+	}
 
 	ShaderBuilder::ShaderBuilder() {}
 	ShaderBuilder::ShaderBuilder(ShaderVars&& vars) : m_Vars(std::move(vars)) {}
@@ -27,16 +89,7 @@ namespace ogl {
 	}
 
 	void ShaderBuilder::add_vertex_shader(std::string_view source) {
-		const uint32_t id = glCreateShader(GL_VERTEX_SHADER);
-		if(!id) {
-			log::ErrorFrom("ShaderBuilder", "Failed to create vertex shader because of an internal GL error");
-			return;
-		}
-
-		const int32_t size = source.size(); 
-		const char* data = source.data();
-		glShaderSource(id, 1, &data, &size);
-		m_ShaderIds.push_back(id);
+		m_Sources.push_back({ GL_VERTEX_SHADER, std::string(source) });
 	}
 
 
@@ -48,101 +101,182 @@ namespace ogl {
 	}
 
 	void ShaderBuilder::add_fragment_shader(std::string_view source) {
-		const uint32_t id = glCreateShader(GL_FRAGMENT_SHADER);
-		if(!id) {
-			log::ErrorFrom("ShaderBuilder", "Failed to create fragment shader because of an internal GL error");
-			return;
-		}
-
-		const int32_t size = source.size(); 
-		const char* data = source.data();
-		glShaderSource(id, 1, &data, &size);
-		m_ShaderIds.push_back(id);
+		m_Sources.push_back({ GL_FRAGMENT_SHADER, std::string(source) });
 	}
 
 	void ShaderBuilder::specify_attrib(uint32_t id, const std::string& name) {
 		m_Attribs.push_back({id, name});
 	}
 
+	uint64_t ShaderBuilder::cache_key(const std::vector<std::string>& sources) const {
+		// The vars are already substituted into the sources
+		uint64_t hash = s_FNV1aOffset;
+		for(size_t i = 0; i < sources.size(); i++) {
+			hash = HashValueFNV1a(m_Sources[i].first, hash);
+			hash = HashValueFNV1a(sources[i].size(), hash);
+			hash = HashFNV1a(sources[i], hash);
+		}
+
+		for(const auto& [id, name] : m_Attribs) {
+			hash = HashValueFNV1a(id, hash);
+			hash = HashFNV1a(name, hash);
+			// Separates the name from the next id
+			hash = HashValueFNV1a('\0', hash);
+		}
+
+		return hash;
+	}
 
-	std::optional<Shader> ShaderBuilder::generate() {
-		if(m_ShaderIds.size() == 0){
+	std::optional<Shader> ShaderBuilder::generate() { return generate_async().get(); }
+
+	PendingShader ShaderBuilder::generate_async() {
+		PendingShader pending;
+		if(m_Sources.size() == 0){
 			log::ErrorFrom("Shader Builder", "Shader failed to generate because there were no shaders");
-			return std::nullopt;
+			return pending;
 		}
 
-		const uint32_t progId = glCreateProgram();
-		if(!progId) {
-			log::ErrorFrom("ShaderBuilder", "Shader failed to generate because of an internal GL error");
-			return std::nullopt;
+		// Permutations seen before come straight from the preprocessor's cache
+		std::vector<std::string> sources;
+		sources.reserve(m_Sources.size());
+		for(const auto& [type, source] : m_Sources) {
+			auto processed = glsl::Preprocess(source, m_Vars);
+			if(!processed) {
+				log::ErrorFrom("ShaderBuilder", "Shader failed to generate because a source failed to preprocess");
+				return pending;
+			}
+			sources.push_back(std::move(*processed));
 		}
 
-		// We store all the shaders we successfully managed to attach in this vector.
-		ArrayVector<uint32_t, MAX_SHADERS> attachedShaders;
+		pending.m_ProgramId = glCreateProgram();
+		if(!pending.m_ProgramId) {
+			log::ErrorFrom("ShaderBuilder", "Shader failed to generate because of an internal GL error");
+			return pending;
+		}
 
-		bool success = false;
-		// When the functions returns this will be called
-		SCOPE_DEFER([&] {
-			for(const auto& id : m_ShaderIds) {
-				glDeleteShader(id);
+		if(shadercache::IsEnabled()) {
+			pending.m_CacheKey = cache_key(sources);
+			if(shadercache::Load(*pending.m_CacheKey, pending.m_ProgramId)) {
+				pending.m_CacheKey.reset();
+				pending.m_Linked = true;
+				return pending;
 			}
+		}
 
-			for(const auto& id : attachedShaders) {
-				glDetachShader(progId, id);
+		// Nothing is checked until PendingShader::get, asking for a status
+		// here would wait for the driver to finish
+		for(size_t i = 0; i < sources.size(); i++) {
+			const uint32_t id = glCreateShader(m_Sources[i].first);
+			if(!id) {
+				log::ErrorFrom("ShaderBuilder", "Failed to create shader because of an internal GL error");
+				pending.release();
+				return pending;
 			}
+			// Attached straight away, so every shader in here is attached
+			glAttachShader(pending.m_ProgramId, id);
+			pending.m_ShaderIds.push_back(id);
 
-			// Delete the program if we didn't succeed in creating it.
-			if(!success) glDeleteProgram(progId);
-		});
+			const int32_t size = sources[i].size(); 
+			const char* data = sources[i].data();
+			glShaderSource(id, 1, &data, &size);
+			glCompileShader(id);
+		}
+
+		// Specify attributes
+		for(auto&[id, name] : m_Attribs) {
+			glBindAttribLocation(pending.m_ProgramId, id, name.c_str());
+		}
+
+		// Has to be set before linking for the binary to be retrievable
+		if(pending.m_CacheKey) glProgramParameteri(pending.m_ProgramId, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+		glLinkProgram(pending.m_ProgramId);
+		return pending;
+	}
+
+	PendingShader::PendingShader(PendingShader&& other) 
+		: m_ProgramId(other.m_ProgramId), m_ShaderIds(std::move(other.m_ShaderIds)), 
+		m_CacheKey(other.m_CacheKey), m_Linked(other.m_Linked) { 
+		other.m_ProgramId = 0; 
+		other.m_ShaderIds.clear();
+	}
+
+	PendingShader& PendingShader::operator=(PendingShader&& other) {
+		std::swap(m_ProgramId, other.m_ProgramId);
+		std::swap(m_ShaderIds, other.m_ShaderIds);
+		std::swap(m_CacheKey, other.m_CacheKey);
+		std::swap(m_Linked, other.m_Linked);
+		return *this;
+	}
 
+	PendingShader::~PendingShader() { release(); }
 
-		// Compile individual shader parts
+	void PendingShader::release_shaders() {
 		for(const auto& id : m_ShaderIds) {
-			glCompileShader(id);
+			glDetachShader(m_ProgramId, id);
+			glDeleteShader(id);
+		}
+		m_ShaderIds.clear();
+	}
 
+	void PendingShader::release() {
+		release_shaders();
+		if(m_ProgramId) glDeleteProgram(m_ProgramId);
+		m_ProgramId = 0;
+	}
+
+	bool PendingShader::is_ready() {
+		if(!m_ProgramId || m_Linked || !GLAD_GL_KHR_parallel_shader_compile) return true;
+
+		// Linking finishes after every attached shader has compiled
+		int32_t complete = GL_FALSE;
+		glGetProgramiv(m_ProgramId, GL_COMPLETION_STATUS_KHR, &complete);
+		return complete;
+	}
+
+	std::optional<Shader> PendingShader::get() {
+		OGL_DEBUG_ASSERT(m_ProgramId, "Shader generation failed or the shader was already taken");
+		if(!m_ProgramId) return std::nullopt;
+
+		// Whatever is left when this returns failed and is deleted
+		SCOPE_DEFER([&] { release(); });
+
+		if(m_Linked) return Shader(std::exchange(m_ProgramId, 0));
+
+		// Compile errors say more than the link error they cause
+		for(const auto& id : m_ShaderIds) {
 			int32_t compileStatus = GL_FALSE;
 			glGetShaderiv(id, GL_COMPILE_STATUS, &compileStatus);
 			
 			if(!compileStatus) {
-				int32_t logLength;
+				int32_t logLength = 0;
 				glGetShaderiv(id, GL_INFO_LOG_LENGTH, &logLength);
 				
-				char* log = new char[logLength + 1];
-				glGetShaderInfoLog(id, logLength, NULL, log);
-				log[logLength] = '\0';
+				std::string log(std::max(logLength, 1), '\0');
+				glGetShaderInfoLog(id, logLength, NULL, log.data());
 
-				log::ErrorFrom("ShaderBuilder", "Shader failed to compile: ", log);
+				log::ErrorFrom("ShaderBuilder", "Shader failed to compile: ", log.c_str());
 				return std::nullopt;
 			}
-
-			glAttachShader(progId, id);
-			attachedShaders.push_back(id);
 		}
 
-		// Specify attributes
-		for(auto&[id, name] : m_Attribs) {
-			glBindAttribLocation(progId, id, name.c_str());
-		}
-
-		glLinkProgram(progId);
-
 		int32_t linkStatus = GL_FALSE;
-		glGetProgramiv(progId, GL_LINK_STATUS, &linkStatus);
+		glGetProgramiv(m_ProgramId, GL_LINK_STATUS, &linkStatus);
 		
 		if(!linkStatus) {	
-			int32_t logLength;
-			glGetProgramiv(progId, GL_INFO_LOG_LENGTH, &logLength);
+			int32_t logLength = 0;
+			glGetProgramiv(m_ProgramId, GL_INFO_LOG_LENGTH, &logLength);
 			
-			char* log = new char[logLength + 1];
-			glGetProgramInfoLog(progId, logLength, NULL, log);
-			log[logLength] = '\0';
+			std::string log(std::max(logLength, 1), '\0');
+			glGetProgramInfoLog(m_ProgramId, logLength, NULL, log.data());
 
-			log::ErrorFrom("ShaderBuilder", "Shader failed to link: ", log);
-			glDeleteProgram(progId);
+			log::ErrorFrom("ShaderBuilder", "Shader failed to link: ", log.c_str());
 			return std::nullopt;
 		}
-		
-		success = true;
-		return Shader(progId);
+
+		if(m_CacheKey) shadercache::Store(*m_CacheKey, m_ProgramId);
+
+		// A linked program doesn't need its shaders any more
+		release_shaders();
+		return Shader(std::exchange(m_ProgramId, 0));
 	}
 }
@@ -9,6 +9,7 @@
 
 #include <glad/glad.h>
 #include <unordered_map>
+#include <vector>
 
 #include "core.h"
 #include "defer.h"
@@ -17,6 +18,8 @@
 #include "math/vector.h"
 #include "math/matrix.h"
 #include "graphics/texture.h"
+#include "graphics/gl_state.h"
+#include "graphics/shader_preprocessor.h"
 
 #define MAX_SHADERS 10
 #define MAX_ATTRIBS 16
@@ -26,6 +29,7 @@ namespace ogl {
 	class Shader {
 	private:
 		friend class ShaderBuilder;
+		friend class PendingShader;
 		Shader(uint32_t id);
 
 	public:
@@ -34,38 +38,101 @@ namespace ogl {
 		Shader& operator=(Shader&& shader);
 		~Shader();
 		
+		// Both go through glstate, so binding the bound program is skipped
 		void bind();
 		void unbind();
 
-		// TODO: Make uniform assignment better
+		// Location of a uniform, -1 if the program has no such active uniform.
+		// Active uniforms are reflected once when the program is linked, so this
+		// is a lookup in a table of name hashes rather than a call into GL. Look locations up
+		// once and use the location overloads below on hot paths.
+		int32_t uniform_location(const char* name);
+
+		// Uniforms are set with glProgramUniform, the shader doesn't have to be
+		// bound and the current program binding is left alone.
 		template<typename T>
 		void set_uniform(const char* name, const T& value) {
-			bind();
-			auto id = glGetUniformLocation(m_ProgramId, name);
+			auto id = uniform_location(name);
 			OGL_DEBUG_ASSERT(id != -1, "Uniform name is invalid");
 			set_uniform_gl<T>(id, value);
-			unbind();
 		}
 
+		template<typename T>
+		void set_uniform(int32_t location, const T& value) { set_uniform_gl<T>(location, value); }
+
 		template<typename T>
 		void set_uniform_array(const char* name, const T* values, size_t count) {
-			bind();
-			auto id = glGetUniformLocation(m_ProgramId, name);
+			auto id = uniform_location(name);
 			OGL_DEBUG_ASSERT(id != -1, "Uniform name invalid");
 			set_uniform_arr_gl<T>(id, values, count);
-			unbind();
 		}
 
+		template<typename T>
+		void set_uniform_array(int32_t location, const T* values, size_t count) { set_uniform_arr_gl<T>(location, values, count); }
+
+		// Points the std140 uniform block blockName at a uniform buffer binding
+		// point, see UniformBuffer::bind_base. Returns false if the program has
+		// no such block.
+		bool set_uniform_block_binding(const char* blockName, uint32_t binding);
+
 		uint32_t get_renderer_id() { return m_ProgramId; }
 	private:
-		template<typename T> void set_uniform_gl(uint32_t id, const T& value);
-		template<typename T> void set_uniform_arr_gl(uint32_t id, const T* value, size_t count);
+		template<typename T> void set_uniform_gl(int32_t id, const T& value);
+		template<typename T> void set_uniform_arr_gl(int32_t id, const T* value, size_t count);
+
+		// Fills m_Uniforms with the active uniforms of the program
+		void reflect_uniforms();
+
+		struct UniformLocation {
+			uint64_t hash;
+			int32_t location;
+			std::string name;
+		};
 	private:
 		uint32_t m_ProgramId;
+		// Sorted by hash. Names that were looked up but aren't active are
+		// kept too, with location -1, so they are only asked for once.
+		std::vector<UniformLocation> m_Uniforms;
 	};
 
-	typedef std::unordered_map<std::string, std::any> ShaderVars;
+	// A program ShaderBuilder::generate_async has started compiling and
+	// linking. Every shader is submitted before anything is checked, so with
+	// GL_KHR_parallel_shader_compile the driver works on all of them in the
+	// background while we do something else. Without the extension it is up to
+	// the driver when the work happens, is_ready can't tell and get may block.
+	class PendingShader {
+	public:
+		PendingShader() = default;
+		PendingShader(const PendingShader&) = delete;
+		PendingShader(PendingShader&& other);
+		PendingShader& operator=(PendingShader&& other);
+		~PendingShader();
+
+		// True if get won't have to wait for the driver. Never blocks.
+		bool is_ready();
+		// Waits for the program if needed, checks that everything compiled and
+		// linked and hands the program over. Can only be called once.
+		std::optional<Shader> get();
+
+		// False if generate_async failed before anything was submitted, or
+		// after get was called
+		bool valid() const { return m_ProgramId != 0; }
+
+	private:
+		friend class ShaderBuilder;
+		void release_shaders();
+		void release();
+
+		uint32_t m_ProgramId = 0;
+		std::vector<uint32_t> m_ShaderIds;
+		// Stored in the shader cache once linked
+		std::optional<uint64_t> m_CacheKey;
+		// Loaded from the shader cache, there is nothing to wait for
+		bool m_Linked = false;
+	};
 
+	// Sources are run through glsl::Preprocess with the builder's vars when
+	// the program is generated, so they can use #include and ${NAME}.
 	class ShaderBuilder {
 	public:
 		ShaderBuilder();
@@ -90,44 +157,55 @@ namespace ogl {
 		// name of the attribute in the GLSL shader. 
 		void specify_attrib(uint32_t id, const std::string& name);
 
+		// Preprocesses, compiles and links the shaders into a program. When the
+		// shader cache is enabled (see shadercache) and a binary was stored for
+		// the same preprocessed sources and attributes on this driver, it is
+		// loaded instead and nothing is compiled.
 		std::optional<Shader> generate();
+		// Same as generate, but returns as soon as everything is submitted to
+		// the driver. Poll the result with is_ready and collect it with get.
+		PendingShader generate_async();
 	
 	private:
 
-		std::string replace_vars(std::string_view);
+		// Key of the program in the shader cache, sources are the preprocessed
+		// m_Sources
+		uint64_t cache_key(const std::vector<std::string>& sources) const;
 
 	private:
 		ShaderVars m_Vars;
-		ArrayVector<uint32_t, MAX_SHADERS> m_ShaderIds;
+		// (shader type, source). Shaders are only created and compiled by
+		// generate, so a cached program never touches the sources.
+		ArrayVector<std::pair<GLenum, std::string>, MAX_SHADERS> m_Sources;
 		ArrayVector<std::pair<uint32_t, std::string>, MAX_ATTRIBS> m_Attribs;
 	};
 
-	template<> inline void Shader::set_uniform_gl<int32_t>(uint32_t id, const int32_t&  value) { glUniform1i(id, value); }
-	template<> inline void Shader::set_uniform_gl<Vector2<int32_t>>(uint32_t id, const Vector2<int32_t>& value) { glUniform2i(id, value.x, value.y); }
-	template<> inline void Shader::set_uniform_gl<Vector3<int32_t>>(uint32_t id, const Vector3<int32_t>& value) { glUniform3i(id, value.x, value.y, value.z); }
-	template<> inline void Shader::set_uniform_gl<Vector4<int32_t>>(uint32_t id, const Vector4<int32_t>& value) { glUniform4i(id, value.x, value.y, value.z, value.w); }
-	template<> inline void Shader::set_uniform_gl<uint32_t>(uint32_t id, const uint32_t& value) { glUniform1ui(id, value); }
-	template<> inline void Shader::set_uniform_gl<Vector2<uint32_t>>(uint32_t id, const Vector2<uint32_t>& value) { glUniform2ui(id, value.x, value.y); }
-	template<> inline void Shader::set_uniform_gl<Vector3<uint32_t>>(uint32_t id, const Vector3<uint32_t>& value) { glUniform3ui(id, value.x, value.y, value.z); }
-	template<> inline void Shader::set_uniform_gl<Vector4<uint32_t>>(uint32_t id, const Vector4<uint32_t>& value) { glUniform4ui(id, value.x, value.y, value.z, value.w); }
-	template<> inline void Shader::set_uniform_gl<float>(uint32_t id, const float& value) { glUniform1f(id, value); } 
-	template<> inline void Shader::set_uniform_gl<Vector2<float>>(uint32_t id, const Vector2<float>& value) { glUniform2f(id, value.x, value.y); }
-	template<> inline void Shader::set_uniform_gl<Vector3<float>>(uint32_t id, const Vector3<float>& value) { glUniform3f(id, value.x, value.y, value.z); }
-	template<> inline void Shader::set_uniform_gl<Vector4<float>>(uint32_t id, const Vector4<float>& value) { glUniform4f(id, value.x, value.y, value.z, value.w); }
-
-	template<> inline void Shader::set_uniform_arr_gl<int32_t>(uint32_t id, const int32_t* value, size_t count) { glUniform1iv(id, count, value); }
-	template<> inline void Shader::set_uniform_arr_gl<Vector2<int32_t>>(uint32_t id, const Vector2<int32_t>* value, size_t count) { glUniform2iv(id, count, &value->x); }
-	template<> inline void Shader::set_uniform_arr_gl<Vector3<int32_t>>(uint32_t id, const Vector3<int32_t>* value, size_t count) { glUniform3iv(id, count, &value->x); }
-	template<> inline void Shader::set_uniform_arr_gl<Vector4<int32_t>>(uint32_t id, const Vector4<int32_t>* value, size_t count) { glUniform4iv(id, count, &value->x); }
-	template<> inline void Shader::set_uniform_arr_gl<uint32_t>(uint32_t id, const uint32_t* value, size_t count) { glUniform1uiv(id, count, value); }
-	template<> inline void Shader::set_uniform_arr_gl<Vector2<uint32_t>>(uint32_t id, const Vector2<uint32_t>* value, size_t count) { glUniform2uiv(id, count, &value->x); }
-	template<> inline void Shader::set_uniform_arr_gl<Vector3<uint32_t>>(uint32_t id, const Vector3<uint32_t>* value, size_t count) { glUniform3uiv(id, count, &value->x); }
-	template<> inline void Shader::set_uniform_arr_gl<Vector4<uint32_t>>(uint32_t id, const Vector4<uint32_t>* value, size_t count) { glUniform4uiv(id, count, &value->x); }
-	template<> inline void Shader::set_uniform_arr_gl<float>(uint32_t id, const float* value, size_t count) { glUniform1fv(id, count, value); } 
-	template<> inline void Shader::set_uniform_arr_gl<Vector2<float>>(uint32_t id, const Vector2<float>* value, size_t count) { glUniform2fv(id, count, &value->x); } 
-	template<> inline void Shader::set_uniform_arr_gl<Vector3<float>>(uint32_t id, const Vector3<float>* value, size_t count) { glUniform3fv(id, count, &value->x); } 
-	template<> inline void Shader::set_uniform_arr_gl<Vector4<float>>(uint32_t id, const Vector4<float>* value, size_t count) { glUniform4fv(id, count, &value->x); } 
-
-	template<> inline void Shader::set_uniform_gl<Matrix4<float>>(uint32_t id, const Matrix4<float>& value) { glUniformMatrix4fv(id, 1, true, value.data); }
-	template<> inline void Shader::set_uniform_arr_gl<Matrix4<float>>(uint32_t id, const Matrix4<float>* value, size_t count) { glUniformMatrix4fv(id, count, true, value->data); }
+	template<> inline void Shader::set_uniform_gl<int32_t>(int32_t id, const int32_t&  value) { glProgramUniform1i(m_ProgramId, id, value); }
+	template<> inline void Shader::set_uniform_gl<Vector2<int32_t>>(int32_t id, const Vector2<int32_t>& value) { glProgramUniform2i(m_ProgramId, id, value.x, value.y); }
+	template<> inline void Shader::set_uniform_gl<Vector3<int32_t>>(int32_t id, const Vector3<int32_t>& value) { glProgramUniform3i(m_ProgramId, id, value.x, value.y, value.z); }
+	template<> inline void Shader::set_uniform_gl<Vector4<int32_t>>(int32_t id, const Vector4<int32_t>& value) { glProgramUniform4i(m_ProgramId, id, value.x, value.y, value.z, value.w); }
+	template<> inline void Shader::set_uniform_gl<uint32_t>(int32_t id, const uint32_t& value) { glProgramUniform1ui(m_ProgramId, id, value); }
+	template<> inline void Shader::set_uniform_gl<Vector2<uint32_t>>(int32_t id, const Vector2<uint32_t>& value) { glProgramUniform2ui(m_ProgramId, id, value.x, value.y); }
+	template<> inline void Shader::set_uniform_gl<Vector3<uint32_t>>(int32_t id, const Vector3<uint32_t>& value) { glProgramUniform3ui(m_ProgramId, id, value.x, value.y, value.z); }
+	template<> inline void Shader::set_uniform_gl<Vector4<uint32_t>>(int32_t id, const Vector4<uint32_t>& value) { glProgramUniform4ui(m_ProgramId, id, value.x, value.y, value.z, value.w); }
+	template<> inline void Shader::set_uniform_gl<float>(int32_t id, const float& value) { glProgramUniform1f(m_ProgramId, id, value); } 
+	template<> inline void Shader::set_uniform_gl<Vector2<float>>(int32_t id, const Vector2<float>& value) { glProgramUniform2f(m_ProgramId, id, value.x, value.y); }
+	template<> inline void Shader::set_uniform_gl<Vector3<float>>(int32_t id, const Vector3<float>& value) { glProgramUniform3f(m_ProgramId, id, value.x, value.y, value.z); }
+	template<> inline void Shader::set_uniform_gl<Vector4<float>>(int32_t id, const Vector4<float>& value) { glProgramUniform4f(m_ProgramId, id, value.x, value.y, value.z, value.w); }
+
+	template<> inline void Shader::set_uniform_arr_gl<int32_t>(int32_t id, const int32_t* value, size_t count) { glProgramUniform1iv(m_ProgramId, id, count, value); }
+	template<> inline void Shader::set_uniform_arr_gl<Vector2<int32_t>>(int32_t id, const Vector2<int32_t>* value, size_t count) { glProgramUniform2iv(m_ProgramId, id, count, &value->x); }
+	template<> inline void Shader::set_uniform_arr_gl<Vector3<int32_t>>(int32_t id, const Vector3<int32_t>* value, size_t count) { glProgramUniform3iv(m_ProgramId, id, count, &value->x); }
+	template<> inline void Shader::set_uniform_arr_gl<Vector4<int32_t>>(int32_t id, const Vector4<int32_t>* value, size_t count) { glProgramUniform4iv(m_ProgramId, id, count, &value->x); }
+	template<> inline void Shader::set_uniform_arr_gl<uint32_t>(int32_t id, const uint32_t* value, size_t count) { glProgramUniform1uiv(m_ProgramId, id, count, value); }
+	template<> inline void Shader::set_uniform_arr_gl<Vector2<uint32_t>>(int32_t id, const Vector2<uint32_t>* value, size_t count) { glProgramUniform2uiv(m_ProgramId, id, count, &value->x); }
+	template<> inline void Shader::set_uniform_arr_gl<Vector3<uint32_t>>(int32_t id, const Vector3<uint32_t>* value, size_t count) { glProgramUniform3uiv(m_ProgramId, id, count, &value->x); }
+	template<> inline void Shader::set_uniform_arr_gl<Vector4<uint32_t>>(int32_t id, const Vector4<uint32_t>* value, size_t count) { glProgramUniform4uiv(m_ProgramId, id, count, &value->x); }
+	template<> inline void Shader::set_uniform_arr_gl<float>(int32_t id, const float* value, size_t count) { glProgramUniform1fv(m_ProgramId, id, count, value); } 
+	template<> inline void Shader::set_uniform_arr_gl<Vector2<float>>(int32_t id, const Vector2<float>* value, size_t count) { glProgramUniform2fv(m_ProgramId, id, count, &value->x); } 
+	template<> inline void Shader::set_uniform_arr_gl<Vector3<float>>(int32_t id, const Vector3<float>* value, size_t count) { glProgramUniform3fv(m_ProgramId, id, count, &value->x); } 
+	template<> inline void Shader::set_uniform_arr_gl<Vector4<float>>(int32_t id, const Vector4<float>* value, size_t count) { glProgramUniform4fv(m_ProgramId, id, count, &value->x); } 
+
+	template<> inline void Shader::set_uniform_gl<Matrix4<float>>(int32_t id, const Matrix4<float>& value) { glProgramUniformMatrix4fv(m_ProgramId, id, 1, true, value.data); }
+	template<> inline void Shader::set_uniform_arr_gl<Matrix4<float>>(int32_t id, const Matrix4<float>* value, size_t count) { glProgramUniformMatrix4fv(m_ProgramId, id, count, true, value->data); }
 }
@@ -0,0 +1,181 @@
+#include "shader_cache.h"
+
+#include <cstdio>
+#include <vector>
+#include <filesystem>
+#include <system_error>
+
+#include <glad/glad.h>
+
+#include "util/hash.h"
+
+namespace ogl::shadercache {
+
+	namespace {
+
+		// Bumped whenever the file layout changes, old files are then ignored
+		constexpr uint32_t s_FileVersion = 1;
+		constexpr uint32_t s_FileMagic = 0x424c474f; // "OGLB"
+
+		struct FileHeader {
+			uint32_t magic;
+			uint32_t version;
+			// Key the binary was stored under, with the driver mixed in
+			uint64_t key;
+			uint32_t format;
+			uint32_t size;
+		};
+
+		enum class Support { Unknown, Yes, No };
+
+		struct State {
+			std::string directory;
+			Support support = Support::Unknown;
+			uint64_t driverHash = 0;
+			ShaderCacheStats stats;
+		};
+
+		State s_State;
+
+		uint64_t DriverKey(uint64_t key) { return HashValueFNV1a(key, s_State.driverHash); }
+
+		std::filesystem::path BinaryPath(uint64_t driverKey) {
+			char name[32];
+			snprintf(name, sizeof(name), "%016llx.bin", (unsigned long long)driverKey);
+			return std::filesystem::path(s_State.directory) / name;
+		}
+	}
+
+	void SetDirectory(std::string_view path) {
+		s_State.directory = path;
+		if(path.empty()) return;
+
+		std::error_code error;
+		std::filesystem::create_directories(s_State.directory, error);
+		if(error) {
+			log::ErrorFrom("ShaderCache", "Failed to create cache directory '", s_State.directory, "': ", error.message());
+			s_State.directory.clear();
+		}
+	}
+
+	const std::string& Directory() { return s_State.directory; }
+
+	bool IsEnabled() {
+		if(s_State.directory.empty()) return false;
+
+		if(s_State.support == Support::Unknown) {
+			GLint formats = 0;
+			glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+			s_State.support = formats > 0 ? Support::Yes : Support::No;
+
+			if(s_State.support == Support::Yes) {
+				uint64_t hash = s_FNV1aOffset;
+				for(GLenum name : { GL_VENDOR, GL_RENDERER, GL_VERSION }) {
+					const char* string = (const char*)glGetString(name);
+					hash = HashFNV1a(string ? string : "", hash);
+				}
+				s_State.driverHash = hash;
+			}
+			else {
+				log::WarnFrom("ShaderCache", "The driver doesn't support program binaries, shaders won't be cached");
+			}
+		}
+
+		return s_State.support == Support::Yes;
+	}
+
+	bool Load(uint64_t key, uint32_t program) {
+		OGL_DEBUG_ASSERT(IsEnabled(), "The shader cache isn't enabled");
+		const uint64_t driverKey = DriverKey(key);
+
+		FILE* file = fopen(BinaryPath(driverKey).string().c_str(), "rb");
+		if(!file) {
+			s_State.stats.misses++;
+			return false;
+		}
+		SCOPE_DEFER([file] { fclose(file); });
+
+		FileHeader header;
+		if(fread(&header, sizeof(header), 1, file) != 1 || header.magic != s_FileMagic
+			|| header.version != s_FileVersion || header.key != driverKey) {
+			s_State.stats.misses++;
+			return false;
+		}
+
+		std::vector<uint8_t> binary(header.size);
+		if(fread(binary.data(), 1, binary.size(), file) != binary.size()) {
+			s_State.stats.misses++;
+			return false;
+		}
+
+		glProgramBinary(program, header.format, binary.data(), (GLsizei)binary.size());
+
+		GLint linkStatus = GL_FALSE;
+		glGetProgramiv(program, GL_LINK_STATUS, &linkStatus);
+		if(!linkStatus) {
+			// The driver is free to refuse any binary, the program is linked
+			// from source and stored again
+			log::InfoFrom("ShaderCache", "Driver rejected stored program ", BinaryPath(driverKey).filename().string());
+			s_State.stats.rejected++;
+			s_State.stats.misses++;
+			return false;
+		}
+
+		s_State.stats.hits++;
+		return true;
+	}
+
+	void Store(uint64_t key, uint32_t program) {
+		OGL_DEBUG_ASSERT(IsEnabled(), "The shader cache isn't enabled");
+		const uint64_t driverKey = DriverKey(key);
+
+		GLint size = 0;
+		glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &size);
+		if(size <= 0) {
+			log::WarnFrom("ShaderCache", "Program ", program, " has no binary to store");
+			return;
+		}
+
+		FileHeader header{ s_FileMagic, s_FileVersion, driverKey, 0, 0 };
+		std::vector<uint8_t> binary(size);
+		GLsizei length = 0;
+		GLenum format = 0;
+		glGetProgramBinary(program, size, &length, &format, binary.data());
+		header.format = format;
+		header.size = (uint32_t)length;
+
+		// Written next to the real file then renamed over it, so a crash or a
+		// second instance never leaves a half written binary behind
+		const std::filesystem::path path = BinaryPath(driverKey);
+		std::filesystem::path temp = path;
+		temp += ".tmp";
+
+		FILE* file = fopen(temp.string().c_str(), "wb");
+		if(!file) {
+			log::ErrorFrom("ShaderCache", "Failed to open '", temp.string(), "' for writing");
+			return;
+		}
+
+		const bool written = fwrite(&header, sizeof(header), 1, file) == 1
+			&& fwrite(binary.data(), 1, header.size, file) == header.size;
+		fclose(file);
+
+		std::error_code error;
+		if(written) std::filesystem::rename(temp, path, error);
+		if(!written || error) {
+			log::ErrorFrom("ShaderCache", "Failed to write '", path.string(), "'");
+			std::filesystem::remove(temp, error);
+			return;
+		}
+
+		s_State.stats.stores++;
+	}
+
+	void Invalidate() {
+		s_State.support = Support::Unknown;
+		s_State.driverHash = 0;
+	}
+
+	const ShaderCacheStats& Stats() { return s_State.stats; }
+	void ResetStats() { s_State.stats = ShaderCacheStats{}; }
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+#include "core.h"
+
+namespace ogl {
+
+	struct ShaderCacheStats {
+		// Programs loaded from a stored binary
+		size_t hits = 0;
+		// Programs that had no stored binary, or whose binary was rejected
+		size_t misses = 0;
+		// Stored binaries the driver refused to load, e.g. after a driver update
+		size_t rejected = 0;
+		size_t stores = 0;
+	};
+
+	// shadercache keeps the binaries of linked programs on disk
+	// (glGetProgramBinary) so later runs can load them with glProgramBinary
+	// instead of compiling and linking from source. ShaderBuilder::generate
+	// uses it whenever it is enabled.
+	//
+	// Binaries are stored under a key the caller makes from everything that
+	// goes into the program. The vendor, renderer and version strings of the
+	// driver are mixed into it here, a binary is only valid for the driver
+	// that made it.
+	namespace shadercache {
+
+		// Sets the directory binaries are kept in, creating it if needed. An
+		// empty path turns the cache off, which is the default.
+		void SetDirectory(std::string_view path);
+		const std::string& Directory();
+
+		// True if a directory is set and the current context can save and load
+		// program binaries. Asks GL the first time it is called after Invalidate.
+		bool IsEnabled();
+
+		// Loads the binary stored under key into program, a name from
+		// glCreateProgram. Returns false if there is none or the driver
+		// rejected it, program then still has to be linked from source.
+		bool Load(uint64_t key, uint32_t program);
+		// Stores the binary of program, a successfully linked program that had
+		// GL_PROGRAM_BINARY_RETRIEVABLE_HINT set before it was linked
+		void Store(uint64_t key, uint32_t program);
+
+		// Forgets what was learned about the driver. Call when a context is
+		// made current.
+		void Invalidate();
+
+		const ShaderCacheStats& Stats();
+		void ResetStats();
+	}
+}
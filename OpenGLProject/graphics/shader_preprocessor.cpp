@@ -0,0 +1,329 @@
+#include "shader_preprocessor.h"
+
+#include <mutex>
+#include <vector>
+#include <algorithm>
+#include <filesystem>
+
+#include "util/hash.h"
+#include "util/fileio.h"
+
+namespace ogl::glsl {
+
+	namespace {
+
+		// Deeper than any real include chain, it only catches cycles
+		constexpr int s_MaxIncludeDepth = 32;
+
+		// The vars that can be substituted, sorted by name, with their values
+		typedef std::vector<std::pair<std::string, std::string>> VarStrings;
+
+		struct Permutation {
+			std::string source;
+			VarStrings vars;
+			std::string out;
+		};
+
+		struct State {
+			std::mutex mutex;
+			std::vector<std::filesystem::path> includeDirectories;
+			// Added with AddIncludeSource, by name
+			std::unordered_map<std::string, std::string> sources;
+			// Include files read so far by path. Misses aren't kept, a file
+			// can be created after it was first looked for.
+			std::unordered_map<std::string, std::string> files;
+			// Preprocessed sources by hash of the source and the vars, more
+			// than one if hashes collide
+			std::unordered_map<uint64_t, std::vector<Permutation>> permutations;
+			ShaderPreprocessStats stats;
+		};
+
+		State s_State;
+
+		// One call of Preprocess
+		struct Context {
+			const ShaderVars& vars;
+			std::string out;
+			// Files that had #pragma once and were included already
+			std::vector<std::string> onceFiles;
+			// Source string numbers handed to #line, 0 is the source itself
+			uint32_t nextFileIndex = 1;
+		};
+
+		// nullptr if there is no such file
+		const std::string* LoadFile(const std::filesystem::path& path) {
+			const std::string key = path.lexically_normal().string();
+			auto it = s_State.files.find(key);
+			if(it != s_State.files.end()) return &it->second;
+
+			std::error_code error;
+			if(!std::filesystem::is_regular_file(path, error)) return nullptr;
+
+			auto source = ReadFile(key.c_str());
+			s_State.stats.includeReads++;
+			if(!source) return nullptr;
+			return &s_State.files.emplace(key, std::move(*source)).first->second;
+		}
+
+		// Finds an include in the added sources, next to the including file or
+		// in the include directories, in that order. Sets path to where it was found.
+		const std::string* FindInclude(std::string_view name, const std::filesystem::path& from, std::filesystem::path& path) {
+			if(const auto it = s_State.sources.find(std::string(name)); it != s_State.sources.end()) {
+				path = name;
+				return &it->second;
+			}
+
+			if(!from.empty()) {
+				path = from.parent_path() / name;
+				if(const auto* file = LoadFile(path)) return file;
+			}
+
+			for(const auto& directory : s_State.includeDirectories) {
+				path = directory / name;
+				if(const auto* file = LoadFile(path)) return file;
+			}
+			return nullptr;
+		}
+
+		std::string_view TrimStart(std::string_view line) {
+			const size_t start = line.find_first_not_of(" \t");
+			return start == std::string_view::npos ? std::string_view{} : line.substr(start);
+		}
+
+		// Appends code to the output with every ${NAME} replaced
+		bool SubstituteCode(Context& context, std::string_view line) {
+			size_t start;
+			while((start = line.find("${")) != std::string_view::npos) {
+				const size_t end = line.find('}', start);
+				if(end == std::string_view::npos) {
+					log::ErrorFrom("ShaderPreprocessor", "Unterminated ${ in '", line, "'");
+					return false;
+				}
+
+				const std::string name(line.substr(start + 2, end - start - 2));
+				const auto var = context.vars.find(name);
+				if(var == context.vars.end()) {
+					log::ErrorFrom("ShaderPreprocessor", "Shader var '", name, "' isn't set");
+					return false;
+				}
+
+				const auto value = VarToString(var->second);
+				if(!value) {
+					log::ErrorFrom("ShaderPreprocessor", "Shader var '", name, "' has a type that can't be substituted");
+					return false;
+				}
+
+				context.out.append(line.substr(0, start));
+				context.out.append(*value);
+				line.remove_prefix(end + 1);
+			}
+
+			context.out.append(line);
+			return true;
+		}
+
+		// Appends line to the output, substituting vars outside of comments.
+		// inComment is whether a /* */ comment is open and is updated for the
+		// next line.
+		bool Substitute(Context& context, std::string_view line, bool& inComment) {
+			while(!line.empty()) {
+				if(inComment) {
+					const size_t end = line.find("*/");
+					const size_t length = end == std::string_view::npos ? line.size() : end + 2;
+					context.out.append(line.substr(0, length));
+					line.remove_prefix(length);
+					inComment = end == std::string_view::npos;
+					continue;
+				}
+
+				const size_t comment = std::min(line.find("//"), line.find("/*"));
+				if(!SubstituteCode(context, line.substr(0, comment))) return false;
+				if(comment == std::string_view::npos) break;
+
+				line.remove_prefix(comment);
+				if(line.substr(0, 2) == "//") {
+					context.out.append(line);
+					break;
+				}
+				context.out.append("/*");
+				line.remove_prefix(2);
+				inComment = true;
+			}
+			return true;
+		}
+
+		// Only tracks whether text leaves a /* */ comment open
+		void SkipComments(std::string_view text, bool& inComment) {
+			while(!text.empty()) {
+				const size_t at = inComment ? text.find("*/") : std::min(text.find("//"), text.find("/*"));
+				if(at == std::string_view::npos || (!inComment && text.substr(at, 2) == "//")) return;
+				inComment = !inComment;
+				text.remove_prefix(at + 2);
+			}
+		}
+
+		bool Process(Context& context, std::string_view source, const std::filesystem::path& path, uint32_t fileIndex, int depth) {
+			uint32_t lineNumber = 0;
+			// Directives and vars in comments are left alone
+			bool inComment = false;
+			while(!source.empty()) {
+				const size_t newLine = source.find('\n');
+				const std::string_view line = source.substr(0, newLine);
+				source.remove_prefix(newLine == std::string_view::npos ? source.size() : newLine + 1);
+				lineNumber++;
+
+				const std::string_view directive = inComment ? std::string_view{} : TrimStart(line);
+				if(directive.substr(0, 7) == "#pragma" && TrimStart(directive.substr(7)).substr(0, 4) == "once") {
+					// Later includes of this file are skipped, the source itself has no path
+					if(!path.empty()) context.onceFiles.push_back(path.lexically_normal().string());
+					SkipComments(directive, inComment);
+					context.out += '\n';
+					continue;
+				}
+
+				if(directive.substr(0, 8) != "#include") {
+					if(!Substitute(context, line, inComment)) return false;
+					context.out += '\n';
+					continue;
+				}
+
+				const size_t open = directive.find('"');
+				const size_t close = open == std::string_view::npos ? open : directive.find('"', open + 1);
+				if(close == std::string_view::npos) {
+					log::ErrorFrom("ShaderPreprocessor", "Malformed include '", directive, "'");
+					return false;
+				}
+
+				if(depth >= s_MaxIncludeDepth) {
+					log::ErrorFrom("ShaderPreprocessor", "Includes nested too deep, there is probably a cycle at '", directive, "'");
+					return false;
+				}
+
+				SkipComments(directive.substr(close + 1), inComment);
+				const std::string_view name = directive.substr(open + 1, close - open - 1);
+				std::filesystem::path includePath;
+				const std::string* include = FindInclude(name, path, includePath);
+				if(!include) {
+					log::ErrorFrom("ShaderPreprocessor", "Couldn't find include '", name, "'");
+					return false;
+				}
+
+				const std::string key = includePath.lexically_normal().string();
+				if(std::find(context.onceFiles.begin(), context.onceFiles.end(), key) != context.onceFiles.end()) {
+					context.out += '\n';
+					continue;
+				}
+
+				// Keeps line numbers in driver errors pointing at the right file
+				const uint32_t includeIndex = context.nextFileIndex++;
+				context.out += "#line 1 " + std::to_string(includeIndex) + '\n';
+				if(!Process(context, *include, includePath, includeIndex, depth + 1)) return false;
+				context.out += "#line " + std::to_string(lineNumber + 1) + ' ' + std::to_string(fileIndex) + '\n';
+			}
+			return true;
+		}
+
+		// Sorted by name, the map's order isn't stable. Vars that can't be
+		// substituted can't change the output either.
+		VarStrings ToVarStrings(const ShaderVars& vars) {
+			VarStrings strings;
+			strings.reserve(vars.size());
+			for(const auto& [name, value] : vars) {
+				if(auto string = VarToString(value)) strings.emplace_back(name, std::move(*string));
+			}
+			std::sort(strings.begin(), strings.end());
+			return strings;
+		}
+
+		uint64_t PermutationKey(std::string_view source, const VarStrings& vars) {
+			uint64_t hash = HashFNV1a(source);
+			for(const auto& [name, value] : vars) {
+				hash = HashFNV1a(name, hash);
+				hash = HashValueFNV1a('=', hash);
+				hash = HashFNV1a(value, hash);
+				hash = HashValueFNV1a('\0', hash);
+			}
+			return hash;
+		}
+	}
+
+	std::optional<std::string> Preprocess(std::string_view source, const ShaderVars& vars) {
+		VarStrings varStrings = ToVarStrings(vars);
+		const uint64_t key = PermutationKey(source, varStrings);
+
+		std::lock_guard lock(s_State.mutex);
+		auto& permutations = s_State.permutations[key];
+		for(const auto& permutation : permutations) {
+			if(permutation.source == source && permutation.vars == varStrings) {
+				s_State.stats.cacheHits++;
+				return permutation.out;
+			}
+		}
+
+		Context context{ vars, {}, {}, 1 };
+		context.out.reserve(source.size());
+		s_State.stats.preprocessed++;
+		if(!Process(context, source, {}, 0, 0)) {
+			if(permutations.empty()) s_State.permutations.erase(key);
+			return std::nullopt;
+		}
+
+		permutations.push_back(Permutation{ std::string(source), std::move(varStrings), std::move(context.out) });
+		return permutations.back().out;
+	}
+
+	void AddIncludeDirectory(std::string_view path) {
+		std::lock_guard lock(s_State.mutex);
+		s_State.includeDirectories.emplace_back(path);
+		// Includes may resolve to different files now
+		s_State.permutations.clear();
+	}
+
+	void AddIncludeSource(std::string_view name, std::string_view source) {
+		std::lock_guard lock(s_State.mutex);
+		auto [it, added] = s_State.sources.try_emplace(std::string(name), source);
+		if(!added && it->second == source) return;
+		it->second = source;
+		s_State.permutations.clear();
+	}
+
+	void ClearCache() {
+		std::lock_guard lock(s_State.mutex);
+		s_State.files.clear();
+		s_State.permutations.clear();
+	}
+
+	ShaderPreprocessStats Stats() {
+		std::lock_guard lock(s_State.mutex);
+		return s_State.stats;
+	}
+
+	void ResetStats() {
+		std::lock_guard lock(s_State.mutex);
+		s_State.stats = ShaderPreprocessStats{};
+	}
+
+	std::optional<std::string> VarToString(const std::any& value) {
+		const auto floatToString = [](double value, const char* format) {
+			char buffer[32];
+			snprintf(buffer, sizeof(buffer), format, value);
+			std::string string(buffer);
+			// GLSL needs the point to read it as a float
+			if(string.find_first_of(".eEn") == std::string::npos) string += ".0";
+			return string;
+		};
+
+		const auto& type = value.type();
+		if(type == typeid(int32_t)) return std::to_string(std::any_cast<int32_t>(value));
+		if(type == typeid(int64_t)) return std::to_string(std::any_cast<int64_t>(value));
+		if(type == typeid(uint32_t)) return std::to_string(std::any_cast<uint32_t>(value)) + 'u';
+		if(type == typeid(uint64_t)) return std::to_string(std::any_cast<uint64_t>(value)) + 'u';
+		if(type == typeid(float)) return floatToString(std::any_cast<float>(value), "%.9g");
+		if(type == typeid(double)) return floatToString(std::any_cast<double>(value), "%.17g");
+		if(type == typeid(bool)) return std::string(std::any_cast<bool>(value) ? "true" : "false");
+		if(type == typeid(std::string)) return std::any_cast<const std::string&>(value);
+		if(type == typeid(std::string_view)) return std::string(std::any_cast<std::string_view>(value));
+		if(type == typeid(const char*)) return std::string(std::any_cast<const char*>(value));
+		return std::nullopt;
+	}
+}
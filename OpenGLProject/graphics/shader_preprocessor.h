@@ -0,0 +1,60 @@
+#pragma once
+
+#include <any>
+#include <string>
+#include <optional>
+#include <string_view>
+#include <unordered_map>
+
+#include "core.h"
+
+namespace ogl {
+
+	typedef std::unordered_map<std::string, std::any> ShaderVars;
+
+	struct ShaderPreprocessStats {
+		// Sources actually run through the preprocessor
+		size_t preprocessed = 0;
+		// Sources whose permutation was already in the cache
+		size_t cacheHits = 0;
+		// Include files read from disk, each file is only read once
+		size_t includeReads = 0;
+	};
+
+	// glsl runs GLSL sources through a small preprocessor before they are
+	// given to GL:
+	//
+	//   #include "file"  is replaced by the file. Sources added with
+	//                    AddIncludeSource are looked at first, then the
+	//                    directory of the file doing the include and then the
+	//                    include directories. Files with #pragma once are only
+	//                    included once.
+	//   ${NAME}          is replaced by the value of the var NAME. Integers,
+	//                    floats, bools and strings can be used.
+	//
+	// Everything else, including GLSL's own #define, is left for the driver.
+	// Results are cached in memory by the source and the vars, so every unique
+	// permutation of a source is only preprocessed once. Safe to call from any
+	// thread, nothing here touches GL.
+	namespace glsl {
+
+		// Returns the preprocessed source, nullopt if an include or a var is missing
+		std::optional<std::string> Preprocess(std::string_view source, const ShaderVars& vars);
+
+		// Include files are searched for in the directories in the order they were added
+		void AddIncludeDirectory(std::string_view path);
+		// Makes source includable as name without a file on disk, for sources
+		// that are built into the executable
+		void AddIncludeSource(std::string_view name, std::string_view source);
+
+		// Drops every cached permutation and include file, call it when files
+		// on disk change
+		void ClearCache();
+
+		ShaderPreprocessStats Stats();
+		void ResetStats();
+
+		// The text a var is substituted with, nullopt if its type isn't supported
+		std::optional<std::string> VarToString(const std::any& value);
+	}
+}
@@ -1,94 +1,225 @@
-#pragma once
-#include <glad/glad.h>
-#include "util/image.h"
-
-namespace ogl {
-
-	enum class FilterMode : int32_t {
-		Nearest = GL_NEAREST,
-		Linear = GL_LINEAR
-	};
-
-	enum class WrapMode : int32_t {
-		ClampToBorder = GL_CLAMP_TO_BORDER,
-		ClampToEdge = GL_CLAMP_TO_EDGE,
-		Repeat = GL_REPEAT,
-		MirroredRepeat = GL_MIRRORED_REPEAT
-	};
-
-	using texslot_t = uint32_t;
-	inline constexpr texslot_t unassigned_texid = -1U;
-
-	struct TextureAssetParams {
-		bool generateMipMaps;
-		FilterMode mipMapFilterMode;
-		FilterMode filterMode;
-		WrapMode wrapMode;
-	};
-
-	class Texture2D {
-	public:
-		Texture2D(const Texture2D& other) = delete;
-		Texture2D(Texture2D&& other) : m_GlId(other.m_GlId) { other.m_GlId = 0; }
-		~Texture2D() { if(m_GlId) glDeleteTextures(1, &m_GlId); }
-
-		Texture2D(const Image& image, 
-					bool generateMipMaps = true,
-					FilterMode mipMapFilterMode = FilterMode::Linear,
-					FilterMode filterMode = FilterMode::Linear, 
-					WrapMode wrapMode = WrapMode::ClampToBorder) {
-			glGenTextures(1, &m_GlId);
-			glBindTexture(GL_TEXTURE_2D, m_GlId);
-			
-			int32_t minFilterMode;
-			if (generateMipMaps) {
-				if (mipMapFilterMode == FilterMode::Nearest && filterMode == FilterMode::Nearest)
-					minFilterMode = GL_NEAREST_MIPMAP_NEAREST;
-				else if (mipMapFilterMode == FilterMode::Nearest && filterMode == FilterMode::Linear)
-					minFilterMode = GL_LINEAR_MIPMAP_NEAREST;
-				else if (mipMapFilterMode == FilterMode::Linear && filterMode == FilterMode::Nearest)
-					minFilterMode = GL_NEAREST_MIPMAP_LINEAR;
-				else if (mipMapFilterMode == FilterMode::Linear && filterMode == FilterMode::Linear)
-					minFilterMode = GL_LINEAR_MIPMAP_LINEAR;
-				else
-					minFilterMode = GL_LINEAR_MIPMAP_LINEAR;
-			} else { minFilterMode = (int32_t)filterMode; }
-
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, minFilterMode);
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, (int32_t)filterMode);
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, (int32_t)wrapMode);
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, (int32_t)wrapMode);
-
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, image.width, image.height, 0, 
-				GL_RGBA, GL_UNSIGNED_BYTE, (const void*) image.data);
-			if(generateMipMaps) glGenerateMipmap(GL_TEXTURE_2D);
-
-		}
-
-		void set_texid(texslot_t id) const {
-			glActiveTexture(GL_TEXTURE0 + id);
-			glBindTexture(GL_TEXTURE_2D, m_GlId);
-		}
-
-		void bind() { glBindTexture(GL_TEXTURE_2D, m_GlId); }
-
-		uint32_t get_renderer_id() const {
-			return m_GlId;
-		}
-
-		/* ASSET CODE */
-
-		using AssetParams = TextureAssetParams;
-
-		static std::optional<Texture2D> construct_asset(const std::string& path, AssetParams params) {
-			if(auto image = Image::open(path.c_str())) {
-				Texture2D texture{*image, params.generateMipMaps, params.mipMapFilterMode, params.filterMode, params.wrapMode};
-			}
-
-			return std::nullopt;
-		}
-
-	private:
-		uint32_t m_GlId;
-	};
-}
+#pragma once
+#include <filesystem>
+#include <glad/glad.h>
+#include "util/image.h"
+#include "util/texture_file.h"
+#include "util/block_compression.h"
+#include "graphics/gl_state.h"
+
+namespace ogl {
+
+	enum class FilterMode : int32_t {
+		Nearest = GL_NEAREST,
+		Linear = GL_LINEAR
+	};
+
+	enum class WrapMode : int32_t {
+		ClampToBorder = GL_CLAMP_TO_BORDER,
+		ClampToEdge = GL_CLAMP_TO_EDGE,
+		Repeat = GL_REPEAT,
+		MirroredRepeat = GL_MIRRORED_REPEAT
+	};
+
+	using texslot_t = uint32_t;
+	inline constexpr texslot_t unassigned_texid = -1U;
+
+	struct TextureAssetParams {
+		bool generateMipMaps;
+		FilterMode mipMapFilterMode;
+		FilterMode filterMode;
+		WrapMode wrapMode;
+	};
+
+	class TextureResidency;
+	// Records that a streamed texture was bound, defined with TextureResidency
+	void MarkTextureUsed(TextureResidency& residency, uint32_t index);
+
+	class Texture2D {
+	public:
+		Texture2D(const Texture2D& other) = delete;
+		Texture2D(Texture2D&& other) 
+			: m_GlId(other.m_GlId), m_MemorySize(other.m_MemorySize), 
+			m_Residency(other.m_Residency), m_ResidencyIndex(other.m_ResidencyIndex) { 
+			other.m_GlId = 0; 
+			other.m_Residency = nullptr;
+		}
+		~Texture2D() { 
+			// A streamed texture's id belongs to the residency manager
+			if(!m_GlId || m_Residency) return;
+			glDeleteTextures(1, &m_GlId);
+			glstate::TextureDeleted(m_GlId);
+		}
+
+		// Takes an Image or a view of part of one, only the viewed pixels are uploaded
+		Texture2D(const ImageView& image, 
+					bool generateMipMaps = true,
+					FilterMode mipMapFilterMode = FilterMode::Linear,
+					FilterMode filterMode = FilterMode::Linear, 
+					WrapMode wrapMode = WrapMode::ClampToBorder) {
+			create(generateMipMaps, mipMapFilterMode, filterMode, wrapMode);
+
+			// Rows of a sub view are further apart than its width
+			if(!image.is_contiguous()) glPixelStorei(GL_UNPACK_ROW_LENGTH, image.stride);
+			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, image.width, image.height, 0, 
+				GL_RGBA, GL_UNSIGNED_BYTE, (const void*) image.data);
+			if(!image.is_contiguous()) glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+			if(generateMipMaps) glGenerateMipmap(GL_TEXTURE_2D);
+
+			// A full mip chain adds a third on top of the base level
+			m_MemorySize = (size_t)image.width * image.height * 4;
+			if(generateMipMaps) m_MemorySize += m_MemorySize / 3;
+		}
+
+		// Uploads a single level that stays block compressed in VRAM
+		Texture2D(const CompressedImage& image,
+					FilterMode filterMode = FilterMode::Linear, 
+					WrapMode wrapMode = WrapMode::ClampToBorder,
+					bool srgb = false) {
+			create(false, FilterMode::Linear, filterMode, wrapMode);
+			upload_compressed(0, image.format, srgb, image.width, image.height, image.data.data(), image.data.size());
+		}
+
+		// Uploads every level stored in the file straight from its mapping.
+		// Mips are only sampled if the file has them, none are generated.
+		// Levels before firstLevel are skipped, giving a smaller texture.
+		Texture2D(const TextureFile& file,
+					FilterMode mipMapFilterMode = FilterMode::Linear,
+					FilterMode filterMode = FilterMode::Linear, 
+					WrapMode wrapMode = WrapMode::ClampToBorder,
+					uint32_t firstLevel = 0) {
+			OGL_ASSERT(firstLevel < file.level_count(), "First level is past the end of the texture file");
+			const uint32_t levelCount = file.level_count() - firstLevel;
+			create(levelCount > 1, mipMapFilterMode, filterMode, wrapMode);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, (int32_t)levelCount - 1);
+
+			// Sampling an sRGB format decodes to linear before filtering
+			const int32_t internalFormat = file.is_srgb() ? GL_SRGB8_ALPHA8 : GL_RGBA8;
+
+			for(uint32_t i = 0; i < levelCount; i++) {
+				const auto level = file.level(firstLevel + i);
+				if(IsBlockCompressed(file.format())) {
+					upload_compressed((int32_t)i, ToBlockFormat(file.format()), file.is_srgb(), 
+						(int32_t)level.width, (int32_t)level.height, level.data, level.size);
+					continue;
+				}
+				glTexImage2D(GL_TEXTURE_2D, (int32_t)i, internalFormat, (int32_t)level.width, (int32_t)level.height, 0,
+					GL_RGBA, GL_UNSIGNED_BYTE, (const void*) level.data);
+				m_MemorySize += level.size;
+			}
+		}
+
+		void set_texid(texslot_t id) const { 
+			mark_used();
+			glstate::BindTextureUnit(id, m_GlId); 
+		}
+
+		// Tells a TextureResidency the texture is drawn this frame, so it is
+		// loaded if it isn't resident and not evicted while in use. set_texid
+		// does this, anything that binds the id some other way (e.g. a
+		// RenderQueue) has to call it itself. Does nothing for other textures.
+		void mark_used() const {
+			if(m_Residency) MarkTextureUsed(*m_Residency, m_ResidencyIndex);
+		}
+
+		void bind() { glstate::BindTexture(m_GlId); }
+
+		uint32_t get_renderer_id() const {
+			return m_GlId;
+		}
+
+		// Bytes of texture data uploaded, mips included. Drivers may pad
+		// this, but it is what the texture costs in VRAM to within that.
+		size_t memory_size() const { return m_MemorySize; }
+
+		/* ASSET CODE */
+
+		using AssetParams = TextureAssetParams;
+
+		static std::optional<Texture2D> construct_asset(const std::string& path, AssetParams params) {
+			// Baked files already hold their mips, generateMipMaps doesn't apply
+			if(std::filesystem::path(path).extension() == texture_file_extension) {
+				if(auto file = TextureFile::open(path.c_str()))
+					return Texture2D{*file, params.mipMapFilterMode, params.filterMode, params.wrapMode};
+				return std::nullopt;
+			}
+
+			if(auto image = Image::open(path.c_str())) {
+				return Texture2D{*image, params.generateMipMaps, params.mipMapFilterMode, params.filterMode, params.wrapMode};
+			}
+
+			return std::nullopt;
+		}
+
+	private:
+		friend TextureResidency;
+
+		// The handle TextureResidency gives out, it shows another texture's id
+		Texture2D() : m_GlId(0) {}
+
+		// Generates and binds the texture and sets its sampling parameters
+		void create(bool mipMapped, FilterMode mipMapFilterMode, FilterMode filterMode, WrapMode wrapMode) {
+			glGenTextures(1, &m_GlId);
+			glstate::BindTexture(m_GlId);
+			
+			int32_t minFilterMode;
+			if (mipMapped) {
+				if (mipMapFilterMode == FilterMode::Nearest && filterMode == FilterMode::Nearest)
+					minFilterMode = GL_NEAREST_MIPMAP_NEAREST;
+				else if (mipMapFilterMode == FilterMode::Nearest && filterMode == FilterMode::Linear)
+					minFilterMode = GL_LINEAR_MIPMAP_NEAREST;
+				else if (mipMapFilterMode == FilterMode::Linear && filterMode == FilterMode::Nearest)
+					minFilterMode = GL_NEAREST_MIPMAP_LINEAR;
+				else if (mipMapFilterMode == FilterMode::Linear && filterMode == FilterMode::Linear)
+					minFilterMode = GL_LINEAR_MIPMAP_LINEAR;
+				else
+					minFilterMode = GL_LINEAR_MIPMAP_LINEAR;
+			} else { minFilterMode = (int32_t)filterMode; }
+
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, minFilterMode);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, (int32_t)filterMode);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, (int32_t)wrapMode);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, (int32_t)wrapMode);
+		}
+
+		// The GL format for a block format, or 0 if the driver can't sample it
+		static int32_t CompressedInternalFormat(BlockFormat format, bool srgb) {
+			switch(format) {
+				case BlockFormat::BC1:
+				case BlockFormat::BC3:
+					if(!GLAD_GL_EXT_texture_compression_s3tc || (srgb && !GLAD_GL_EXT_texture_sRGB)) return 0;
+					if(format == BlockFormat::BC1) return srgb ? GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT : GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+					return srgb ? GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT : GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+				case BlockFormat::BC7:
+					if(!GLAD_GL_VERSION_4_2) return 0;
+					return srgb ? GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM : GL_COMPRESSED_RGBA_BPTC_UNORM;
+			}
+			return 0;
+		}
+
+		void upload_compressed(int32_t level, BlockFormat format, bool srgb, int32_t width, int32_t height, const uint8_t* data, size_t size) {
+			if(const int32_t internalFormat = CompressedInternalFormat(format, srgb)) {
+				glCompressedTexImage2D(GL_TEXTURE_2D, level, internalFormat, width, height, 0, (int32_t)size, (const void*) data);
+				m_MemorySize += size;
+				return;
+			}
+
+			// Still loads everywhere, just without the VRAM saving
+			static bool s_Warned = false;
+			if(!s_Warned) {
+				log::WarnFrom("Texture2D", "Driver can't sample block compressed textures, decompressing them on the CPU");
+				s_Warned = true;
+			}
+			const Image decoded = DecompressImage(data, width, height, format);
+			glTexImage2D(GL_TEXTURE_2D, level, srgb ? GL_SRGB8_ALPHA8 : GL_RGBA8, width, height, 0,
+				GL_RGBA, GL_UNSIGNED_BYTE, (const void*) decoded.data);
+			m_MemorySize += (size_t)width * height * 4;
+		}
+
+		uint32_t m_GlId;
+		size_t m_MemorySize = 0;
+
+		// Set on textures handed out by a TextureResidency
+		TextureResidency* m_Residency = nullptr;
+		uint32_t m_ResidencyIndex = 0;
+	};
+}
@@ -0,0 +1,270 @@
+#include "texture_residency.h"
+
+#include <chrono>
+#include <algorithm>
+#include <filesystem>
+
+#include "util/block_compression.h"
+#include "util/image_processing.h"
+
+namespace ogl {
+
+	namespace {
+
+		constexpr size_t s_PageSize = 4096;
+
+		bool IsTextureFile(const std::string& path) {
+			return std::filesystem::path(path).extension() == texture_file_extension;
+		}
+
+		// Reads a byte of every page of the levels, so the upload on the
+		// context thread never waits on the disk
+		void FaultIn(const TextureFile& file) {
+			volatile uint8_t sink = 0;
+			for(uint32_t i = 0; i < file.level_count(); i++) {
+				const auto level = file.level(i);
+				for(size_t offset = 0; offset < level.size; offset += s_PageSize) sink = sink ^ level.data[offset];
+			}
+		}
+
+		// The largest level no bigger than size on either side, level_count if none are
+		uint32_t PlaceholderLevel(const TextureFile& file, uint32_t size) {
+			for(uint32_t i = 0; i < file.level_count(); i++) {
+				const auto level = file.level(i);
+				if(level.width <= size && level.height <= size) return i;
+			}
+			return file.level_count();
+		}
+
+		Image ShrinkToFit(const ImageView& image, uint32_t size) {
+			std::optional<Image> shrunk;
+			ImageView view = image;
+			while((uint32_t)view.width > size || (uint32_t)view.height > size) {
+				shrunk = DownsampleHalf(view);
+				view = shrunk->view();
+			}
+			return shrunk ? std::move(*shrunk) : Image(image);
+		}
+
+		// A placeholder for a file whose mips don't go small enough, made
+		// from its smallest level
+		Image ShrinkToFit(const TextureFile& file, uint32_t size) {
+			const auto level = file.level(file.level_count() - 1);
+			if(IsBlockCompressed(file.format()))
+				return ShrinkToFit(DecompressImage(level.data, (int)level.width, (int)level.height, ToBlockFormat(file.format())), size);
+			return ShrinkToFit(ImageView((Image::pixel_t*)level.data, (int)level.width, (int)level.height), size);
+		}
+	}
+
+	void MarkTextureUsed(TextureResidency& residency, uint32_t index) { residency.touch(index); }
+
+	TextureResidency::TextureResidency(const Settings& settings)
+		: m_Settings(settings), m_Pool(settings.loaderThreads) {}
+
+	TextureResidency::~TextureResidency() {
+		OGL_ASSERT(m_LiveEntries == 0, "Textures from a TextureResidency outlived it");
+	}
+
+	std::shared_ptr<Texture2D> TextureResidency::load(const std::string& path, const TextureAssetParams& params) {
+		uint32_t index;
+		if(!m_FreeEntries.empty()) {
+			index = m_FreeEntries.back();
+			m_FreeEntries.pop_back();
+		} else {
+			index = (uint32_t)m_Entries.size();
+			m_Entries.emplace_back();
+		}
+
+		Entry& entry = m_Entries[index];
+		entry.path = path;
+		entry.params = params;
+		entry.state = State::Evicted;
+		entry.lastUsedFrame = 0;
+		entry.placeholderIsBlank = true;
+
+		// Every texture gets a placeholder of its own, renderers tell
+		// textures apart by their ids
+		Image blank(1, 1);
+		blank.data[0] = m_Settings.placeholderColour;
+		entry.placeholder.emplace(blank, false, params.mipMapFilterMode, params.filterMode, params.wrapMode);
+		m_PlaceholderBytes += entry.placeholder->memory_size();
+
+		entry.handle.reset(new Texture2D());
+		entry.handle->m_Residency = this;
+		entry.handle->m_ResidencyIndex = index;
+		show(entry, *entry.placeholder);
+		m_LiveEntries++;
+
+		// The handle is owned by the entry, the last reference only releases it
+		return std::shared_ptr<Texture2D>(entry.handle.get(), [this, index](Texture2D*) { release(index); });
+	}
+
+	void TextureResidency::update() {
+		m_Frame++;
+
+		size_t uploaded = 0;
+		for(size_t i = 0; i < m_Loading.size();) {
+			Entry& entry = m_Entries[m_Loading[i]];
+			if(uploaded >= m_Settings.maxUploadBytesPerUpdate
+				|| entry.pending.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+				i++;
+				continue;
+			}
+
+			uploaded += finish_load(entry, entry.pending.get());
+			m_Loading[i] = m_Loading.back();
+			m_Loading.pop_back();
+		}
+
+		evict_to_budget();
+	}
+
+	TextureResidency::Stats TextureResidency::stats() const {
+		Stats stats = m_Stats;
+		stats.residentBytes = m_ResidentBytes;
+		stats.placeholderBytes = m_PlaceholderBytes;
+		stats.residentTextures = m_ResidentTextures;
+		return stats;
+	}
+
+	void TextureResidency::reset_stats() { m_Stats = Stats{}; }
+
+	void TextureResidency::touch(uint32_t index) {
+		Entry& entry = m_Entries[index];
+		entry.lastUsedFrame = m_Frame;
+
+		if(entry.state == State::Resident) {
+			m_Stats.hits++;
+			return;
+		}
+
+		m_Stats.misses++;
+		if(entry.state == State::Evicted) request_load(index);
+	}
+
+	void TextureResidency::release(uint32_t index) {
+		Entry& entry = m_Entries[index];
+
+		// A load in flight still finishes, its result is dropped
+		if(entry.state == State::Loading) {
+			m_Loading.erase(std::find(m_Loading.begin(), m_Loading.end(), index));
+			entry.pending = {};
+		}
+
+		if(entry.full) {
+			m_ResidentBytes -= entry.full->memory_size();
+			m_ResidentTextures--;
+			entry.full.reset();
+		}
+
+		m_PlaceholderBytes -= entry.placeholder->memory_size();
+		entry.placeholder.reset();
+		entry.handle.reset();
+		entry.file.reset();
+		entry.path.clear();
+		entry.state = State::Evicted;
+
+		m_FreeEntries.push_back(index);
+		m_LiveEntries--;
+	}
+
+	void TextureResidency::request_load(uint32_t index) {
+		Entry& entry = m_Entries[index];
+		entry.state = State::Loading;
+
+		// The job only gets copies, entries can move while it runs
+		entry.pending = m_Pool.submit([path = entry.path, file = entry.file,
+			wantPlaceholder = entry.placeholderIsBlank, size = m_Settings.placeholderSize]() mutable {
+			LoadResult result;
+			if(IsTextureFile(path)) {
+				if(!file) {
+					auto opened = TextureFile::open(path.c_str());
+					if(!opened) return result;
+					file = std::make_shared<const TextureFile>(std::move(*opened));
+				}
+				FaultIn(*file);
+				if(wantPlaceholder && PlaceholderLevel(*file, size) == file->level_count()) result.placeholder = ShrinkToFit(*file, size);
+				result.file = std::move(file);
+			} else {
+				result.image = Image::open(path.c_str());
+				if(result.image && wantPlaceholder) result.placeholder = ShrinkToFit(*result.image, size);
+			}
+			return result;
+		});
+		m_Loading.push_back(index);
+	}
+
+	size_t TextureResidency::finish_load(Entry& entry, LoadResult result) {
+		if(!result.file && !result.image) {
+			log::ErrorFrom("TextureResidency", "Failed to load '", entry.path, "', keeping its placeholder");
+			entry.state = State::Failed;
+			return 0;
+		}
+
+		const auto& params = entry.params;
+		if(result.file) {
+			entry.file = result.file;
+			entry.full.emplace(*result.file, params.mipMapFilterMode, params.filterMode, params.wrapMode);
+		} else {
+			entry.full.emplace(*result.image, params.generateMipMaps, params.mipMapFilterMode, params.filterMode, params.wrapMode);
+		}
+
+		// The first load replaces the blank placeholder with the texture's smallest mips
+		if(entry.placeholderIsBlank) {
+			m_PlaceholderBytes -= entry.placeholder->memory_size();
+			entry.placeholder.reset();
+			if(result.placeholder) {
+				entry.placeholder.emplace(*result.placeholder, true, params.mipMapFilterMode, params.filterMode, params.wrapMode);
+			} else {
+				entry.placeholder.emplace(*result.file, params.mipMapFilterMode, params.filterMode, params.wrapMode,
+					PlaceholderLevel(*result.file, m_Settings.placeholderSize));
+			}
+			m_PlaceholderBytes += entry.placeholder->memory_size();
+			entry.placeholderIsBlank = false;
+		}
+
+		show(entry, *entry.full);
+		entry.state = State::Resident;
+
+		const size_t bytes = entry.full->memory_size();
+		m_ResidentBytes += bytes;
+		m_ResidentTextures++;
+		m_Stats.loads++;
+		m_Stats.uploadBytes += bytes;
+		return bytes;
+	}
+
+	void TextureResidency::evict(Entry& entry) {
+		show(entry, *entry.placeholder);
+		m_ResidentBytes -= entry.full->memory_size();
+		m_ResidentTextures--;
+		entry.full.reset();
+		entry.state = State::Evicted;
+		m_Stats.evictions++;
+	}
+
+	void TextureResidency::evict_to_budget() {
+		if(m_ResidentBytes <= m_Settings.budgetBytes) return;
+
+		// Anything used last frame is likely to be drawn again this frame
+		std::vector<uint32_t> candidates;
+		for(uint32_t i = 0; i < (uint32_t)m_Entries.size(); i++) {
+			const Entry& entry = m_Entries[i];
+			if(entry.state == State::Resident && entry.lastUsedFrame + 1 < m_Frame) candidates.push_back(i);
+		}
+
+		std::sort(candidates.begin(), candidates.end(), [this](uint32_t a, uint32_t b) {
+			return m_Entries[a].lastUsedFrame < m_Entries[b].lastUsedFrame;
+		});
+
+		for(uint32_t index : candidates) {
+			if(m_ResidentBytes <= m_Settings.budgetBytes) break;
+			evict(m_Entries[index]);
+		}
+	}
+
+	void TextureResidency::show(Entry& entry, const Texture2D& texture) {
+		entry.handle->m_GlId = texture.m_GlId;
+		entry.handle->m_MemorySize = texture.m_MemorySize;
+	}
+}
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <future>
+#include <optional>
+
+#include "core.h"
+#include "graphics/texture.h"
+#include "util/image.h"
+#include "util/texture_file.h"
+#include "util/thread_pool.h"
+
+namespace ogl {
+
+	struct TextureResidencySettings {
+		// Bytes of full resolution textures kept resident. Textures used in
+		// the last frame are never evicted, so a frame that needs more than
+		// this goes over it until they stop being used.
+		size_t budgetBytes = 256 * 1024 * 1024;
+		// Placeholders are the largest mip no bigger than this on either side
+		uint32_t placeholderSize = 16;
+		// Finished loads past this many bytes wait for the next update, at
+		// least one is always uploaded
+		size_t maxUploadBytesPerUpdate = 16 * 1024 * 1024;
+		// Shown until a texture is first loaded
+		Image::pixel_t placeholderColour = { 128, 128, 128, 255 };
+		// 0 starts one thread per hardware thread, leaving one for the caller
+		size_t loaderThreads = 0;
+	};
+
+	struct TextureResidencyStats {
+		// Binds of a texture while it was resident, and while its
+		// placeholder was showing instead
+		size_t hits = 0;
+		size_t misses = 0;
+		size_t loads = 0;
+		size_t evictions = 0;
+		// Bytes uploaded by finished loads
+		size_t uploadBytes = 0;
+
+		// Current totals, not reset by reset_stats
+		size_t residentBytes = 0;
+		size_t placeholderBytes = 0;
+		size_t residentTextures = 0;
+
+		float hit_rate() const { return hits + misses ? (float)hits / (float)(hits + misses) : 1.0f; }
+	};
+
+	// TextureResidency streams textures in and out of VRAM to stay within a
+	// budget. It hands out Texture2Ds that can be used like any other, but
+	// the GL texture behind them changes: the full texture while it is
+	// resident, and a tiny placeholder made from its smallest mips while it
+	// isn't. Renderers look the id up on every batch, so the swap is seen
+	// the next time a texture is batched.
+	//
+	// Every bind (set_texid, or mark_used for textures bound through a
+	// RenderQueue) marks the texture as used that frame. A texture
+	// that is used while not resident is loaded on a worker thread, from
+	// its mapping for texture files and decoded again for anything else.
+	// update uploads finished loads and then evicts the textures that have
+	// gone unused the longest until the budget is met.
+	//
+	// Everything except the loading itself happens on the context thread.
+	class TextureResidency {
+	public:
+		using Settings = TextureResidencySettings;
+		using Stats = TextureResidencyStats;
+
+		explicit TextureResidency(const Settings& settings = {});
+		// Every texture handed out must be released first
+		~TextureResidency();
+
+		TextureResidency(const TextureResidency&) = delete;
+		TextureResidency& operator=(const TextureResidency&) = delete;
+
+		// Returns a texture for path, nothing is read until it is first
+		// used. Texture files (see util/texture_file.h) keep their own mips,
+		// params.generateMipMaps only applies to other images. Releasing
+		// the last reference frees the texture and its placeholder.
+		std::shared_ptr<Texture2D> load(const std::string& path, const TextureAssetParams& params);
+
+		// Call once a frame before drawing
+		void update();
+
+		Stats stats() const;
+		// Counters accumulate until reset_stats is called
+		void reset_stats();
+
+		size_t budget() const { return m_Settings.budgetBytes; }
+		void set_budget(size_t bytes) { m_Settings.budgetBytes = bytes; }
+		uint64_t frame() const { return m_Frame; }
+
+	private:
+		friend void MarkTextureUsed(TextureResidency& residency, uint32_t index);
+
+		enum class State {
+			Evicted,
+			Loading,
+			Resident,
+			// Failed to load, the placeholder stays for good
+			Failed
+		};
+
+		// What a worker hands back, a file or a decoded image
+		struct LoadResult {
+			std::shared_ptr<const TextureFile> file;
+			std::optional<Image> image;
+			std::optional<Image> placeholder;
+		};
+
+		struct Entry {
+			std::string path;
+			TextureAssetParams params;
+			State state = State::Evicted;
+			uint64_t lastUsedFrame = 0;
+			// The texture handed out, it shows full or placeholder
+			std::unique_ptr<Texture2D> handle;
+			std::optional<Texture2D> full;
+			std::optional<Texture2D> placeholder;
+			// The placeholder is still the single colour one
+			bool placeholderIsBlank = true;
+			// Texture files stay mapped between evictions
+			std::shared_ptr<const TextureFile> file;
+			std::future<LoadResult> pending;
+		};
+
+		void touch(uint32_t index);
+		void release(uint32_t index);
+		void request_load(uint32_t index);
+		// Returns the bytes uploaded
+		size_t finish_load(Entry& entry, LoadResult result);
+		void evict(Entry& entry);
+		void evict_to_budget();
+		void show(Entry& entry, const Texture2D& texture);
+
+		Settings m_Settings;
+		ThreadPool m_Pool;
+		std::vector<Entry> m_Entries;
+		std::vector<uint32_t> m_FreeEntries;
+		// Entries with a load in flight
+		std::vector<uint32_t> m_Loading;
+		uint64_t m_Frame = 1;
+		size_t m_LiveEntries = 0;
+		size_t m_ResidentBytes = 0;
+		size_t m_PlaceholderBytes = 0;
+		size_t m_ResidentTextures = 0;
+		Stats m_Stats;
+	};
+}
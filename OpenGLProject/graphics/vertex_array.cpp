@@ -8,18 +8,31 @@ namespace ogl {
 	
 	VertexArray::~VertexArray() {
 		glDeleteVertexArrays(1, &m_GlId);
+		glstate::VertexArrayDeleted(m_GlId);
 	}
 
+	// The element buffer binding is part of the vertex array state, so this
+	// must be the only place index buffers are bound to it
 	void VertexArray::set_index_buffer(IndexBuffer& buffer) {
 			bind();
 			buffer.bind();
-			unbind();
-			buffer.unbind();
 	}
 
-	void VertexArray::draw_indices(uint32_t numIndices, uint32_t offset) {
+	void VertexArray::set_attrib_divisor(uint32_t id, uint32_t divisor) {
 		bind();
-		glDrawElements(GL_TRIANGLES, numIndices, TypeToGLAttributeData<IndexBuffer::index_type>().glEnumType, (const void*)offset);
-		unbind();
+		glVertexAttribDivisor(id, divisor);
+	}
+
+	void VertexArray::draw_indices(uint32_t numIndices, uint32_t offset, int32_t baseVertex) {
+		constexpr GLenum indexType = TypeToGLAttributeData<IndexBuffer::index_type>().glEnumType;
+		bind();
+		if(baseVertex) glDrawElementsBaseVertex(GL_TRIANGLES, numIndices, indexType, (const void*)(size_t)offset, baseVertex);
+		else glDrawElements(GL_TRIANGLES, numIndices, indexType, (const void*)(size_t)offset);
+	}
+
+	void VertexArray::draw_instanced_strip(uint32_t numVertices, uint32_t instanceCount, uint32_t baseInstance) {
+		bind();
+		if(baseInstance) glDrawArraysInstancedBaseInstance(GL_TRIANGLE_STRIP, 0, numVertices, instanceCount, baseInstance);
+		else glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, numVertices, instanceCount);
 	}
 }
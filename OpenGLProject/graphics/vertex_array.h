@@ -4,6 +4,7 @@
 
 #include "core.h"
 #include "buffer.h"
+#include "gl_state.h"
 #include "math/vector.h"
 
 namespace ogl {
@@ -58,11 +59,14 @@ namespace ogl {
 		VertexArray();
 		~VertexArray();
 
-		inline void bind() { glBindVertexArray(m_GlId); }
+		inline void bind() { glstate::BindVertexArray(m_GlId); }
 		inline void unbind() {
-			glBindVertexArray(0); 
+			glstate::BindVertexArray(0); 
 		}
 
+		// Integer attributes are passed to the shader as integers unless 
+		// normalised is set, then they are mapped to [0, 1] (unsigned) or
+		// [-1, 1] (signed) floats.
 		template<typename T>
 		void set_attrib(uint32_t id, 
 						VertexBuffer& buffer,	
@@ -70,8 +74,17 @@ namespace ogl {
 						size_t byte_offset,
 						bool normalised = false); 
 
+		// Sets how often the attribute advances. 0 means once per vertex, N means 
+		// once every N instances. Must be called after set_attrib for that id.
+		void set_attrib_divisor(uint32_t id, uint32_t divisor);
+
 		void set_index_buffer(IndexBuffer& buffer);
-		void draw_indices(uint32_t numIndices, uint32_t offset);
+		// baseVertex is added to every index, which lets one index buffer be
+		// reused for vertices stored anywhere in the vertex buffer.
+		void draw_indices(uint32_t numIndices, uint32_t offset, int32_t baseVertex = 0);
+		// Draws instanceCount instances of a triangle strip made of numVertices 
+		// vertices. Use gl_VertexID in the shader to tell the vertices apart.
+		void draw_instanced_strip(uint32_t numVertices, uint32_t instanceCount, uint32_t baseInstance = 0);
 
 	private:
 		uint32_t m_GlId;
@@ -83,17 +96,16 @@ namespace ogl {
 		this->bind();
 
 		constexpr auto data = TypeToGLAttributeData<T>();		
+		constexpr bool isInteger = data.glEnumType != GL_FLOAT && data.glEnumType != GL_DOUBLE;
 		GLboolean normal = normalised ? GL_TRUE : GL_FALSE;
 		glEnableVertexAttribArray(id);
 		
-		if constexpr (std::numeric_limits<T>::is_integer) {
+		// Normalised integers are read as floats by the shader
+		if (isInteger && !normalised) {
 			glVertexAttribIPointer(id, data.numComponents, data.glEnumType, byte_stride, (const void*) byte_offset);
 		}
 		else {
 			glVertexAttribPointer(id, data.numComponents, data.glEnumType, normal, byte_stride, (const void*) byte_offset);
 		}
-
-		this->unbind();
-		buffer.unbind();
 	}
 }
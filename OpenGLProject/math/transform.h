@@ -1,11 +1,11 @@
-#pragma once
-#include "vector.h"
-
-namespace ogl {
-
-	struct Transform2D {
-		Vector3f position;
-		float rotation;
-		Vector2f scale;
-	};
+#pragma once
+#include "vector.h"
+
+namespace ogl {
+
+	struct Transform2D {
+		Vector3f position;
+		float rotation;
+		Vector2f scale;
+	};
 }
\ No newline at end of file
@@ -1,11 +1,11 @@
-#pragma once
-#include "core.h"
-
-namespace ogl {
-	
-	struct Entity {
-		
-		size_t m_Index;
-	};
-
-}
+#pragma once
+#include "core.h"
+
+namespace ogl {
+	
+	struct Entity {
+		
+		size_t m_Index;
+	};
+
+}
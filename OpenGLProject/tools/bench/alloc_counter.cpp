@@ -0,0 +1,116 @@
+#include "alloc_counter.h"
+
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#define OGL_BENCH_COUNT_ALLOCATIONS
+#endif
+
+namespace ogl::bench {
+
+	namespace {
+		std::atomic<bool> s_Counting = false;
+		std::atomic<size_t> s_Allocations = 0;
+		std::atomic<size_t> s_LargeAllocations = 0;
+		std::atomic<size_t> s_AllocatedBytes = 0;
+		// Signed, blocks allocated before counting started can be freed during it
+		std::atomic<int64_t> s_LiveBytes = 0;
+		std::atomic<int64_t> s_PeakBytes = 0;
+
+		constexpr size_t s_LargeAllocation = 1024 * 1024;
+
+		[[maybe_unused]] void OnAllocate(size_t size) {
+			if(!s_Counting.load(std::memory_order_relaxed)) return;
+			s_Allocations++;
+			if(size >= s_LargeAllocation) s_LargeAllocations++;
+			s_AllocatedBytes += size;
+
+			const int64_t live = s_LiveBytes += (int64_t)size;
+			int64_t peak = s_PeakBytes.load();
+			while(live > peak && !s_PeakBytes.compare_exchange_weak(peak, live)) {}
+		}
+
+		[[maybe_unused]] void OnFree(size_t size) {
+			if(!s_Counting.load(std::memory_order_relaxed)) return;
+			s_LiveBytes -= (int64_t)size;
+		}
+	}
+
+	bool AllocationCountingSupported() {
+#ifdef OGL_BENCH_COUNT_ALLOCATIONS
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	void StartCountingAllocations() {
+		s_Allocations = 0;
+		s_LargeAllocations = 0;
+		s_AllocatedBytes = 0;
+		s_LiveBytes = 0;
+		s_PeakBytes = 0;
+		s_Counting = true;
+	}
+
+	AllocationStats StopCountingAllocations() {
+		s_Counting = false;
+		return AllocationStats{ s_Allocations, s_LargeAllocations, s_AllocatedBytes, (size_t)s_PeakBytes.load() };
+	}
+}
+
+#ifdef OGL_BENCH_COUNT_ALLOCATIONS
+// glibc's own entry points, the replacements below forward to them
+extern "C" {
+	void* __libc_malloc(size_t size);
+	void* __libc_calloc(size_t count, size_t size);
+	void* __libc_realloc(void* ptr, size_t size);
+	void* __libc_memalign(size_t alignment, size_t size);
+	void __libc_free(void* ptr);
+
+	void* malloc(size_t size) {
+		void* ptr = __libc_malloc(size);
+		if(ptr) ogl::bench::OnAllocate(malloc_usable_size(ptr));
+		return ptr;
+	}
+
+	void* calloc(size_t count, size_t size) {
+		void* ptr = __libc_calloc(count, size);
+		if(ptr) ogl::bench::OnAllocate(malloc_usable_size(ptr));
+		return ptr;
+	}
+
+	void* realloc(void* ptr, size_t size) {
+		const size_t oldSize = ptr ? malloc_usable_size(ptr) : 0;
+		void* result = __libc_realloc(ptr, size);
+		if(result || !size) ogl::bench::OnFree(oldSize);
+		if(result) ogl::bench::OnAllocate(malloc_usable_size(result));
+		return result;
+	}
+
+	// Aligned allocations are counted too, they are freed with free
+	void* memalign(size_t alignment, size_t size) {
+		void* ptr = __libc_memalign(alignment, size);
+		if(ptr) ogl::bench::OnAllocate(malloc_usable_size(ptr));
+		return ptr;
+	}
+
+	void* aligned_alloc(size_t alignment, size_t size) { return memalign(alignment, size); }
+
+	int posix_memalign(void** out, size_t alignment, size_t size) {
+		if(alignment % sizeof(void*) != 0 || (alignment & (alignment - 1)) != 0) return EINVAL;
+		void* ptr = memalign(alignment, size);
+		if(!ptr) return ENOMEM;
+		*out = ptr;
+		return 0;
+	}
+
+	void free(void* ptr) {
+		if(ptr) ogl::bench::OnFree(malloc_usable_size(ptr));
+		__libc_free(ptr);
+	}
+}
+#endif
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "core.h"
+
+namespace ogl::bench {
+
+	struct AllocationStats {
+		size_t allocations = 0;
+		// Allocations of at least 1 MB, i.e. the ones holding pixels
+		size_t largeAllocations = 0;
+		size_t allocatedBytes = 0;
+		// Most bytes allocated and not yet freed at any point, relative to
+		// when counting started
+		size_t peakBytes = 0;
+	};
+
+	// Counts every malloc (and so every new) made while counting, on any
+	// thread. Works by replacing malloc, which is only done with glibc,
+	// elsewhere nothing is counted.
+	bool AllocationCountingSupported();
+	void StartCountingAllocations();
+	AllocationStats StopCountingAllocations();
+}
@@ -0,0 +1,116 @@
+#include "bench.h"
+
+#include <random>
+
+#include "assets/asset_manager.h"
+
+namespace ogl::bench {
+
+	namespace {
+
+		struct BenchSprite {
+			int value;
+			static std::optional<BenchSprite> construct_asset(const std::string& path, int value) {
+				if(path.empty()) return std::nullopt;
+				return BenchSprite{ value };
+			}
+		};
+
+		struct BenchSound {
+			float length;
+			static std::optional<BenchSound> construct_asset(const std::string&) { return BenchSound{ 1.0f }; }
+		};
+
+		// The map AssetManager used to hold, with the hash it was missing so it can run
+		struct NameTypeHash {
+			size_t operator()(const std::pair<std::string, int>& key) const {
+				return std::hash<std::string>()(key.first) ^ ((size_t)key.second * 0x9e3779b97f4a7c15ull);
+			}
+		};
+		using NameTypeMap = std::unordered_map<std::pair<std::string, int>, void*, NameTypeHash>;
+	}
+
+	OGL_BENCH(asset_manager, "Checks handle lifetimes and times 2M lookups by handle, by name and through the old name map") {
+		auto& assets = AssetManager::instance();
+
+		{
+			auto hero = assets.create<BenchSprite>("hero", "hero.png", 5);
+			OGL_CHECK(hero && hero->get().value == 5 && hero->name() == "hero");
+			auto again = assets.create<BenchSprite>("hero", "other.png", 9);
+			OGL_CHECK(again && hero && *again == *hero && again->get().value == 5, "create with a taken name didn't return the existing asset");
+			OGL_CHECK(!assets.create<BenchSprite>("broken", "", 1), "a failed construct_asset made an asset");
+
+			// Names are per type
+			auto sound = assets.create<BenchSound>("hero", "hero.wav");
+			OGL_CHECK(sound && sound->get().length == 1.0f);
+			OGL_CHECK(assets.find<BenchSprite>("hero") == *hero);
+			OGL_CHECK(!assets.find<BenchSprite>("nobody").valid());
+			OGL_CHECK(!AssetHandle<BenchSprite>().valid());
+
+			// Freed handles go stale, even when their slot is reused
+			OGL_CHECK(assets.free(*hero));
+			OGL_CHECK(!hero->valid() && hero->get_ptr() == nullptr && hero->name().empty());
+			OGL_CHECK(!assets.free(*hero), "freed a handle twice");
+			auto villain = assets.create<BenchSprite>("villain", "villain.png", 7);
+			OGL_CHECK(villain && villain->index() == hero->index() && villain->generation() != hero->generation(), "slot wasn't reused with a new generation");
+			OGL_CHECK(!hero->valid() && villain->valid());
+
+			OGL_CHECK(assets.free<BenchSprite>("villain"));
+			OGL_CHECK(assets.free(*sound));
+			OGL_CHECK(assets.size<BenchSprite>() == 0 && assets.size<BenchSound>() == 0);
+		}
+
+		{
+			// Two names that hash the same stay separate assets
+			intern::AssetTable<BenchSprite> table;
+			const uint32_t a = table.insert(42, "a", std::make_unique<BenchSprite>(BenchSprite{ 1 }));
+			const uint32_t b = table.insert(42, "b", std::make_unique<BenchSprite>(BenchSprite{ 2 }));
+			OGL_CHECK(table.find(42, "a") == a && table.find(42, "b") == b && !table.find(42, "c"), "colliding names were mixed up");
+			OGL_CHECK(table.erase(a, table.slot(a).generation));
+			OGL_CHECK(!table.find(42, "a") && table.find(42, "b") == b, "freeing one of two colliding names lost the other");
+		}
+
+		constexpr size_t lookups = 2'000'000;
+		for(size_t count : { (size_t)1000, (size_t)10'000, (size_t)100'000 }) {
+			// Names about as long as real asset paths
+			std::vector<std::string> names;
+			for(size_t i = 0; i < count; i++) names.push_back("assets/textures/sprites/character_" + std::to_string(i) + ".png");
+
+			NameTypeMap old;
+			std::vector<BenchSprite> oldSprites(count);
+			std::vector<AssetHandle<BenchSprite>> handles;
+			for(size_t i = 0; i < count; i++) {
+				oldSprites[i].value = (int)i;
+				old[std::make_pair(names[i], 3)] = &oldSprites[i];
+				handles.push_back(*assets.create<BenchSprite>(names[i], "sprite.png", (int)i));
+			}
+
+			std::mt19937 rng(1);
+			std::vector<uint32_t> order(lookups);
+			for(uint32_t& index : order) index = rng() % count;
+
+			// Summed so the lookups can't be optimised away
+			int64_t oldSum = 0, findSum = 0, handleSum = 0;
+			const double oldMs = TimeBest(3, [&]() {
+				oldSum = 0;
+				for(uint32_t i : order) oldSum += ((BenchSprite*)old.find(std::make_pair(names[i], 3))->second)->value;
+			});
+			const double findMs = TimeBest(3, [&]() {
+				findSum = 0;
+				for(uint32_t i : order) findSum += assets.find<BenchSprite>(names[i]).get().value;
+			});
+			const double handleMs = TimeBest(3, [&]() {
+				handleSum = 0;
+				for(uint32_t i : order) handleSum += handles[i].get_ptr()->value;
+			});
+			OGL_CHECK(oldSum == findSum && findSum == handleSum, "lookups found different assets");
+
+			const auto perLookup = [](double ms) { return ms * 1e6 / lookups; };
+			Report(count, " assets: old map ", perLookup(oldMs), " ns, find ", perLookup(findMs), " ns, get_ptr ", perLookup(handleMs),
+				" ns (", oldMs / handleMs, "x)");
+
+			for(const auto& handle : handles) assets.free(handle);
+			OGL_CHECK(assets.size<BenchSprite>() == 0);
+		}
+	}
+}
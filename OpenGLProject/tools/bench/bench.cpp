@@ -0,0 +1,62 @@
+#include "bench.h"
+
+#include <cstring>
+
+namespace ogl::bench {
+
+	namespace {
+		size_t s_Failures = 0;
+		std::vector<std::string> s_Flags;
+	}
+
+	std::vector<BenchInfo>& Registry() {
+		static std::vector<BenchInfo> registry;
+		return registry;
+	}
+
+	void Fail() { s_Failures++; }
+	size_t FailureCount() { return s_Failures; }
+
+	bool HasFlag(std::string_view flag) {
+		return std::find(s_Flags.begin(), s_Flags.end(), flag) != s_Flags.end();
+	}
+}
+
+int main(int argc, char** argv) {
+	using namespace ogl::bench;
+
+	std::vector<std::string> names;
+	for(int i = 1; i < argc; i++) {
+		if(!strncmp(argv[i], "--", 2)) s_Flags.emplace_back(argv[i]);
+		else names.emplace_back(argv[i]);
+	}
+
+	// Registration order depends on link order, run them by name
+	auto& registry = Registry();
+	std::sort(registry.begin(), registry.end(), [](const BenchInfo& a, const BenchInfo& b) { return strcmp(a.name, b.name) < 0; });
+
+	if(HasFlag("--list")) {
+		for(const auto& bench : registry) ogl::log::Info(bench.name, " - ", bench.description);
+		return 0;
+	}
+
+	size_t run = 0;
+	for(const auto& bench : registry) {
+		if(!names.empty() && std::find(names.begin(), names.end(), bench.name) == names.end()) continue;
+
+		ogl::log::InfoFrom("Bench", "Running ", bench.name, " - ", bench.description);
+		bench.fn();
+		run++;
+	}
+
+	if(run == 0) {
+		ogl::log::ErrorFrom("Bench", "No bench matched, use --list to see them");
+		return 1;
+	}
+
+	if(FailureCount()) {
+		ogl::log::ErrorFrom("Bench", FailureCount(), " checks failed");
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include "core.h"
+#include "log.h"
+#include "assert.h"
+
+// A minimal harness for the benchmark and check executables. Each bench is
+// a function registered with OGL_BENCH, the executable runs all of them or
+// the ones named on the command line:
+//
+//   CPUBench [--list] [name ...]
+//   RenderBench [--list] [--egl] [name ...]
+//
+// Benches print their own results with Report. OGL_CHECK records a failure
+// and carries on, the executable exits with 1 if any check failed.
+
+namespace ogl::bench {
+
+	using BenchFn = void(*)();
+
+	struct BenchInfo {
+		const char* name;
+		const char* description;
+		BenchFn fn;
+	};
+
+	std::vector<BenchInfo>& Registry();
+
+	struct Registrar {
+		Registrar(const char* name, const char* description, BenchFn fn) { Registry().push_back({ name, description, fn }); }
+	};
+
+	void Fail();
+	size_t FailureCount();
+
+	// True if flag was passed on the command line, for options a bench
+	// reads itself (e.g. --egl)
+	bool HasFlag(std::string_view flag);
+
+	using Clock = std::chrono::steady_clock;
+
+	inline double MillisecondsSince(Clock::time_point start) {
+		return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	}
+
+	// The fastest of runs calls of fn in milliseconds, the fastest run is the
+	// one least disturbed by the rest of the machine
+	template<typename Fn>
+	double TimeBest(int runs, Fn&& fn) {
+		double best = 1e30;
+		for(int i = 0; i < runs; i++) {
+			const auto start = Clock::now();
+			fn();
+			best = std::min(best, MillisecondsSince(start));
+		}
+		return best;
+	}
+
+	template<typename ...Args>
+	void Report(Args&& ...args) {
+		log::InfoFrom("Bench", std::forward<Args>(args)...);
+	}
+}
+
+#define OGL_BENCH(name, description) \
+	static void name(); \
+	static ogl::bench::Registrar s_BenchRegistrar_##name(#name, description, name); \
+	static void name()
+
+#define OGL_CHECK_IMPL_NO_MSG(x) if(!(x)) { ogl::log::ErrorFrom("Bench", "Check failed: '" #x "' in ", ogl::assert_internal::filename(__FILE__), ", Line ", __LINE__); ogl::bench::Fail(); }
+#define OGL_CHECK_IMPL_MSG(x, ...) if(!(x)) { ogl::log::ErrorFrom("Bench", "Check failed: '" #x "' (", __VA_ARGS__, ") in ", ogl::assert_internal::filename(__FILE__), ", Line ", __LINE__); ogl::bench::Fail(); }
+// Picks the message version for 2 to 12 arguments
+#define OGL_CHECK_GET_IMPL(a, b, c, d, e, f, g, h, i, j, k, l, macro, ...) macro
+#define OGL_CHECK(...) EXPAND_M(OGL_CHECK_GET_IMPL(__VA_ARGS__, \
+	OGL_CHECK_IMPL_MSG, OGL_CHECK_IMPL_MSG, OGL_CHECK_IMPL_MSG, OGL_CHECK_IMPL_MSG, OGL_CHECK_IMPL_MSG, OGL_CHECK_IMPL_MSG, \
+	OGL_CHECK_IMPL_MSG, OGL_CHECK_IMPL_MSG, OGL_CHECK_IMPL_MSG, OGL_CHECK_IMPL_MSG, OGL_CHECK_IMPL_MSG, OGL_CHECK_IMPL_NO_MSG)(__VA_ARGS__))
@@ -0,0 +1,117 @@
+#include "bench.h"
+
+#include <cmath>
+#include <random>
+#include <algorithm>
+
+#include "util/block_compression.h"
+
+namespace ogl::bench {
+
+	namespace {
+
+		// Flat shapes with soft edges over a transparent background, like a
+		// sprite sheet. Alpha follows the shapes.
+		Image Illustration(int size) {
+			Image image(size, size);
+			for(int y = 0; y < size; y++) {
+				for(int x = 0; x < size; x++) {
+					const float cx = (x % 128) - 64.0f, cy = (y % 128) - 64.0f;
+					const float edge = std::clamp(48.0f - std::sqrt(cx * cx + cy * cy), 0.0f, 1.0f);
+					const uint8_t shade = (x / 128 + y / 128) % 2 ? 220 : 60;
+					image.data[(size_t)y * size + x] = { shade, (uint8_t)(255 - shade), (uint8_t)(x / 2), (uint8_t)(edge * 255.0f) };
+				}
+			}
+			return image;
+		}
+
+		// Smooth gradients under fine noise, opaque, like a screenshot of a scene
+		Image Photo(int size) {
+			Image image(size, size);
+			std::mt19937 rng(1);
+			std::normal_distribution<float> noise(0.0f, 6.0f);
+			for(int y = 0; y < size; y++) {
+				for(int x = 0; x < size; x++) {
+					const float u = (float)x / size, v = (float)y / size;
+					const float r = 128.0f + 100.0f * std::sin(u * 7.0f + v * 3.0f);
+					const float g = 128.0f + 90.0f * std::cos(u * 4.0f - v * 6.0f);
+					const float b = 255.0f * u * v;
+					const auto channel = [&](float value) { return (uint8_t)std::clamp(value + noise(rng), 0.0f, 255.0f); };
+					image.data[(size_t)y * size + x] = { channel(r), channel(g), channel(b), 255 };
+				}
+			}
+			return image;
+		}
+
+		// PSNR over the colour channels and over alpha. Colour is compared
+		// premultiplied, BC1 turns transparent texels black and what colour
+		// they had doesn't matter.
+		std::pair<double, double> PSNR(const Image& a, const Image& b) {
+			double colour = 0.0, alpha = 0.0;
+			for(size_t i = 0; i < (size_t)a.width * a.height; i++) {
+				for(int c = 0; c < 3; c++) {
+					const double d = ((double)a.data[i][c] * a.data[i].w - (double)b.data[i][c] * b.data[i].w) / 255.0;
+					colour += d * d;
+				}
+				const double d = (double)a.data[i].w - b.data[i].w;
+				alpha += d * d;
+			}
+			const double pixels = (double)a.width * a.height;
+			const auto toDecibels = [](double mse) { return mse == 0.0 ? 99.0 : 10.0 * std::log10(255.0 * 255.0 / mse); };
+			return { toDecibels(colour / (pixels * 3.0)), toDecibels(alpha / pixels) };
+		}
+
+		const char* FormatName(BlockFormat format) {
+			switch(format) {
+			case BlockFormat::BC1: return "BC1";
+			case BlockFormat::BC3: return "BC3";
+			case BlockFormat::BC7: return "BC7";
+			}
+			return "?";
+		}
+	}
+
+	OGL_BENCH(block_compression, "Compresses a 512x512 illustration and photo to BC1/BC3/BC7, reports MP/s and PSNR") {
+		const Image illustration = Illustration(512);
+		const Image photo = Photo(512);
+
+		for(BlockFormat format : { BlockFormat::BC1, BlockFormat::BC3, BlockFormat::BC7 }) {
+			double fastPhoto = 0.0;
+			for(CompressionQuality quality : { CompressionQuality::Fast, CompressionQuality::High }) {
+				const char* qualityName = quality == CompressionQuality::Fast ? "fast" : "high";
+
+				CompressedImage compressed;
+				const double ms = TimeBest(3, [&]() { compressed = CompressImage(photo, format, quality); });
+				OGL_CHECK(compressed.data.size() == CompressedSize(format, 512, 512), FormatName(format), " ", qualityName, " wrote ", compressed.data.size(), " bytes");
+				const auto photoPSNR = PSNR(photo, DecompressImage(compressed.data.data(), 512, 512, format));
+
+				const CompressedImage sprites = CompressImage(illustration, format, quality);
+				const auto illustrationPSNR = PSNR(illustration, DecompressImage(sprites.data.data(), 512, 512, format));
+
+				Report(FormatName(format), " ", qualityName, ": ", 512.0 * 512.0 / ms / 1000.0, " MP/s, illustration ",
+					illustrationPSNR.first, " / ", illustrationPSNR.second, " dB, photo ", photoPSNR.first, " dB");
+
+				// High quality never loses to fast overall
+				if(quality == CompressionQuality::Fast) fastPhoto = photoPSNR.first;
+				else OGL_CHECK(photoPSNR.first >= fastPhoto - 0.1, FormatName(format), " high ", photoPSNR.first, " dB, fast ", fastPhoto, " dB");
+				OGL_CHECK(photoPSNR.first > 30.0, FormatName(format), " ", qualityName, " photo ", photoPSNR.first, " dB");
+			}
+		}
+
+		// Odd sizes repeat the edge into the partial blocks
+		const Image odd(photo.view(0, 0, 37, 13));
+		for(BlockFormat format : { BlockFormat::BC1, BlockFormat::BC3, BlockFormat::BC7 }) {
+			const CompressedImage compressed = CompressImage(odd, format, CompressionQuality::High);
+			OGL_CHECK(compressed.data.size() == CompressedSize(format, 37, 13), FormatName(format), " wrote ", compressed.data.size(), " bytes for 37x13");
+			const Image decoded = DecompressImage(compressed.data.data(), 37, 13, format);
+			OGL_CHECK(decoded.width == 37 && decoded.height == 13 && PSNR(odd, decoded).first > 30.0, FormatName(format), " 37x13");
+		}
+
+		// BC1 keeps transparent texels transparent and opaque ones opaque
+		Image cutout(4, 4);
+		for(int i = 0; i < 16; i++) cutout.data[i] = i < 8 ? Image::pixel_t{ 255, 0, 0, 255 } : Image::pixel_t{ 0, 0, 0, 0 };
+		const CompressedImage compressed = CompressImage(cutout, BlockFormat::BC1);
+		const Image decoded = DecompressImage(compressed.data.data(), 4, 4, BlockFormat::BC1);
+		OGL_CHECK(decoded.data[0].w == 255 && decoded.data[0].x > 240 && decoded.data[12].w == 0, "BC1 lost the cutout");
+	}
+}
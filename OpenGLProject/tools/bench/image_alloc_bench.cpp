@@ -0,0 +1,97 @@
+#include "bench.h"
+#include "alloc_counter.h"
+
+#include <filesystem>
+
+#include "util/image.h"
+
+namespace ogl::bench {
+
+	namespace {
+		constexpr size_t s_MB = 1024 * 1024;
+
+		// Smooth enough that stb writes it quickly, 4096x4096 is 64 MB decoded
+		Image PatternImage(int size) {
+			Image image(size, size);
+			for(int y = 0; y < size; y++) {
+				for(int x = 0; x < size; x++) image.data[(size_t)y * size + x] = { (uint8_t)x, (uint8_t)y, (uint8_t)(x ^ y), 255 };
+			}
+			return image;
+		}
+
+		AllocationStats CountLoad(const std::string& path, double& ms) {
+			StartCountingAllocations();
+			const auto start = Clock::now();
+			auto image = Image::open(path.c_str());
+			ms = MillisecondsSince(start);
+			const AllocationStats stats = StopCountingAllocations();
+			OGL_CHECK(image && image->width == 4096 && image->height == 4096, path);
+			return stats;
+		}
+
+		void ReportAllocations(const char* what, const AllocationStats& stats) {
+			Report(what, ": ", stats.allocations, " allocations (", stats.largeAllocations, " >= 1 MB), ",
+				stats.allocatedBytes / s_MB, " MB allocated, peak ", stats.peakBytes / s_MB, " MB");
+		}
+	}
+
+	OGL_BENCH(image_alloc, "Counts the allocations made loading a 4096x4096 image and moving Images around") {
+		if(!AllocationCountingSupported()) {
+			Report("Allocation counting needs glibc, skipped");
+			return;
+		}
+
+		const auto directory = std::filesystem::temp_directory_path() / "ogl_image_alloc_bench";
+		std::filesystem::create_directories(directory);
+		const std::string png = (directory / "image.png").string();
+		const std::string tga = (directory / "image.tga").string();
+		{
+			Image image = PatternImage(4096);
+			OGL_CHECK(image.write(png.c_str()));
+			OGL_CHECK(stbi_write_tga(tga.c_str(), image.width, image.height, 4, image.data));
+		}
+		const size_t imageBytes = (size_t)4096 * 4096 * sizeof(Image::pixel_t);
+
+		// The Image takes stb's buffer. A PNG still needs stb's inflate
+		// output next to the result, so two images are live at the peak.
+		double ms;
+		const AllocationStats pngLoad = CountLoad(png, ms);
+		ReportAllocations("png load", pngLoad);
+		Report("png load: ", ms, " ms");
+		OGL_CHECK(pngLoad.largeAllocations <= 2, pngLoad.largeAllocations, " large allocations");
+		OGL_CHECK(pngLoad.peakBytes < imageBytes * 2 + 4 * s_MB, pngLoad.peakBytes / s_MB, " MB peak");
+
+		// TGA decodes straight into the result, one image and no copy
+		const AllocationStats tgaLoad = CountLoad(tga, ms);
+		ReportAllocations("tga load", tgaLoad);
+		Report("tga load: ", ms, " ms");
+		OGL_CHECK(tgaLoad.largeAllocations == 1, tgaLoad.largeAllocations, " large allocations");
+		OGL_CHECK(tgaLoad.peakBytes < imageBytes + 4 * s_MB, tgaLoad.peakBytes / s_MB, " MB peak");
+
+		{
+			// Growing a vector moves the images, only their own pixels are allocated
+			StartCountingAllocations();
+			{
+				std::vector<Image> images;
+				for(int i = 0; i < 8; i++) images.emplace_back(1024, 1024);
+			}
+			const AllocationStats growth = StopCountingAllocations();
+			ReportAllocations("8 emplace_backs", growth);
+			OGL_CHECK(growth.largeAllocations == 8, growth.largeAllocations, " large allocations");
+
+			// Move assignment takes the pixels, copy assignment copies them once
+			Image a(1024, 1024), b(1024, 1024);
+			StartCountingAllocations();
+			a = std::move(b);
+			const AllocationStats moved = StopCountingAllocations();
+			StartCountingAllocations();
+			b = a;
+			const AllocationStats copied = StopCountingAllocations();
+			OGL_CHECK(moved.allocations == 0, moved.allocations, " allocations");
+			OGL_CHECK(copied.largeAllocations == 1, copied.largeAllocations, " large allocations");
+		}
+
+		std::error_code error;
+		std::filesystem::remove_all(directory, error);
+	}
+}
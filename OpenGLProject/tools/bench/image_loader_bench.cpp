@@ -0,0 +1,76 @@
+#include "bench.h"
+
+#include <thread>
+#include <cstring>
+#include <filesystem>
+
+#include "util/image_loader.h"
+
+namespace ogl::bench {
+
+	namespace {
+
+		// Noisy enough that decoding isn't trivial, but each image is different
+		Image NoiseImage(int size, uint32_t seed) {
+			Image image(size, size);
+			uint32_t state = seed * 2654435761u + 1;
+			for(size_t i = 0; i < (size_t)size * size; i++) {
+				state = state * 1664525u + 1013904223u;
+				const uint8_t noise = (uint8_t)(state >> 28);
+				image.data[i] = { (uint8_t)(i + noise), (uint8_t)((i >> 8) + noise), (uint8_t)seed, 255 };
+			}
+			return image;
+		}
+
+		bool SameImage(const Image& a, const Image& b) {
+			return a.width == b.width && a.height == b.height
+				&& std::memcmp(a.data, b.data, (size_t)a.width * a.height * sizeof(Image::pixel_t)) == 0;
+		}
+	}
+
+	OGL_BENCH(image_loader, "Decodes 2000 256x256 PNGs with Image::open and with ImageLoader, checks they match") {
+		constexpr size_t count = 2000;
+		const auto directory = std::filesystem::temp_directory_path() / "ogl_image_loader_bench";
+		std::filesystem::create_directories(directory);
+
+		std::vector<std::string> paths;
+		for(size_t i = 0; i < count; i++) {
+			paths.push_back((directory / (std::to_string(i) + ".png")).string());
+			if(!std::filesystem::exists(paths.back())) OGL_CHECK(NoiseImage(256, (uint32_t)i).write(paths.back().c_str()), paths.back());
+		}
+
+		std::vector<Image> expected;
+		expected.reserve(count);
+		auto start = Clock::now();
+		for(const std::string& path : paths) {
+			auto image = Image::open(path.c_str());
+			OGL_CHECK(image, path);
+			expected.push_back(image ? std::move(*image) : Image(1, 1));
+		}
+		Report("Image::open: ", count, " images in ", MillisecondsSince(start), " ms");
+
+		std::vector<size_t> threadCounts{ 1, 0 };
+		for(size_t threads : threadCounts) {
+			ImageLoader loader(threads);
+			start = Clock::now();
+			auto pending = loader.load_all(paths);
+			const double queueMs = MillisecondsSince(start);
+
+			size_t mismatched = 0;
+			for(size_t i = 0; i < count; i++) {
+				const std::optional<Image> image = pending[i].get();
+				mismatched += !image || !SameImage(*image, expected[i]);
+			}
+			Report("ImageLoader, ", loader.thread_count(), " threads: ", MillisecondsSince(start), " ms, caller blocked ", queueMs, " ms queueing");
+			OGL_CHECK(mismatched == 0, mismatched, " images differ from Image::open");
+		}
+		Report("hardware threads: ", std::thread::hardware_concurrency());
+
+		// A missing file is a nullopt, not an exception out of get
+		ImageLoader loader(1);
+		OGL_CHECK(!loader.load((directory / "missing.png").string()).get(), "a missing file decoded");
+
+		std::error_code error;
+		std::filesystem::remove_all(directory, error);
+	}
+}
@@ -0,0 +1,161 @@
+#include "bench.h"
+
+#include <random>
+#include <cstring>
+
+#include "util/cpuid.h"
+#include "util/mipmap.h"
+#include "util/image_processing.h"
+
+namespace ogl::bench {
+
+	namespace {
+
+		Image RandomImage(int width, int height, uint32_t seed) {
+			Image image(width, height);
+			std::mt19937 rng(seed);
+			for(size_t i = 0; i < (size_t)width * height; i++) {
+				const uint32_t bits = rng();
+				image.data[i] = { (uint8_t)bits, (uint8_t)(bits >> 8), (uint8_t)(bits >> 16), (uint8_t)(bits >> 24) };
+			}
+			return image;
+		}
+
+		bool SamePixels(const Image::pixel_t* a, const Image::pixel_t* b, size_t count) {
+			return std::memcmp(a, b, count * sizeof(Image::pixel_t)) == 0;
+		}
+
+		// Megapixels of source per second
+		double Throughput(const ImageView& source, double ms) {
+			return (double)source.width * source.height / ms / 1000.0;
+		}
+
+		template<typename Fn>
+		struct Kernel {
+			const char* name;
+			Fn fn;
+			bool supported;
+		};
+	}
+
+	OGL_BENCH(image_processing, "Times the mip, resize, sRGB and premultiply paths on a 2048x2048 image, checks the SIMD kernels match the scalar ones") {
+		const auto& cpu = GetCPUFeatures();
+		const Kernel<BoxDownsampleRowFn> boxKernels[] = {
+			{ "scalar", BoxDownsampleRowScalar, true },
+#ifdef OGL_ARCH_X86
+			{ "sse2", BoxDownsampleRowSSE2, cpu.sse2 },
+			{ "avx2", BoxDownsampleRowAVX2, cpu.avx2 },
+#endif
+		};
+		const Kernel<PremultiplyRowFn> premultiplyKernels[] = {
+			{ "scalar", PremultiplyRowScalar, true },
+#ifdef OGL_ARCH_X86
+			{ "sse2", PremultiplyRowSSE2, cpu.sse2 },
+			{ "avx2", PremultiplyRowAVX2, cpu.avx2 },
+#endif
+		};
+
+		const Image source = RandomImage(2048, 2048, 1);
+
+		{
+			// Every width up to a few vector lengths, so each tail is covered
+			const Image rows = RandomImage(514, 2, 2);
+			for(const auto& kernel : boxKernels) {
+				if(!kernel.supported) continue;
+				size_t mismatched = 0;
+				for(size_t width = 1; width <= 257; width++) {
+					std::vector<Image::pixel_t> expected(width), actual(width);
+					BoxDownsampleRowScalar(rows.data, rows.data + rows.width, expected.data(), width);
+					kernel.fn(rows.data, rows.data + rows.width, actual.data(), width);
+					mismatched += !SamePixels(expected.data(), actual.data(), width);
+				}
+				OGL_CHECK(mismatched == 0, "box ", kernel.name, ", ", mismatched, " widths differ from scalar");
+
+				Image out(source.width / 2, source.height / 2);
+				const double ms = TimeBest(5, [&]() {
+					for(int y = 0; y < out.height; y++) kernel.fn(source.data + (size_t)y * 2 * source.width, source.data + (size_t)(y * 2 + 1) * source.width, out.data + (size_t)y * out.width, out.width);
+				});
+				Report("box halving row, ", kernel.name, ": ", Throughput(source, ms), " MP/s");
+			}
+
+			for(const auto& kernel : premultiplyKernels) {
+				if(!kernel.supported) continue;
+				size_t mismatched = 0;
+				for(size_t width = 1; width <= 257; width++) {
+					std::vector<Image::pixel_t> expected(rows.data, rows.data + width), actual(rows.data, rows.data + width);
+					PremultiplyRowScalar(expected.data(), width);
+					kernel.fn(actual.data(), width);
+					mismatched += !SamePixels(expected.data(), actual.data(), width);
+				}
+				OGL_CHECK(mismatched == 0, "premultiply ", kernel.name, ", ", mismatched, " widths differ from scalar");
+
+				// Exact rounding of c * a / 255 for every pair
+				std::vector<Image::pixel_t> pairs(256 * 256);
+				for(size_t i = 0; i < pairs.size(); i++) pairs[i] = { (uint8_t)i, (uint8_t)(i >> 8), (uint8_t)i, (uint8_t)(i >> 8) };
+				kernel.fn(pairs.data(), pairs.size());
+				size_t wrong = 0;
+				for(size_t i = 0; i < pairs.size(); i++) {
+					const uint32_t c = (uint8_t)i, a = (uint8_t)(i >> 8);
+					wrong += pairs[i].x != (c * a + 127) / 255 || pairs[i].w != a;
+				}
+				OGL_CHECK(wrong == 0, "premultiply ", kernel.name, ", ", wrong, " of 65536 (c, a) pairs rounded wrong");
+
+				Image copy(source);
+				const double ms = TimeBest(5, [&]() { kernel.fn(copy.data, (size_t)copy.width * copy.height); });
+				Report("premultiply row, ", kernel.name, ": ", Throughput(source, ms), " MP/s");
+			}
+		}
+
+		{
+			const ResampleSettings boxLinear{ ResampleFilter::Box, ColourSpace::Linear };
+			const ResampleSettings boxSRGB{ ResampleFilter::Box, ColourSpace::SRGB };
+			const ResampleSettings kaiserLinear{ ResampleFilter::Kaiser, ColourSpace::Linear };
+			const ResampleSettings kaiserSRGB{ ResampleFilter::Kaiser, ColourSpace::SRGB };
+
+			// The fast box path and the general one agree. An odd width
+			// forces the general path without changing the filter.
+			const Image fast = DownsampleHalf(source.view(0, 0, 256, 256), boxLinear);
+			const Image general = Resize(source.view(0, 0, 256, 256), 128, 128, boxLinear);
+			OGL_CHECK(SamePixels(fast.data, general.data, (size_t)128 * 128), "DownsampleHalf's fast box path differs from Resize");
+
+			size_t roundTrips = 0;
+			for(int value = 0; value < 256; value++) roundTrips += LinearToSRGB(SRGBToLinear((uint8_t)value)) == value;
+			OGL_CHECK(roundTrips == 256, 256 - roundTrips, " sRGB values don't round trip");
+
+			// A checker averages to mid grey, 188 in sRGB
+			Image checker(64, 64);
+			for(int y = 0; y < 64; y++) {
+				for(int x = 0; x < 64; x++) checker.data[y * 64 + x] = (x + y) % 2 ? Image::pixel_t{ 255, 255, 255, 255 } : Image::pixel_t{ 0, 0, 0, 255 };
+			}
+			OGL_CHECK(DownsampleHalf(checker, boxLinear).data[0].x == 128, (int)DownsampleHalf(checker, boxLinear).data[0].x);
+			OGL_CHECK(DownsampleHalf(checker, boxSRGB).data[0].x == 188, (int)DownsampleHalf(checker, boxSRGB).data[0].x);
+
+			// Flat images stay flat through every filter and odd size
+			Image flat(37, 23);
+			for(size_t i = 0; i < (size_t)flat.width * flat.height; i++) flat.data[i] = { 200, 100, 50, 150 };
+			size_t notFlat = 0;
+			for(const ResampleSettings& settings : { boxLinear, boxSRGB, kaiserLinear, kaiserSRGB }) {
+				for(const Image& level : BuildMipChain(flat, 0, settings)) {
+					for(size_t i = 0; i < (size_t)level.width * level.height; i++) notFlat += !SamePixels(&level.data[i], flat.data, 1);
+				}
+			}
+			OGL_CHECK(notFlat == 0, notFlat, " pixels of flat mip chains changed");
+
+			Image copy(source);
+			double ms = TimeBest(3, [&]() { PremultiplyAlpha(copy, ColourSpace::SRGB); });
+			Report("PremultiplyAlpha sRGB: ", Throughput(source, ms), " MP/s");
+			ms = TimeBest(5, [&]() { DownsampleHalf(source, boxLinear); });
+			Report("DownsampleHalf box linear: ", Throughput(source, ms), " MP/s");
+			ms = TimeBest(3, [&]() { DownsampleHalf(source, boxSRGB); });
+			Report("DownsampleHalf box sRGB: ", Throughput(source, ms), " MP/s");
+			ms = TimeBest(3, [&]() { DownsampleHalf(source, kaiserLinear); });
+			Report("DownsampleHalf Kaiser linear: ", Throughput(source, ms), " MP/s");
+			ms = TimeBest(3, [&]() { DownsampleHalf(source, kaiserSRGB); });
+			Report("DownsampleHalf Kaiser sRGB: ", Throughput(source, ms), " MP/s");
+			ms = TimeBest(3, [&]() { Resize(source, 1500, 1500, kaiserSRGB); });
+			Report("Resize 2048->1500 Kaiser sRGB: ", 1500.0 * 1500.0 / ms / 1000.0, " output MP/s");
+			ms = TimeBest(3, [&]() { BuildMipChain(source, 0, kaiserSRGB); });
+			Report("BuildMipChain Kaiser sRGB: ", Throughput(source, ms), " MP/s");
+		}
+	}
+}
@@ -0,0 +1,82 @@
+#include "bench.h"
+#include "render_bench.h"
+
+#include <thread>
+
+#include "graphics/2D/instance_renderer.h"
+
+namespace ogl::bench {
+
+	namespace {
+
+		struct Split {
+			const char* name;
+			size_t chunkSize;
+			size_t threads;
+		};
+
+		// Forcing 16 threads splits batches even on a machine with a single
+		// hardware thread, so the chunked writes are always checked
+		const Split s_Splits[] = { { "serial", 0, 0 }, { "parallel", 256, 0 }, { "16 threads", 256, 16 } };
+	}
+
+	OGL_BENCH(parallel_batch, "Times vertex generation from 1k to 1M sprites with and without the parallel chunks and checks both write the same buffer") {
+		BenchGL gl;
+		if(!gl.context()) { Fail(); return; }
+		const GraphicsContext& context = *gl.context();
+
+		const size_t threads = std::thread::hardware_concurrency();
+		Report("hardware threads: ", threads, threads <= 1 ? ", batches are only split when the thread count is forced" : "");
+		if(!gl.headless()) Report("buffer contents are only compared without --egl");
+
+		// Best vertex generation time of 5 frames, and what the last one left
+		// in the renderer's buffer
+		const auto run = [&](SpriteScene& scene, BatchRenderer2DSettings settings, std::vector<uint8_t>& contents) {
+			const RendererSpriteData data = scene.data();
+			BatchRenderer2D renderer(context, settings);
+			double best = 1e30;
+			for(int i = 0; i < 6; i++) {
+				renderer.reset_stats();
+				renderer.process(data, context);
+				renderer.flush(context);
+				gl.finish();
+				if(i) best = std::min(best, renderer.get_stats().vertexTime / 1000.0);
+			}
+			if(gl.headless()) contents = *headless::BufferContents(renderer.get_vertex_buffer_id());
+			return best;
+		};
+
+		for(size_t count : { (size_t)1000, (size_t)10'000, (size_t)100'000, (size_t)1'000'000 }) {
+			SpriteScene scene(count, 4);
+			double ms[3];
+			std::vector<uint8_t> contents[3];
+			for(size_t split = 0; split < 3; split++) {
+				BatchRenderer2DSettings settings;
+				settings.parallelChunkSize = s_Splits[split].chunkSize;
+				settings.parallelThreads = s_Splits[split].threads;
+				ms[split] = run(scene, settings, contents[split]);
+			}
+
+			Report(count, " sprites: serial ", ms[0], " ms, parallel ", ms[1], " ms (", ms[0] / ms[1], "x), 16 threads ", ms[2], " ms");
+			for(size_t split = 1; split < 3 && gl.headless(); split++) {
+				OGL_CHECK(contents[split] == contents[0], s_Splits[split].name, " wrote a different buffer to serial, ", count, " sprites");
+			}
+		}
+
+		// Every mode splits its batches the same way
+		if(!gl.headless()) return;
+		SpriteScene scene(100'000, 4);
+		for(int mode = 0; mode < 3; mode++) {
+			std::vector<uint8_t> contents[2];
+			for(int split = 0; split < 2; split++) {
+				BatchRenderer2DSettings settings;
+				settings.mode = mode == 2 ? SpriteRenderMode::Instanced : SpriteRenderMode::Vertices;
+				settings.packedVertices = mode == 1;
+				settings.parallelChunkSize = split ? 256 : 0;
+				settings.parallelThreads = split ? 16 : 0;
+				run(scene, settings, contents[split]);
+			}
+			OGL_CHECK(contents[0] == contents[1], "mode ", mode, ": 16 threads wrote a different buffer to serial");
+		}
+	}
+}
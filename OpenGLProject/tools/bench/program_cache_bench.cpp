@@ -0,0 +1,102 @@
+#include "bench.h"
+#include "render_bench.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <optional>
+
+#include "graphics/shader_cache.h"
+#include "graphics/2D/instance_renderer.h"
+
+namespace ogl::bench {
+
+	OGL_BENCH(program_cache, "Times renderer startup with no program cache, a cold one and a warm one, run with --egl") {
+		if(!HasFlag("--egl")) {
+			Report("the headless backend has no program binaries, run it with --egl");
+			return;
+		}
+
+		const auto directory = std::filesystem::temp_directory_path() / "ogl_program_cache_bench";
+		std::error_code error;
+		std::filesystem::remove_all(directory, error);
+
+		struct Run {
+			// Creating both renderers, which compiles or loads their programs
+			double createMs;
+			// Their first sprites, which waits for the programs to link and
+			// lets the driver compile whatever it compiles on a first draw
+			double firstDrawMs;
+			ShaderCacheStats stats;
+		};
+
+		// Each run gets a new context, so nothing the driver kept in memory
+		// carries over. Mesa also keeps a shader cache on disk that would hide
+		// compile times from every run after the first, each run points it at
+		// an empty directory. Other drivers ignore this.
+		int runIndex = 0;
+		const auto startup = [&](bool cache) -> std::optional<Run> {
+			const auto driverCache = directory / "driver" / std::to_string(runIndex++);
+			std::filesystem::create_directories(driverCache, error);
+#ifdef _WIN32
+			_putenv_s("MESA_SHADER_CACHE_DIR", driverCache.string().c_str());
+#else
+			setenv("MESA_SHADER_CACHE_DIR", driverCache.string().c_str(), 1);
+#endif
+			BenchGL gl;
+			if(!gl.context()) { Fail(); return std::nullopt; }
+			shadercache::SetDirectory((directory / "programs").string());
+			if(!shadercache::IsEnabled()) {
+				Report("the driver has no program binaries, nothing to time");
+				return std::nullopt;
+			}
+			if(!cache) shadercache::SetDirectory("");
+			shadercache::ResetStats();
+			const GraphicsContext& context = *gl.context();
+			SpriteScene scene(1, 1);
+			const RendererSpriteData data = scene.data();
+
+			Run run;
+			auto start = Clock::now();
+			BatchRenderer2DSettings instanced;
+			instanced.mode = SpriteRenderMode::Instanced;
+			BatchRenderer2D renderers[2] = { { context, BatchRenderer2DSettings{} }, { context, instanced } };
+			gl.finish();
+			run.createMs = MillisecondsSince(start);
+
+			start = Clock::now();
+			for(auto& renderer : renderers) {
+				renderer.process(data, context);
+				renderer.flush(context);
+			}
+			gl.finish();
+			run.firstDrawMs = MillisecondsSince(start);
+
+			run.stats = shadercache::Stats();
+			shadercache::SetDirectory("");
+			return run;
+		};
+
+		constexpr int runs = 5;
+		const char* names[3] = { "no program cache", "cold, storing", "warm" };
+		for(int mode = 0; mode < 3; mode++) {
+			double create[2] = { 1e30, 0.0 }, firstDraw[2] = { 1e30, 0.0 };
+			for(int i = 0; i < runs; i++) {
+				if(mode == 1) std::filesystem::remove_all(directory / "programs", error);
+				const auto run = startup(mode != 0);
+				if(!run) return;
+				create[0] = std::min(create[0], run->createMs);
+				create[1] = std::max(create[1], run->createMs);
+				firstDraw[0] = std::min(firstDraw[0], run->firstDrawMs);
+				firstDraw[1] = std::max(firstDraw[1], run->firstDrawMs);
+
+				const ShaderCacheStats& stats = run->stats;
+				if(mode == 1) OGL_CHECK(stats.hits == 0 && stats.stores == 2, stats.hits, " hits and ", stats.stores, " stores from an empty cache");
+				if(mode == 2) OGL_CHECK(stats.hits == 2 && stats.misses == 0, stats.hits, " hits and ", stats.misses, " misses from a warm cache");
+			}
+			Report(names[mode], ": ", create[0], "-", create[1], " ms to create, ", firstDraw[0], "-", firstDraw[1], " ms to the first draw, over ", runs, " runs");
+		}
+
+		std::filesystem::remove_all(directory, error);
+	}
+}
@@ -0,0 +1,169 @@
+#include "render_bench.h"
+#include "bench.h"
+
+#include <glad/glad.h>
+
+#include "graphics/gl_state.h"
+#include "graphics/shader_cache.h"
+
+#ifdef OGL_BENCH_EGL
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+
+namespace ogl::bench {
+
+	namespace {
+
+#ifdef OGL_BENCH_EGL
+		struct EGLState {
+			EGLDisplay display = EGL_NO_DISPLAY;
+			EGLContext context = EGL_NO_CONTEXT;
+			uint32_t framebuffer = 0;
+			uint32_t renderbuffers[2] = {};
+		};
+		EGLState s_EGL;
+
+		// A surfaceless core context drawing into a 1920x1080 framebuffer of its
+		// own, there is no default one. Set EGL_PLATFORM=surfaceless on machines
+		// without a display.
+		std::optional<GraphicsContext> CreateEGLContext() {
+			s_EGL.display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+			EGLint major, minor;
+			if(s_EGL.display == EGL_NO_DISPLAY || !eglInitialize(s_EGL.display, &major, &minor) || !eglBindAPI(EGL_OPENGL_API)) {
+				log::ErrorFrom("Bench", "Failed to initialise EGL");
+				return std::nullopt;
+			}
+
+			const EGLint attribs[] = {
+				EGL_CONTEXT_MAJOR_VERSION, OGL_TARGET_GL_MAJOR,
+				EGL_CONTEXT_MINOR_VERSION, OGL_TARGET_GL_MINOR,
+				EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+				EGL_NONE
+			};
+			s_EGL.context = eglCreateContext(s_EGL.display, EGL_NO_CONFIG_KHR, EGL_NO_CONTEXT, attribs);
+			if(s_EGL.context == EGL_NO_CONTEXT || !eglMakeCurrent(s_EGL.display, EGL_NO_SURFACE, EGL_NO_SURFACE, s_EGL.context)) {
+				log::ErrorFrom("Bench", "Failed to create a surfaceless GL ", OGL_TARGET_GL_MAJOR, ".", OGL_TARGET_GL_MINOR, " context");
+				eglTerminate(s_EGL.display);
+				return std::nullopt;
+			}
+			if(!gladLoadGLLoader((GLADloadproc)eglGetProcAddress)) {
+				log::ErrorFrom("Bench", "Failed to initialise GLAD");
+				return std::nullopt;
+			}
+			glstate::Invalidate();
+			shadercache::Invalidate();
+			if(GLAD_GL_KHR_parallel_shader_compile) glMaxShaderCompilerThreadsKHR(0xffffffff);
+
+			glGenRenderbuffers(2, s_EGL.renderbuffers);
+			glBindRenderbuffer(GL_RENDERBUFFER, s_EGL.renderbuffers[0]);
+			glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, 1920, 1080);
+			glBindRenderbuffer(GL_RENDERBUFFER, s_EGL.renderbuffers[1]);
+			glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, 1920, 1080);
+			glGenFramebuffers(1, &s_EGL.framebuffer);
+			glBindFramebuffer(GL_FRAMEBUFFER, s_EGL.framebuffer);
+			glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, s_EGL.renderbuffers[0]);
+			glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, s_EGL.renderbuffers[1]);
+			glViewport(0, 0, 1920, 1080);
+
+			int slots, fragSlots;
+			glGetIntegerv(GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS, &slots);
+			glGetIntegerv(GL_MAX_TEXTURE_IMAGE_UNITS, &fragSlots);
+			log::InfoFrom("Bench", "Using EGL, ", (const char*)glGetString(GL_RENDERER));
+
+			return GraphicsContext{
+				/* .GL = */ { OGL_TARGET_GL_MAJOR, OGL_TARGET_GL_MINOR },
+				/* .maxTotalTextureSlots = */ slots,
+				/* .maxFragmentTextureSlots = */ fragSlots,
+				/* .frameBufferWidth = */ 1920,
+				/* .frameBufferHeight = */ 1080
+			};
+		}
+
+		void DestroyEGLContext() {
+			glDeleteFramebuffers(1, &s_EGL.framebuffer);
+			glDeleteRenderbuffers(2, s_EGL.renderbuffers);
+			eglMakeCurrent(s_EGL.display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+			eglDestroyContext(s_EGL.display, s_EGL.context);
+			eglTerminate(s_EGL.display);
+			s_EGL = EGLState{};
+			glstate::Invalidate();
+			shadercache::Invalidate();
+		}
+#endif
+	}
+
+	BenchGL::BenchGL(const HeadlessGLDesc& desc) {
+		if(HasFlag("--egl")) {
+#ifdef OGL_BENCH_EGL
+			// GraphicsContext has const members, it can only be emplaced
+			if(auto context = CreateEGLContext()) m_Context.emplace(*context);
+			m_EGL = m_Context.has_value();
+#else
+			log::ErrorFrom("Bench", "RenderBench was built without EGL, --egl is not available");
+#endif
+			return;
+		}
+		m_Context.emplace(headless::Init(desc));
+	}
+
+	BenchGL::~BenchGL() {
+#ifdef OGL_BENCH_EGL
+		if(m_EGL) {
+			DestroyEGLContext();
+			return;
+		}
+#endif
+		if(headless::IsActive()) headless::Shutdown();
+	}
+
+	void BenchGL::finish() const {
+		if(m_EGL) glFinish();
+	}
+
+	void BenchGL::clear() const {
+		glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+	}
+
+	Image BenchGL::read_framebuffer() const {
+		Image image(1920, 1080);
+		std::fill(image.data, image.data + (size_t)image.width * image.height, Image::pixel_t{ 0, 0, 0, 0 });
+		if(m_EGL) glReadPixels(0, 0, image.width, image.height, GL_RGBA, GL_UNSIGNED_BYTE, image.data);
+		return image;
+	}
+
+	Image::pixel_t BenchGL::read_pixel(int x, int y) const {
+		Image::pixel_t pixel{ 0, 0, 0, 0 };
+		if(m_EGL) glReadPixels(x, y, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, &pixel);
+		return pixel;
+	}
+
+	SpriteScene::SpriteScene(size_t count, size_t textureCount, float spriteSize)
+		: m_Pos(count), m_Size(count, { spriteSize, spriteSize }), m_Col(count, { 1.0f, 1.0f, 1.0f, 1.0f }),
+		m_TexCoords(count, TexCoords{ { 0.0f, 0.0f }, { 1.0f, 1.0f } }), m_SpriteTextures(count) {
+
+		// Each texture is a flat colour, so what got drawn can be told apart.
+		// Nearest and clamped to the edge, the default border would blend
+		// sprite edges into gradients that show up every subpixel difference.
+		for(size_t i = 0; i < textureCount; i++) {
+			Image image(4, 4);
+			for(size_t p = 0; p < 16; p++) image.data[p] = { (uint8_t)(64 + i * 37), (uint8_t)(64 + i * 91), (uint8_t)(64 + i * 13), 255 };
+			m_Textures.push_back(std::make_shared<Texture2D>(image, false, FilterMode::Nearest, FilterMode::Nearest, WrapMode::ClampToEdge));
+		}
+
+		// Rows of 200, overlapping once they run off the bottom of the view
+		for(size_t i = 0; i < count; i++) {
+			const float x = (float)(i % 200) * 9.6f - 960.0f;
+			const float y = (float)((i / 200) % 112) * 9.6f - 540.0f;
+			m_Pos[i] = { x, y, (float)(i % 8) * 0.1f };
+			m_SpriteTextures[i] = m_Textures[i % textureCount];
+		}
+	}
+
+	void ReportGLStats(const char* what, const HeadlessGLStats& stats) {
+		Report(what, ": ", stats.calls, " GL calls, ", stats.drawCalls, " draws, ", stats.vertices, " vertices, ", stats.instances, " instances");
+		Report(what, ": ", stats.bufferUploadBytes, " bytes uploaded, ", stats.mappedWriteBytes, " mapped, ", stats.textureUploadBytes, " texture bytes");
+		Report(what, ": ", stats.stateChanges, " state changes (", stats.redundantStateChanges, " redundant), ", stats.uniformCalls, " uniform calls");
+	}
+}
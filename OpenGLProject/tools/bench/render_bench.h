@@ -0,0 +1,73 @@
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "core.h"
+#include "graphics/context.h"
+#include "graphics/headless_gl.h"
+#include "graphics/texture.h"
+#include "graphics/2D/sprite_data.h"
+
+// Shared pieces of the RenderBench benches. They render through the real
+// engine code on the headless GL backend, so GL calls, uploads and state
+// changes can be counted. With --egl (where the build found EGL) they run
+// on a surfaceless EGL context instead, i.e. Mesa's llvmpipe on a machine
+// without a GPU, for timings that include a driver.
+
+namespace ogl::bench {
+
+	// Makes a GL context current for a bench and takes it down again
+	class BenchGL {
+	public:
+		// Headless unless --egl was passed, desc only applies to headless
+		explicit BenchGL(const HeadlessGLDesc& desc = HeadlessGLDesc{});
+		~BenchGL();
+		BenchGL(const BenchGL&) = delete;
+
+		// Empty if no context could be made, the bench should return
+		const std::optional<GraphicsContext>& context() const { return m_Context; }
+		bool headless() const { return !m_EGL; }
+
+		// glFinish on EGL, so timings include the driver's work. Nothing headless.
+		void finish() const;
+
+		void clear() const;
+		// A pixel or all of the framebuffer, always zero headless as nothing is drawn
+		Image::pixel_t read_pixel(int x, int y) const;
+		Image read_framebuffer() const;
+
+	private:
+		std::optional<GraphicsContext> m_Context;
+		bool m_EGL = false;
+	};
+
+	// A fixed scene: count sprites on a grid over a 1920x1080 view, textures
+	// handed out round robin so neighbouring sprites differ. Every run and
+	// every machine gets the same sprites.
+	class SpriteScene {
+	public:
+		SpriteScene(size_t count, size_t textureCount, float spriteSize = 32.0f);
+
+		RendererSpriteData data() {
+			return RendererSpriteData(m_Pos.data(), m_Size.data(), m_Col.data(), m_TexCoords.data(), m_SpriteTextures.data(), m_Pos.size());
+		}
+
+		size_t size() const { return m_Pos.size(); }
+		const std::vector<std::shared_ptr<Texture2D>>& textures() const { return m_Textures; }
+
+		std::vector<Vector3f>& positions() { return m_Pos; }
+		std::vector<std::shared_ptr<Texture2D>>& sprite_textures() { return m_SpriteTextures; }
+
+	private:
+		std::vector<std::shared_ptr<Texture2D>> m_Textures;
+		std::vector<Vector3f> m_Pos;
+		std::vector<Vector2f> m_Size;
+		std::vector<Vector4f> m_Col;
+		std::vector<TexCoords> m_TexCoords;
+		std::vector<std::shared_ptr<Texture2D>> m_SpriteTextures;
+	};
+
+	void ReportGLStats(const char* what, const HeadlessGLStats& stats);
+}
@@ -0,0 +1,159 @@
+#include "bench.h"
+#include "render_bench.h"
+
+#include <memory>
+#include <random>
+#include <thread>
+
+#include "graphics/gl_state.h"
+#include "graphics/render_queue.h"
+
+namespace ogl::bench {
+
+	namespace {
+
+		const char* s_QueueVertexShader =
+			"#version 330 core\n"
+			"in vec2 vert_pos;\n"
+			"void main() {\n"
+			"	gl_Position = vec4(vert_pos, 0.0, 1.0);\n"
+			"}\n";
+
+		// VARIANT only makes the programs differ
+		const char* s_QueueFragmentShader =
+			"#version 330 core\n"
+			"out vec4 frag_Colour;\n"
+			"uniform vec4 u_tint;\n"
+			"uniform sampler2D u_texture0;\n"
+			"uniform sampler2D u_texture1;\n"
+			"uniform sampler2D u_texture2;\n"
+			"uniform sampler2D u_texture3;\n"
+			"void main() {\n"
+			"	vec4 colour = texture(u_texture0, vec2(0.5)) + texture(u_texture1, vec2(0.5))\n"
+			"		+ texture(u_texture2, vec2(0.5)) + texture(u_texture3, vec2(0.5));\n"
+			"	frag_Colour = u_tint * colour * ${VARIANT}.0 / 4.0;\n"
+			"}\n";
+
+		constexpr size_t s_Programs = 4, s_VAOs = 8, s_Textures = 64, s_TexturesPerDraw = 4;
+		constexpr size_t s_Draws = 4000, s_Threads = 4;
+	}
+
+	OGL_BENCH(render_queue, "Draws 4000 commands over 4 programs, 8 VAOs and 64 textures one by one and through a RenderQueue filled from 4 threads") {
+		BenchGL gl;
+		if(!gl.context()) { Fail(); return; }
+
+		std::vector<Shader> programs;
+		for(size_t i = 0; i < s_Programs; i++) {
+			ShaderBuilder builder({ { "VARIANT", (int)i + 1 } });
+			builder.add_vertex_shader(s_QueueVertexShader);
+			builder.add_fragment_shader(s_QueueFragmentShader);
+			builder.specify_attrib(0, "vert_pos");
+			auto shader = builder.generate();
+			if(!shader) { Fail(); return; }
+			for(int32_t slot = 0; slot < (int32_t)s_TexturesPerDraw; slot++) {
+				shader->set_uniform(("u_texture" + std::to_string(slot)).c_str(), slot);
+			}
+			programs.push_back(std::move(*shader));
+		}
+
+		// A small quad each, all sharing one index buffer
+		uint32_t indices[] = { 0, 1, 2, 2, 3, 0 };
+		IndexBuffer ibo(indices, 6, BufferUsage::StaticDraw);
+		std::vector<std::unique_ptr<VertexBuffer>> vbos;
+		std::vector<std::unique_ptr<VertexArray>> vaos;
+		for(size_t i = 0; i < s_VAOs; i++) {
+			const float x = (float)i / s_VAOs * 2.0f - 1.0f;
+			Vector2f quad[] = { { x, -1.0f }, { x, -0.75f }, { x + 0.25f, -0.75f }, { x + 0.25f, -1.0f } };
+			vbos.push_back(std::make_unique<VertexBuffer>(quad, sizeof(quad), BufferUsage::StaticDraw));
+			vaos.push_back(std::make_unique<VertexArray>());
+			vaos.back()->set_attrib<Vector2f>(0, *vbos.back(), sizeof(Vector2f), 0);
+			vaos.back()->set_index_buffer(ibo);
+		}
+
+		SpriteScene textures(0, s_Textures);
+		const Vector4f tints[] = { { 1.0f, 1.0f, 1.0f, 1.0f }, { 1.0f, 0.5f, 0.5f, 1.0f }, { 0.5f, 1.0f, 0.5f, 1.0f }, { 0.5f, 0.5f, 1.0f, 1.0f } };
+
+		// Every draw picks its state at random, so neighbours rarely share any
+		struct Draw {
+			uint32_t program, vao, texture, tint;
+		};
+		std::mt19937 rng(1);
+		std::vector<Draw> draws(s_Draws);
+		for(Draw& draw : draws) {
+			draw = { (uint32_t)(rng() % s_Programs), (uint32_t)(rng() % s_VAOs), (uint32_t)(rng() % s_Textures), (uint32_t)(rng() % 4) };
+		}
+		const auto textureId = [&](const Draw& draw, size_t slot) {
+			return textures.textures()[(draw.texture + slot) % s_Textures]->get_renderer_id();
+		};
+
+		// One by one in the order they were made, with the state tracking
+		// forgotten before each so every bind and uniform set reaches GL
+		const auto drawOneByOne = [&]() {
+			for(const Draw& draw : draws) {
+				glstate::Invalidate();
+				Shader& shader = programs[draw.program];
+				shader.bind();
+				shader.set_uniform("u_tint", tints[draw.tint]);
+				vaos[draw.vao]->bind();
+				for(size_t slot = 0; slot < s_TexturesPerDraw; slot++) glstate::BindTextureUnit((uint32_t)slot, textureId(draw, slot));
+				vaos[draw.vao]->draw_indices(6, 0);
+			}
+			gl.finish();
+		};
+
+		// A driver compiles its variants of the programs on their first draws
+		drawOneByOne();
+		if(gl.headless()) headless::ResetStats();
+		auto start = Clock::now();
+		drawOneByOne();
+		const double immediateMs = MillisecondsSince(start);
+		const size_t immediateCalls = gl.headless() ? headless::Stats().calls : 0;
+		const size_t immediateState = gl.headless() ? headless::Stats().stateChanges : 0;
+
+		// The same draws through a queue, a quarter pushed from each thread
+		RenderQueue queue;
+		uint32_t tintIds[4];
+		for(size_t i = 0; i < 4; i++) tintIds[i] = queue.push_uniform("u_tint", tints[i]);
+
+		if(gl.headless()) headless::ResetStats();
+		start = Clock::now();
+		std::vector<std::thread> threads;
+		for(size_t t = 0; t < s_Threads; t++) {
+			threads.emplace_back([&, t]() {
+				const size_t first = s_Draws / s_Threads * t, last = first + s_Draws / s_Threads;
+				for(size_t i = first; i < last; i++) {
+					const Draw& draw = draws[i];
+					RenderCommand command;
+					command.key = MakeRenderKey(0, draw.program, draw.texture, (uint32_t)i);
+					command.shader = &programs[draw.program];
+					command.vao = vaos[draw.vao].get();
+					command.textureCount = (uint32_t)s_TexturesPerDraw;
+					for(size_t slot = 0; slot < s_TexturesPerDraw; slot++) command.textures[slot] = textureId(draw, slot);
+					command.uniforms[0] = tintIds[draw.tint];
+					command.uniformCount = 1;
+					command.count = 6;
+					queue.push(command);
+				}
+			});
+		}
+		for(auto& thread : threads) thread.join();
+		const double pushMs = MillisecondsSince(start);
+		glstate::Invalidate();
+		queue.submit();
+		gl.finish();
+		const double queueMs = MillisecondsSince(start);
+
+		const auto& stats = queue.get_stats();
+		OGL_CHECK(stats.commands == s_Draws && stats.drawCalls == s_Draws, stats.drawCalls, " of ", s_Draws, " commands drawn");
+		Report("one by one: ", immediateMs, " ms");
+		Report("queue: ", queueMs, " ms, ", pushMs, " ms pushing and ", stats.sortTime / 1000.0f, " ms sorting");
+		Report("queue: elided ", stats.programBindsElided, " program binds, ", stats.vaoBindsElided, " VAO binds, ", stats.textureBindsElided,
+			" texture binds and ", stats.uniformSetsElided, " uniform sets");
+		if(gl.headless()) {
+			Report("GL calls: ", immediateCalls, " one by one, ", headless::Stats().calls, " queued");
+			Report("state changes: ", immediateState, " one by one, ", headless::Stats().stateChanges, " queued");
+			OGL_CHECK(headless::Stats().drawCalls == s_Draws);
+			OGL_CHECK(headless::Stats().calls < immediateCalls, "the queue made more GL calls");
+		}
+	}
+}
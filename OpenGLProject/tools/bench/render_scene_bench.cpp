@@ -0,0 +1,68 @@
+#include "bench.h"
+#include "render_bench.h"
+
+#include "graphics/2D/instance_renderer.h"
+
+namespace ogl::bench {
+
+	OGL_BENCH(render_scene, "Renders a fixed 25k sprite, 20 texture scene through BatchRenderer2D in both modes and prints what GL saw") {
+		BenchGL gl;
+		if(!gl.context()) { Fail(); return; }
+		const GraphicsContext& context = *gl.context();
+
+		SpriteScene scene(25'000, 20);
+		const RendererSpriteData data = scene.data();
+
+		for(SpriteRenderMode mode : { SpriteRenderMode::Vertices, SpriteRenderMode::Instanced }) {
+			const char* modeName = mode == SpriteRenderMode::Vertices ? "vertices" : "instanced";
+			BatchRenderer2DSettings settings;
+			settings.mode = mode;
+			BatchRenderer2D renderer(context, settings);
+
+			// The first frame compiles the shader and fills the ring, time the rest
+			renderer.process(data, context);
+			renderer.flush(context);
+			gl.finish();
+
+			constexpr int frames = 10;
+			if(gl.headless()) headless::ResetStats();
+			renderer.reset_stats();
+			const auto start = Clock::now();
+			for(int i = 0; i < frames; i++) {
+				renderer.process(data, context);
+				renderer.flush(context);
+			}
+			gl.finish();
+			const double ms = MillisecondsSince(start) / frames;
+
+			const auto& stats = renderer.get_stats();
+			Report(modeName, ": ", ms, " ms a frame, ", stats.drawCalls / frames, " draws, ", stats.vertexBytes / frames, " vertex bytes a frame");
+			if(!gl.headless()) {
+				// Every texture is opaque and the scene covers the whole view
+				gl.clear();
+				renderer.process(data, context);
+				renderer.flush(context);
+				OGL_CHECK(gl.read_pixel(5, 5).w == 255 && gl.read_pixel(1900, 1060).w == 255, modeName, ", the scene wasn't drawn");
+				continue;
+			}
+
+			// Per frame, so they compare with the numbers above
+			HeadlessGLStats perFrame = headless::Stats();
+			for(size_t* count : { &perFrame.calls, &perFrame.drawCalls, &perFrame.vertices, &perFrame.instances, &perFrame.bufferUploadBytes,
+				&perFrame.mappedWriteBytes, &perFrame.textureUploadBytes, &perFrame.stateChanges, &perFrame.redundantStateChanges, &perFrame.uniformCalls }) {
+				*count /= frames;
+			}
+			ReportGLStats(modeName, perFrame);
+
+			// What the renderer says it did is what GL saw
+			OGL_CHECK(headless::Stats().drawCalls == stats.drawCalls, headless::Stats().drawCalls, " draws, renderer counted ", stats.drawCalls);
+			if(mode == SpriteRenderMode::Vertices) {
+				OGL_CHECK(headless::Stats().vertices == stats.sprites * 6, headless::Stats().vertices, " indices drawn for ", stats.sprites, " sprites");
+			}
+			else {
+				OGL_CHECK(headless::Stats().instances == stats.sprites, headless::Stats().instances, " instances drawn for ", stats.sprites, " sprites");
+			}
+			OGL_CHECK(stats.sprites == scene.size() * frames, stats.sprites, " sprites processed");
+		}
+	}
+}
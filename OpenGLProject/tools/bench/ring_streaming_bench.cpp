@@ -0,0 +1,84 @@
+#include "bench.h"
+#include "render_bench.h"
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+
+#include "graphics/2D/instance_renderer.h"
+
+namespace ogl::bench {
+
+	OGL_BENCH(ring_streaming, "Compares frame times of the ring buffer and the map/orphan/remap path, run with --egl for a driver") {
+		BenchGL gl;
+		if(!gl.context()) { Fail(); return; }
+		const GraphicsContext& context = *gl.context();
+
+		// Small sprites so a software rasteriser spends its time on the
+		// uploads, 100k is 10 batches a frame
+		SpriteScene scene(100'000, 4, 2.0f);
+		const RendererSpriteData data = scene.data();
+
+		const char* names[2] = { "orphan", "ring" };
+		std::unique_ptr<BatchRenderer2D> renderers[2];
+		for(int ring = 0; ring < 2; ring++) {
+			BatchRenderer2DSettings settings;
+			settings.ringStreaming = ring;
+			renderers[ring] = std::make_unique<BatchRenderer2D>(context, settings);
+		}
+
+		const auto frame = [&](BatchRenderer2D& renderer) {
+			renderer.process(data, context);
+			renderer.flush(context);
+		};
+
+		// The first frames on a driver compile shaders and grow its pools,
+		// whichever path runs first would pay for that
+		for(int i = 0; i < 5; i++) {
+			for(auto& renderer : renderers) frame(*renderer);
+		}
+		gl.finish();
+
+		// Frames are only finished at the end of a round, like real ones that
+		// don't wait on the GPU, so the stalls of each path show. Rounds
+		// alternate between the paths and the best is kept.
+		constexpr int rounds = 5, frames = 10;
+		double ms[2] = { 1e30, 1e30 };
+		HeadlessGLStats glStats[2];
+		for(int round = 0; round < rounds; round++) {
+			for(int ring = 0; ring < 2; ring++) {
+				if(gl.headless()) headless::ResetStats();
+				renderers[ring]->reset_stats();
+				const auto start = Clock::now();
+				for(int i = 0; i < frames; i++) frame(*renderers[ring]);
+				gl.finish();
+				ms[ring] = std::min(ms[ring], MillisecondsSince(start) / frames);
+				if(gl.headless()) glStats[ring] = headless::Stats();
+			}
+		}
+
+		for(int ring = 0; ring < 2; ring++) {
+			const auto& stats = renderers[ring]->get_stats();
+			Report(names[ring], ": ", ms[ring], " ms a frame, ", stats.drawCalls / frames, " draws, ", stats.ringStalls, " ring stalls in ", frames, " frames");
+			if(gl.headless()) {
+				Report(names[ring], ": ", glStats[ring].calls / frames, " GL calls a frame, ", glStats[ring].bufferUploadBytes / frames, " bytes uploaded, ",
+					glStats[ring].mappedWriteBytes / frames, " mapped");
+			}
+		}
+		Report("ring is ", ms[0] / ms[1], "x the speed of orphan");
+		if(gl.headless()) return;
+
+		// Both paths stream the same vertices
+		std::optional<Image> images[2];
+		for(int ring = 0; ring < 2; ring++) {
+			gl.clear();
+			frame(*renderers[ring]);
+			images[ring].emplace(gl.read_framebuffer());
+		}
+		size_t different = 0;
+		for(size_t i = 0; i < (size_t)images[0]->width * images[0]->height; i++) {
+			different += std::memcmp(&images[0]->data[i], &images[1]->data[i], sizeof(Image::pixel_t)) != 0;
+		}
+		OGL_CHECK(different == 0, "ring drew ", different, " pixels differently to orphan");
+	}
+}
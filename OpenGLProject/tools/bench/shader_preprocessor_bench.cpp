@@ -0,0 +1,112 @@
+#include "bench.h"
+
+#include <filesystem>
+#include <fstream>
+
+#include "graphics/shader_preprocessor.h"
+
+namespace ogl::bench {
+
+	namespace {
+
+		void WriteText(const std::filesystem::path& path, const char* text) {
+			std::ofstream file(path, std::ios::binary);
+			file << text;
+		}
+
+		void CheckPreprocess(const char* what, const char* source, const ShaderVars& vars, const char* expected) {
+			const auto out = glsl::Preprocess(source, vars);
+			OGL_CHECK(out && *out == expected, what, out ? ", got:\n" + *out : ", failed");
+		}
+	}
+
+	OGL_BENCH(shader_preprocessor, "Checks includes, #pragma once, vars, comments and #line output of glsl::Preprocess, and times its permutation cache") {
+		const auto directory = std::filesystem::temp_directory_path() / "ogl_shader_preprocessor_bench";
+		std::filesystem::create_directories(directory);
+		glsl::AddIncludeDirectory(directory.string());
+		glsl::ClearCache();
+
+		// A file on disk that includes a built in source, both only once
+		WriteText(directory / "bench_common.glsl",
+			"#pragma once\n"
+			"#include \"bench/inner.glsl\"\n"
+			"float common_value;\n");
+		glsl::AddIncludeSource("bench/inner.glsl",
+			"#pragma once\n"
+			"float inner = ${SCALE};\n");
+
+		CheckPreprocess("nested includes",
+			"#version 330 core\n"
+			"#include \"bench_common.glsl\"\n"
+			"#include \"bench_common.glsl\"\n"
+			"void main() {}\n",
+			{ { "SCALE", 2.0f } },
+			"#version 330 core\n"
+			"#line 1 1\n"
+			"\n"
+			"#line 1 2\n"
+			"\n"
+			"float inner = 2.0;\n"
+			"#line 3 1\n"
+			"float common_value;\n"
+			"#line 3 0\n"
+			"\n"
+			"void main() {}\n");
+
+		// Commented out directives and vars are left alone, even unset ones
+		CheckPreprocess("comments",
+			"int a = ${A}; // ${UNSET}\n"
+			"// #include \"missing.glsl\"\n"
+			"/* #include \"missing.glsl\"\n"
+			"   ${UNSET} */ int b = ${A}; /* ${UNSET} */\n",
+			{ { "A", 1 } },
+			"int a = 1; // ${UNSET}\n"
+			"// #include \"missing.glsl\"\n"
+			"/* #include \"missing.glsl\"\n"
+			"   ${UNSET} */ int b = 1; /* ${UNSET} */\n");
+
+		OGL_CHECK(!glsl::Preprocess("#include \"missing.glsl\"\n", {}), "a missing include was not an error");
+		OGL_CHECK(!glsl::Preprocess("int a = ${UNSET};\n", {}), "an unset var was not an error");
+		OGL_CHECK(!glsl::Preprocess("int a = ${A;\n", { { "A", 1 } }), "an unterminated var was not an error");
+
+		// 512 programs over 4 var combinations, a vertex and a fragment shader
+		// each, so 8 permutations
+		const char* sources[2] = {
+			"#version 330 core\n#include \"bench_common.glsl\"\nvoid main() { gl_Position = vec4(${SCALE}); }\n",
+			"#version 330 core\n#include \"bench_common.glsl\"\nout vec4 c;\nvoid main() { c = vec4(${SCALE}) * ${TINT}; }\n"
+		};
+		constexpr size_t programs = 512;
+		const auto preprocessAll = [&](bool clearEachTime) {
+			for(size_t i = 0; i < programs; i++) {
+				const ShaderVars vars = { { "SCALE", (float)(i % 2) }, { "TINT", (int)(i / 2 % 2) } };
+				for(const char* source : sources) {
+					if(clearEachTime) glsl::ClearCache();
+					if(!glsl::Preprocess(source, vars)) Fail();
+				}
+			}
+		};
+
+		glsl::ClearCache();
+		glsl::ResetStats();
+		auto start = Clock::now();
+		preprocessAll(false);
+		const double cachedUs = MillisecondsSince(start) * 1000.0 / programs;
+		const ShaderPreprocessStats cached = glsl::Stats();
+
+		glsl::ResetStats();
+		start = Clock::now();
+		preprocessAll(true);
+		const double clearedUs = MillisecondsSince(start) * 1000.0 / programs;
+		const ShaderPreprocessStats cleared = glsl::Stats();
+
+		Report("permutation cache: ", cached.preprocessed, " preprocesses, ", cached.cacheHits, " hits, ", cached.includeReads, " file reads, ", cachedUs, " us a program");
+		Report("cleared each time: ", cleared.preprocessed, " preprocesses, ", cleared.includeReads, " file reads, ", clearedUs, " us a program");
+		OGL_CHECK(cached.preprocessed == 8 && cached.cacheHits == programs * 2 - 8, cached.preprocessed, " preprocesses and ", cached.cacheHits, " hits");
+		OGL_CHECK(cached.includeReads == 1, cached.includeReads, " file reads with the cache");
+		OGL_CHECK(cleared.preprocessed == programs * 2 && cleared.includeReads == programs * 2);
+
+		glsl::ClearCache();
+		std::error_code error;
+		std::filesystem::remove_all(directory, error);
+	}
+}
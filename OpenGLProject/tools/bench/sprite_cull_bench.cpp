@@ -0,0 +1,90 @@
+#include "bench.h"
+#include "render_bench.h"
+
+#include "graphics/2D/instance_renderer.h"
+
+namespace ogl::bench {
+
+	namespace {
+
+		// The plain overlap test, CullSprites does the same four at a time
+		bool Overlaps(const Vector3f& pos, const Vector2f& size, const ViewRect& view) {
+			return pos.x < view.max.x && pos.x + size.x > view.min.x &&
+			       pos.y < view.max.y && pos.y + size.y > view.min.y;
+		}
+
+		// The sprites of data that overlap view, in order
+		struct VisibleSprites {
+			std::vector<Vector3f> pos;
+			std::vector<Vector2f> size;
+			std::vector<Vector4f> col;
+			std::vector<TexCoords> texCoords;
+			std::vector<std::shared_ptr<Texture2D>> textures;
+
+			VisibleSprites(const RendererSpriteData& data, const ViewRect& view) {
+				for(size_t i = 0; i < data.spriteCount; i++) {
+					if(!Overlaps(data.pos[i], data.size[i], view)) continue;
+					pos.push_back(data.pos[i]);
+					size.push_back(data.size[i]);
+					col.push_back(data.col[i]);
+					texCoords.push_back(data.texCoords[i]);
+					textures.push_back(data.texture[i]);
+				}
+			}
+
+			RendererSpriteData data() {
+				return RendererSpriteData(pos.data(), size.data(), col.data(), texCoords.data(), textures.data(), pos.size());
+			}
+		};
+	}
+
+	OGL_BENCH(sprite_cull, "Draws 200k sprites with 90% off screen with and without cullSprites and checks the culled frame matches the visible sprites drawn alone") {
+		BenchGL gl;
+		if(!gl.context()) { Fail(); return; }
+		const GraphicsContext& context = *gl.context();
+
+		// 9 in 10 sprites move right by a view width, the ones at the right
+		// edge of the grid still straddle the view
+		constexpr size_t count = 200'000;
+		SpriteScene scene(count, 8);
+		for(size_t i = 0; i < count; i++) {
+			if(i % 10) scene.positions()[i].x += 1900.0f;
+		}
+		const RendererSpriteData data = scene.data();
+
+		BatchRenderer2DSettings culledSettings;
+		culledSettings.cullSprites = true;
+		BatchRenderer2D culled(context, culledSettings);
+		BatchRenderer2D unculled(context, BatchRenderer2DSettings{});
+		BatchRenderer2D reference(context, BatchRenderer2DSettings{});
+
+		VisibleSprites visible(data, culled.get_view_rect(context));
+		const RendererSpriteData visibleData = visible.data();
+
+		const auto frame = [&](BatchRenderer2D& renderer, const RendererSpriteData& sprites) {
+			renderer.reset_stats();
+			renderer.process(sprites, context);
+			renderer.flush(context);
+			gl.finish();
+		};
+
+		const double culledMs = TimeBest(5, [&]() { frame(culled, data); });
+		const double unculledMs = TimeBest(5, [&]() { frame(unculled, data); });
+		frame(reference, visibleData);
+
+		const BatchRenderer2DStats& culledStats = culled.get_stats();
+		const BatchRenderer2DStats& unculledStats = unculled.get_stats();
+		Report(visible.pos.size(), " of ", count, " sprites overlap the view");
+		Report("unculled: ", unculledMs, " ms, ", unculledStats.vertexBytes / 1024, " KiB of vertices");
+		Report("culled:   ", culledMs, " ms, ", culledStats.vertexBytes / 1024, " KiB of vertices (", unculledMs / culledMs, "x faster, ",
+			(double)unculledStats.vertexBytes / (double)culledStats.vertexBytes, "x fewer bytes)");
+
+		OGL_CHECK(culledStats.sprites == visible.pos.size(), "drew ", culledStats.sprites, " sprites, ", visible.pos.size(), " overlap the view");
+		OGL_CHECK(culledStats.culled == count - visible.pos.size(), "culled ", culledStats.culled, " of ", count - visible.pos.size(), " sprites off screen");
+		OGL_CHECK(culledStats.vertexBytes == reference.get_stats().vertexBytes, "wrote ", culledStats.vertexBytes, " vertex bytes, ", reference.get_stats().vertexBytes, " without the off screen sprites");
+		if(gl.headless()) {
+			OGL_CHECK(*headless::BufferContents(culled.get_vertex_buffer_id()) == *headless::BufferContents(reference.get_vertex_buffer_id()),
+				"the culled frame wrote a different buffer to the visible sprites drawn alone");
+		}
+	}
+}
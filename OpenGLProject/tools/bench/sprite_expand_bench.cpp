@@ -0,0 +1,87 @@
+#include "bench.h"
+
+#include <random>
+#include <cstring>
+
+#include "graphics/2D/sprite_vertex.h"
+
+namespace ogl::bench {
+
+	namespace {
+
+		// Random sprites over a 1080p view, expanding doesn't look at the textures
+		struct SpriteSet {
+			explicit SpriteSet(size_t count, uint32_t seed = 1)
+				: pos(count), size(count), col(count), texCoords(count), textures(count), slots(count) {
+				std::mt19937 rng(seed);
+				std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+				for(size_t i = 0; i < count; i++) {
+					pos[i] = { unit(rng) * 1920.0f - 960.0f, unit(rng) * 1080.0f - 540.0f, unit(rng) };
+					size[i] = { 1.0f + unit(rng) * 64.0f, 1.0f + unit(rng) * 64.0f };
+					col[i] = { unit(rng), unit(rng), unit(rng), unit(rng) };
+					texCoords[i] = TexCoords{ { unit(rng) * 0.5f, unit(rng) * 0.5f }, { unit(rng) * 0.5f, unit(rng) * 0.5f } };
+					slots[i] = (texslot_t)(rng() % 16);
+				}
+			}
+
+			RendererSpriteData data() {
+				return RendererSpriteData(pos.data(), size.data(), col.data(), texCoords.data(), textures.data(), pos.size());
+			}
+
+			std::vector<Vector3f> pos;
+			std::vector<Vector2f> size;
+			std::vector<Vector4f> col;
+			std::vector<TexCoords> texCoords;
+			std::vector<std::shared_ptr<Texture2D>> textures;
+			std::vector<texslot_t> slots;
+		};
+
+		// How transform_data wrote vertices before ExpandSprites, one pass over
+		// the batch per attribute
+		void ExpandSpritesPerAttribute(const RendererSpriteData& data, const texslot_t* slots, SpriteVertex* out) {
+			for(size_t i = 0; i < data.spriteCount; i++) {
+				const auto& pos = data.pos[i];
+				const auto& size = data.size[i];
+				out[i * 4 + 0].position = pos;
+				out[i * 4 + 1].position = Vector3f{ pos.x, pos.y + size.y, pos.z };
+				out[i * 4 + 2].position = Vector3f{ pos.x + size.x, pos.y + size.y, pos.z };
+				out[i * 4 + 3].position = Vector3f{ pos.x + size.x, pos.y, pos.z };
+			}
+			for(size_t i = 0; i < data.spriteCount; i++) {
+				for(size_t v = 0; v < 4; v++) out[i * 4 + v].colour = data.col[i];
+			}
+			for(size_t i = 0; i < data.spriteCount; i++) {
+				const auto& tc = data.texCoords[i];
+				out[i * 4 + 0].texCoord = tc.pos;
+				out[i * 4 + 1].texCoord = tc.pos + Vector2f{ 0.0f, tc.size.y };
+				out[i * 4 + 2].texCoord = tc.pos + tc.size;
+				out[i * 4 + 3].texCoord = tc.pos + Vector2f{ tc.size.x, 0.0f };
+			}
+			for(size_t i = 0; i < data.spriteCount; i++) {
+				for(size_t v = 0; v < 4; v++) out[i * 4 + v].texId = slots[i];
+			}
+		}
+	}
+
+	OGL_BENCH(sprite_expand, "Expands sprites a quad at a time and one attribute at a time, checks both write the same bytes") {
+		// 10k is a full batch (OGL_2D_BATCH_MAX_SPRITES)
+		for(size_t count : { (size_t)1, (size_t)7, (size_t)10'000, (size_t)200'003 }) {
+			SpriteSet sprites(count, (uint32_t)count);
+			const RendererSpriteData data = sprites.data();
+
+			// Poisoned so bytes that aren't written can't match by luck
+			std::vector<SpriteVertex> quads(count * 4), attributes(count * 4);
+			std::memset(quads.data(), 0xCD, quads.size() * sizeof(SpriteVertex));
+			std::memset(attributes.data(), 0xCD, attributes.size() * sizeof(SpriteVertex));
+
+			const int runs = count < 1000 ? 1000 : 20;
+			const double quadMs = TimeBest(runs, [&]() { ExpandSprites(data, sprites.slots.data(), quads.data()); });
+			const double attributeMs = TimeBest(runs, [&]() { ExpandSpritesPerAttribute(data, sprites.slots.data(), attributes.data()); });
+			OGL_CHECK(std::memcmp(quads.data(), attributes.data(), quads.size() * sizeof(SpriteVertex)) == 0, count, " sprites");
+
+			if(count >= 10'000) {
+				Report(count, " sprites: ExpandSprites ", quadMs, " ms, per attribute ", attributeMs, " ms (", attributeMs / quadMs, "x)");
+			}
+		}
+	}
+}
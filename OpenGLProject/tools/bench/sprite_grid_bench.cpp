@@ -0,0 +1,100 @@
+#include "bench.h"
+
+#include <random>
+#include <algorithm>
+
+#include "graphics/2D/sprite_grid.h"
+#include "graphics/2D/sprite_cull.h"
+
+namespace ogl::bench {
+
+	namespace {
+
+		// The sprites a grid query finds, sorted so they can be compared with a scan
+		std::vector<uint32_t> GridQuery(const SpriteGrid& grid, const ViewRect& view) {
+			std::vector<uint32_t> found;
+			grid.query(view, found);
+			std::sort(found.begin(), found.end());
+			return found;
+		}
+
+		std::vector<uint32_t> ScanQuery(const RendererSpriteData& data, const ViewRect& view) {
+			std::vector<uint32_t> found(data.spriteCount);
+			found.resize(CullSprites(data, view, found.data()));
+			return found;
+		}
+	}
+
+	OGL_BENCH(sprite_grid, "Queries a 1920x1080 view of 2M sprites by scanning and through a SpriteGrid, then moves 100k of them") {
+		constexpr size_t count = 2'000'000;
+		constexpr float world = 40'000.0f;
+
+		std::mt19937 rng(1);
+		std::uniform_real_distribution<float> coord(0.0f, world);
+		std::uniform_real_distribution<float> extent(4.0f, 64.0f);
+		std::vector<Vector3f> pos(count);
+		std::vector<Vector2f> size(count);
+		for(size_t i = 0; i < count; i++) {
+			pos[i] = { coord(rng), coord(rng), 0.0f };
+			size[i] = { extent(rng), extent(rng) };
+		}
+		std::vector<Vector4f> col(count, { 1.0f, 1.0f, 1.0f, 1.0f });
+		std::vector<TexCoords> texCoords(count, TexCoords{ { 0.0f, 0.0f }, { 1.0f, 1.0f } });
+		std::vector<std::shared_ptr<Texture2D>> textures(count);
+		const RendererSpriteData data(pos.data(), size.data(), col.data(), texCoords.data(), textures.data(), count);
+
+		SpriteGrid grid(128.0f);
+		auto start = Clock::now();
+		grid.build(data);
+		Report("build: ", count, " sprites in ", MillisecondsSince(start), " ms, ", grid.cell_count(), " cells");
+
+		// Views spread over the world, including ones hanging off its edges
+		std::vector<ViewRect> views;
+		for(int i = 0; i < 16; i++) {
+			const Vector2f min{ coord(rng) - 960.0f, coord(rng) - 540.0f };
+			views.push_back({ min, { min.x + 1920.0f, min.y + 1080.0f } });
+		}
+
+		size_t mismatched = 0, visible = 0;
+		for(const ViewRect& view : views) {
+			const std::vector<uint32_t> scanned = ScanQuery(data, view);
+			mismatched += GridQuery(grid, view) != scanned;
+			visible += scanned.size();
+		}
+		OGL_CHECK(mismatched == 0, mismatched, " of ", views.size(), " views found different sprites");
+
+		std::vector<uint32_t> out(count);
+		size_t next = 0;
+		const double scanMs = TimeBest(5, [&]() { CullSprites(data, views[next++ % views.size()], out.data()); });
+		std::vector<uint32_t> found;
+		const double gridMs = TimeBest(5, [&]() { found.clear(); grid.query(views[next++ % views.size()], found); });
+		Report("view query: scan ", scanMs, " ms, grid ", gridMs, " ms, ", visible / views.size(), " sprites visible on average");
+
+		// Small moves mostly stay in their cell, jumps always change cell
+		std::uniform_int_distribution<uint32_t> pick(0, (uint32_t)count - 1);
+		std::uniform_real_distribution<float> nudge(-8.0f, 8.0f);
+		std::vector<uint32_t> moved(100'000);
+		for(uint32_t& index : moved) index = pick(rng);
+		start = Clock::now();
+		for(size_t i = 0; i < moved.size(); i++) {
+			const uint32_t index = moved[i];
+			if(i % 4 == 0) pos[index] = { coord(rng), coord(rng), 0.0f };
+			else pos[index] = { pos[index].x + nudge(rng), pos[index].y + nudge(rng), 0.0f };
+			grid.update(index, pos[index], size[index]);
+		}
+		Report("update: ", moved.size(), " moves in ", MillisecondsSince(start), " ms");
+
+		mismatched = 0;
+		for(const ViewRect& view : views) mismatched += GridQuery(grid, view) != ScanQuery(data, view);
+		OGL_CHECK(mismatched == 0, mismatched, " of ", views.size(), " views found different sprites after moving");
+
+		// Removed sprites are never found again
+		for(size_t i = 0; i < count; i += 2) grid.remove((uint32_t)i);
+		size_t removedFound = 0;
+		for(const ViewRect& view : views) {
+			for(uint32_t index : GridQuery(grid, view)) removedFound += index % 2 == 0;
+		}
+		OGL_CHECK(removedFound == 0, removedFound, " removed sprites found");
+		OGL_CHECK(grid.size() == count / 2, grid.size(), " sprites left");
+	}
+}
@@ -0,0 +1,78 @@
+#include "bench.h"
+#include "render_bench.h"
+
+#include <cstring>
+
+#include "graphics/2D/instance_renderer.h"
+
+namespace ogl::bench {
+
+	namespace {
+
+		struct ModeCase {
+			const char* name;
+			SpriteRenderMode mode;
+			bool packed;
+			size_t bytesPerSprite;
+		};
+	}
+
+	OGL_BENCH(sprite_mode, "Measures the bytes each sprite costs in every render mode, and checks the modes draw the same image with --egl") {
+		BenchGL gl;
+		if(!gl.context()) { Fail(); return; }
+		const GraphicsContext& context = *gl.context();
+
+		// Few enough textures that only the batch size splits batches
+		SpriteScene scene(100'000, 4);
+		const RendererSpriteData data = scene.data();
+
+		const ModeCase cases[] = {
+			{ "vertices", SpriteRenderMode::Vertices, false, 4 * sizeof(SpriteVertex) },
+			{ "packed vertices", SpriteRenderMode::Vertices, true, 4 * sizeof(SpriteVertexPacked) },
+			{ "instanced", SpriteRenderMode::Instanced, false, sizeof(SpriteInstance) },
+		};
+
+		std::optional<Image> reference;
+		for(const ModeCase& mode : cases) {
+			BatchRenderer2DSettings settings;
+			settings.mode = mode.mode;
+			settings.packedVertices = mode.packed;
+			BatchRenderer2D renderer(context, settings);
+
+			renderer.process(data, context);
+			renderer.flush(context);
+			gl.finish();
+			renderer.reset_stats();
+
+			const double ms = TimeBest(5, [&]() {
+				renderer.process(data, context);
+				renderer.flush(context);
+				gl.finish();
+			});
+
+			const auto& stats = renderer.get_stats();
+			const size_t bytesPerSprite = stats.vertexBytes / stats.sprites;
+			Report(mode.name, ": ", bytesPerSprite, " bytes a sprite, ", stats.vertexBytes / 5 / 1024, " KB and ", ms, " ms for ", scene.size(), " sprites");
+			OGL_CHECK(bytesPerSprite == mode.bytesPerSprite, mode.name, " wrote ", bytesPerSprite, " bytes a sprite");
+
+			if(gl.headless()) continue;
+
+			// The modes only differ in how sprites reach the GPU, not what is drawn
+			gl.clear();
+			renderer.process(data, context);
+			renderer.flush(context);
+			const Image image = gl.read_framebuffer();
+			if(!reference) {
+				reference.emplace(image);
+				continue;
+			}
+
+			size_t different = 0;
+			for(size_t i = 0; i < (size_t)image.width * image.height; i++) {
+				different += std::memcmp(&image.data[i], &reference->data[i], sizeof(Image::pixel_t)) != 0;
+			}
+			Report(mode.name, ": ", different, " pixels differ from vertices");
+			OGL_CHECK(different == 0, mode.name, " drew ", different, " pixels differently");
+		}
+	}
+}
@@ -0,0 +1,132 @@
+#include "bench.h"
+
+#include <cmath>
+#include <random>
+
+#include "graphics/2D/sprite_vertex.h"
+
+namespace ogl::bench {
+
+	namespace {
+
+		// What GL does with a normalised attribute, see the GL spec 2.3.5.1
+		float FromSnorm16(int16_t value) { return std::max((float)value / 32767.0f, -1.0f); }
+		float FromUnorm16(uint16_t value) { return (float)value / 65535.0f; }
+		float FromUnorm8(uint8_t value) { return (float)value / 255.0f; }
+
+		// The position the vertex shader computes, u_packOrigin + vert_pos * u_packScale
+		Vector3f Unpack(const SpritePackFrame& frame, const Vector3<int16_t>& position) {
+			return {
+				frame.origin.x + FromSnorm16(position.x) * frame.scale.x,
+				frame.origin.y + FromSnorm16(position.y) * frame.scale.y,
+				frame.origin.z + FromSnorm16(position.z) * frame.scale.z
+			};
+		}
+
+		float Clamp(float value, float min, float max) { return value < min ? min : (value > max ? max : value); }
+
+		struct PackErrors {
+			float position = 0.0f;
+			float depth = 0.0f;
+			float texCoord = 0.0f;
+			float colour = 0.0f;
+			size_t texIdMismatches = 0;
+			// Vertices outside of the frame whose unpacked position landed in the view
+			size_t clampedOnScreen = 0;
+		};
+
+		// Packs count random sprites within reach * the frame's half size of
+		// the view centre and compares them to the full vertices. Positions
+		// past the frame are compared to where they should be clamped to.
+		PackErrors MeasurePacking(const Vector2f& viewSize, float reach, size_t count, uint32_t seed) {
+			constexpr float zNear = -1.0f, zFar = 100.0f;
+			const Vector2f viewMin = { -viewSize.x / 2.0f, -viewSize.y / 2.0f };
+			const Vector2f viewMax = { viewSize.x / 2.0f, viewSize.y / 2.0f };
+			const SpritePackFrame frame = MakeSpritePackFrame(viewMin, viewMax, zNear, zFar);
+
+			std::mt19937 rng(seed);
+			std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+			std::uniform_real_distribution<float> signedUnit(-1.0f, 1.0f);
+
+			std::vector<Vector3f> pos(count);
+			std::vector<Vector2f> size(count);
+			std::vector<Vector4f> col(count);
+			std::vector<TexCoords> texCoords(count);
+			std::vector<std::shared_ptr<Texture2D>> textures(count);
+			std::vector<texslot_t> slots(count);
+			for(size_t i = 0; i < count; i++) {
+				pos[i] = { signedUnit(rng) * frame.scale.x * reach, signedUnit(rng) * frame.scale.y * reach, zNear + unit(rng) * (zFar - zNear) };
+				size[i] = { 1.0f + unit(rng) * 256.0f, 1.0f + unit(rng) * 256.0f };
+				col[i] = { unit(rng), unit(rng), unit(rng), unit(rng) };
+				texCoords[i] = TexCoords{ { unit(rng) * 0.5f, unit(rng) * 0.5f }, { unit(rng) * 0.5f, unit(rng) * 0.5f } };
+				slots[i] = (texslot_t)(rng() % 32);
+			}
+			const RendererSpriteData data(pos.data(), size.data(), col.data(), texCoords.data(), textures.data(), count);
+
+			std::vector<SpriteVertex> full(count * 4);
+			std::vector<SpriteVertexPacked> packed(count * 4);
+			ExpandSprites(data, slots.data(), full.data());
+			PackSpriteVertices(data, slots.data(), frame, packed.data());
+
+			PackErrors errors;
+			for(size_t i = 0; i < full.size(); i++) {
+				const SpriteVertex& expected = full[i];
+				const SpriteVertexPacked& vertex = packed[i];
+				const Vector3f unpacked = Unpack(frame, vertex.position);
+
+				const Vector3f clamped = {
+					Clamp(expected.position.x, frame.origin.x - frame.scale.x, frame.origin.x + frame.scale.x),
+					Clamp(expected.position.y, frame.origin.y - frame.scale.y, frame.origin.y + frame.scale.y),
+					expected.position.z
+				};
+				errors.position = std::max({ errors.position, std::abs(unpacked.x - clamped.x), std::abs(unpacked.y - clamped.y) });
+				errors.depth = std::max(errors.depth, std::abs(unpacked.z - clamped.z));
+
+				const bool wasClamped = clamped.x != expected.position.x || clamped.y != expected.position.y;
+				const bool onScreen = unpacked.x > viewMin.x && unpacked.x < viewMax.x && unpacked.y > viewMin.y && unpacked.y < viewMax.y;
+				if(wasClamped && onScreen) errors.clampedOnScreen++;
+
+				errors.texCoord = std::max({ errors.texCoord,
+					std::abs(FromUnorm16(vertex.texCoord.x) - expected.texCoord.x),
+					std::abs(FromUnorm16(vertex.texCoord.y) - expected.texCoord.y) });
+				errors.colour = std::max({ errors.colour,
+					std::abs(FromUnorm8(vertex.colour.x) - expected.colour.x), std::abs(FromUnorm8(vertex.colour.y) - expected.colour.y),
+					std::abs(FromUnorm8(vertex.colour.z) - expected.colour.z), std::abs(FromUnorm8(vertex.colour.w) - expected.colour.w) });
+				if(vertex.texId != expected.texId) errors.texIdMismatches++;
+			}
+			return errors;
+		}
+	}
+
+	OGL_BENCH(sprite_pack, "Checks packed sprite vertices unpack to within a pixel, and clamp off screen past the pack frame") {
+		// View sizes are in pixels, like the views BatchRenderer2D makes
+		const Vector2f views[] = { { 1280.0f, 720.0f }, { 1920.0f, 1080.0f }, { 3840.0f, 2160.0f } };
+		const float zQuantum = (100.0f - -1.0f) / 2.0f / 32767.0f;
+
+		for(const auto& view : views) {
+			// Everything within the frame, sprite corners reach a little past it
+			const PackErrors inside = MeasurePacking(view, 0.95f, 100'000, 1);
+			Report(view.x, "x", view.y, ": max position error ", inside.position, "px, depth ", inside.depth,
+				", tex coord ", inside.texCoord, ", colour ", inside.colour);
+			OGL_CHECK(inside.position < 1.0f, view.x, "x", view.y, " position error ", inside.position, "px");
+			// Rounding, so half a step of each format, plus float slack
+			OGL_CHECK(inside.depth <= zQuantum * 0.5f + 1e-4f, inside.depth);
+			OGL_CHECK(inside.texCoord <= 0.5f / 65535.0f + 1e-6f, inside.texCoord);
+			OGL_CHECK(inside.colour <= 0.5f / 255.0f + 1e-6f, inside.colour);
+			OGL_CHECK(inside.texIdMismatches == 0, inside.texIdMismatches, " tex ids differ");
+			OGL_CHECK(inside.clampedOnScreen == 0, inside.clampedOnScreen, " clamped vertices on screen");
+
+			// Up to 10 times the frame, most sprites are clamped. They must
+			// land on the frame edge, which is off screen.
+			const PackErrors outside = MeasurePacking(view, 10.0f, 100'000, 2);
+			Report(view.x, "x", view.y, ": clamped max error ", outside.position, "px, ", outside.clampedOnScreen, " clamped vertices on screen");
+			OGL_CHECK(outside.position < 1.0f, view.x, "x", view.y, " clamped position error ", outside.position, "px");
+			OGL_CHECK(outside.clampedOnScreen == 0, outside.clampedOnScreen, " clamped vertices on screen");
+
+			// Far enough that position - origin loses precision in a float
+			const PackErrors far = MeasurePacking(view, 1e6f, 1000, 3);
+			OGL_CHECK(far.position < 1.0f, far.position);
+			OGL_CHECK(far.clampedOnScreen == 0, far.clampedOnScreen);
+		}
+	}
+}
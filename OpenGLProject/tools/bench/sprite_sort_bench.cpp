@@ -0,0 +1,92 @@
+#include "bench.h"
+
+#include <random>
+#include <unordered_set>
+
+#include "graphics/headless_gl.h"
+#include "graphics/2D/sprite_sort.h"
+#include "graphics/2D/instance_renderer.h"
+
+namespace ogl::bench {
+
+	namespace {
+
+		// The flushes BatchRenderer2D would do drawing sprites in order, a
+		// batch ends when it is full or it needs more texture slots than there are
+		size_t CountFlushes(const RendererSpriteData& data, size_t slots, size_t batchSprites) {
+			size_t flushes = 0, count = 0;
+			std::unordered_set<const Texture2D*> bound;
+			for(size_t i = 0; i < data.spriteCount; i++) {
+				const Texture2D* texture = data.texture[i].get();
+				const bool newTexture = !bound.count(texture);
+				if(count == batchSprites || (newTexture && bound.size() == slots)) {
+					flushes++;
+					count = 0;
+					bound.clear();
+				}
+				bound.insert(texture);
+				count++;
+			}
+			return flushes + (count ? 1 : 0);
+		}
+	}
+
+	OGL_BENCH(sprite_sort, "Sorts 100k sprites over 64 textures and 8 depth layers, counts the flushes they need before and after") {
+		// Textures only need distinct ids, the headless backend hands them out
+		headless::Init();
+		{
+			constexpr size_t count = 100'000;
+			std::vector<std::shared_ptr<Texture2D>> textures;
+			for(int i = 0; i < 64; i++) textures.push_back(std::make_shared<Texture2D>(Image(1, 1), false));
+
+			std::mt19937 rng(1);
+			std::vector<Vector3f> pos(count);
+			std::vector<Vector2f> size(count, { 16.0f, 16.0f });
+			std::vector<Vector4f> col(count, { 1.0f, 1.0f, 1.0f, 1.0f });
+			std::vector<TexCoords> texCoords(count, TexCoords{ { 0.0f, 0.0f }, { 1.0f, 1.0f } });
+			std::vector<std::shared_ptr<Texture2D>> spriteTextures(count);
+			std::vector<SpriteBlend> blend(count);
+			for(size_t i = 0; i < count; i++) {
+				pos[i] = { (float)(rng() % 1920), (float)(rng() % 1080), (float)(rng() % 8) };
+				spriteTextures[i] = textures[rng() % textures.size()];
+				blend[i] = rng() % 2 ? SpriteBlend::Opaque : SpriteBlend::Translucent;
+			}
+			const RendererSpriteData data(pos.data(), size.data(), col.data(), texCoords.data(), spriteTextures.data(), count);
+
+			SpriteSorter sorter;
+			RendererSpriteData sorted = sorter.sort(data, blend.data());
+			const double ms = TimeBest(10, [&]() { sorted = sorter.sort(data, blend.data()); });
+
+			// Opaque first grouped by texture, then translucent back to front
+			// in submission order where depths are equal
+			const auto& order = sorter.order();
+			size_t misordered = 0;
+			for(size_t i = 1; i < count; i++) {
+				const uint32_t a = order[i - 1], b = order[i];
+				const bool aOpaque = blend[a] == SpriteBlend::Opaque, bOpaque = blend[b] == SpriteBlend::Opaque;
+				if(aOpaque && bOpaque) {
+					const uint32_t ta = data.texture[a]->get_renderer_id(), tb = data.texture[b]->get_renderer_id();
+					misordered += ta > tb || (ta == tb && pos[a].z > pos[b].z);
+				}
+				else if(!aOpaque && !bOpaque) {
+					misordered += pos[a].z > pos[b].z || (pos[a].z == pos[b].z && a > b);
+				}
+				else misordered += !aOpaque;
+			}
+			OGL_CHECK(misordered == 0, misordered, " sprites out of order");
+
+			const size_t before = CountFlushes(data, 16, OGL_2D_BATCH_MAX_SPRITES);
+			const size_t after = CountFlushes(sorted, 16, OGL_2D_BATCH_MAX_SPRITES);
+			Report("sort: ", count, " sprites in ", ms, " ms");
+			Report("flushes with 16 slots: ", before, " unsorted, ", after, " sorted");
+
+			// Everything opaque, sorting only has to group by texture
+			std::vector<SpriteBlend> opaque(count, SpriteBlend::Opaque);
+			const RendererSpriteData sortedOpaque = sorter.sort(data, opaque.data());
+			const size_t afterOpaque = CountFlushes(sortedOpaque, 16, OGL_2D_BATCH_MAX_SPRITES);
+			Report("flushes with 16 slots, all opaque: ", afterOpaque, " sorted");
+			OGL_CHECK(afterOpaque <= before, afterOpaque, " flushes sorted, ", before, " unsorted");
+		}
+		headless::Shutdown();
+	}
+}
@@ -0,0 +1,147 @@
+#include "bench.h"
+#include "render_bench.h"
+
+#include <random>
+#include <thread>
+#include <cstdlib>
+#include <filesystem>
+
+#include "util/image_loader.h"
+#include "graphics/2D/instance_renderer.h"
+
+namespace ogl::bench {
+
+	namespace {
+
+		struct Timeline {
+			// From the start of the run
+			double createdMs = 0.0;
+			// Both renderers' shaders are ready
+			double readyMs = 0.0;
+			double decodedMs = 0.0;
+			double firstFrameMs = 0.0;
+		};
+
+		void Widen(double range[2], double ms) {
+			range[0] = std::min(range[0], ms);
+			range[1] = std::max(range[1], ms);
+		}
+	}
+
+	OGL_BENCH(startup, "Times renderer creation, shader readiness, image decodes and the first frame of a startup with and without the decodes overlapping the shaders, run with --egl") {
+		if(!HasFlag("--egl")) {
+			Report("the headless backend compiles nothing, run it with --egl");
+			return;
+		}
+
+		const auto directory = std::filesystem::temp_directory_path() / "ogl_startup_bench";
+		std::filesystem::create_directories(directory);
+		std::error_code error;
+
+		// Noise, so decoding takes as long as it would for a real texture
+		std::vector<std::string> paths;
+		std::mt19937 rng(1);
+		for(int i = 0; i < 4; i++) {
+			Image image(1024, 1024);
+			for(int p = 0; p < 1024 * 1024; p++) image.data[p] = { (uint8_t)rng(), (uint8_t)rng(), (uint8_t)rng(), 255 };
+			paths.push_back((directory / ("image" + std::to_string(i) + ".png")).string());
+			image.write(paths.back().c_str());
+		}
+
+		// Each run gets a new context and an empty directory for Mesa's
+		// shader cache, so every run compiles (see program_cache)
+		int runIndex = 0;
+		const auto run = [&](bool overlap) -> std::optional<Timeline> {
+			const auto driverCache = directory / "driver" / std::to_string(runIndex++);
+			std::filesystem::create_directories(driverCache, error);
+#ifdef _WIN32
+			_putenv_s("MESA_SHADER_CACHE_DIR", driverCache.string().c_str());
+#else
+			setenv("MESA_SHADER_CACHE_DIR", driverCache.string().c_str(), 1);
+#endif
+			BenchGL gl;
+			if(!gl.context()) { Fail(); return std::nullopt; }
+			const GraphicsContext& context = *gl.context();
+			SpriteScene scene(1000, 1);
+
+			Timeline timeline;
+			std::vector<std::optional<Image>> images;
+			const auto start = Clock::now();
+
+			// Overlapped is the order Application::run uses: the decodes start
+			// first and the renderers' shaders are polled while waiting on them
+			std::optional<ImageLoader> loader;
+			std::vector<std::future<std::optional<Image>>> pending;
+			if(overlap) {
+				loader.emplace();
+				pending = loader->load_all(paths);
+			}
+
+			BatchRenderer2DSettings instanced;
+			instanced.mode = SpriteRenderMode::Instanced;
+			BatchRenderer2D renderers[2] = { { context, BatchRenderer2DSettings{} }, { context, instanced } };
+			timeline.createdMs = MillisecondsSince(start);
+
+			if(overlap) {
+				size_t decoded = 0;
+				bool ready = false;
+				while(decoded < pending.size() || !ready) {
+					if(!ready && renderers[0].is_ready() && renderers[1].is_ready()) {
+						ready = true;
+						timeline.readyMs = MillisecondsSince(start);
+					}
+					if(decoded < pending.size() && pending[decoded].wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+						images.push_back(pending[decoded++].get());
+						if(decoded == pending.size()) timeline.decodedMs = MillisecondsSince(start);
+						continue;
+					}
+					std::this_thread::sleep_for(std::chrono::microseconds(100));
+				}
+			} else {
+				// A first draw waits for the shaders, then the images decode.
+				// Its texture is made like the decoded ones, llvmpipe compiles
+				// another variant for other sampler state.
+				SpriteScene one(1, 1);
+				one.sprite_textures()[0] = std::make_shared<Texture2D>(Image(4, 4), true);
+				for(auto& renderer : renderers) {
+					renderer.process(one.data(), context);
+					renderer.flush(context);
+				}
+				gl.finish();
+				timeline.readyMs = MillisecondsSince(start);
+				for(const auto& path : paths) images.push_back(Image::open(path.c_str()));
+				timeline.decodedMs = MillisecondsSince(start);
+			}
+
+			std::vector<std::shared_ptr<Texture2D>> textures;
+			for(auto& image : images) if(image) textures.push_back(std::make_shared<Texture2D>(*image, true));
+			if(textures.size() != paths.size()) { Fail(); return std::nullopt; }
+			for(size_t i = 0; i < scene.size(); i++) scene.sprite_textures()[i] = textures[i % textures.size()];
+			for(auto& renderer : renderers) {
+				renderer.process(scene.data(), context);
+				renderer.flush(context);
+			}
+			gl.finish();
+			timeline.firstFrameMs = MillisecondsSince(start);
+			return timeline;
+		};
+
+		constexpr int runs = 3;
+		const char* names[2] = { "shaders, then decodes", "overlapped" };
+		for(int overlap = 0; overlap < 2; overlap++) {
+			double created[2] = { 1e30, 0.0 }, ready[2] = { 1e30, 0.0 }, decoded[2] = { 1e30, 0.0 }, firstFrame[2] = { 1e30, 0.0 };
+			for(int i = 0; i < runs; i++) {
+				const auto timeline = run(overlap);
+				if(!timeline) return;
+				Widen(created, timeline->createdMs);
+				Widen(ready, timeline->readyMs);
+				Widen(decoded, timeline->decodedMs);
+				Widen(firstFrame, timeline->firstFrameMs);
+			}
+			Report(names[overlap], ": created ", created[0], "-", created[1], " ms, shaders ready ", ready[0], "-", ready[1],
+				" ms, decoded ", decoded[0], "-", decoded[1], " ms, first frame ", firstFrame[0], "-", firstFrame[1], " ms, over ", runs, " runs");
+		}
+
+		std::filesystem::remove_all(directory, error);
+	}
+}
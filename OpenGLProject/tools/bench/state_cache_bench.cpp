@@ -0,0 +1,55 @@
+#include "bench.h"
+#include "render_bench.h"
+
+#include "graphics/gl_state.h"
+#include "graphics/2D/instance_renderer.h"
+
+namespace ogl::bench {
+
+	OGL_BENCH(state_cache, "Counts the GL calls and state changes of steady frames with and without ring streaming and the binds the state cache skips") {
+		BenchGL gl;
+		if(!gl.context()) { Fail(); return; }
+		if(!gl.headless()) {
+			Report("only counts GL calls, run it without --egl");
+			return;
+		}
+		const GraphicsContext& context = *gl.context();
+
+		struct Case {
+			size_t sprites, textures;
+			bool ring;
+		};
+		const Case cases[] = { { 1000, 1, false }, { 1000, 1, true }, { 25'000, 20, false }, { 25'000, 20, true } };
+
+		for(const Case& c : cases) {
+			SpriteScene scene(c.sprites, c.textures);
+			const RendererSpriteData data = scene.data();
+			BatchRenderer2DSettings settings;
+			settings.ringStreaming = c.ring;
+			BatchRenderer2D renderer(context, settings);
+
+			// Everything is bound by the first frame, a steady one binds nothing
+			renderer.process(data, context);
+			renderer.flush(context);
+
+			headless::ResetStats();
+			glstate::ResetStats();
+			renderer.process(data, context);
+			renderer.flush(context);
+
+			const HeadlessGLStats& stats = headless::Stats();
+			const GLStateStats& state = glstate::Stats();
+			const size_t elided = state.programBindsElided + state.vertexArrayBindsElided + state.bufferBindsElided
+				+ state.activeTexturesElided + state.textureBindsElided;
+			Report(c.sprites, " sprites, ", c.textures, " textures, ", c.ring ? "ring" : "orphan", ": ", stats.calls, " GL calls, ",
+				stats.stateChanges, " state changes (", stats.redundantStateChanges, " redundant), ", elided, " binds skipped");
+
+			OGL_CHECK(stats.redundantStateChanges == 0, stats.redundantStateChanges, " redundant state changes");
+			if(c.textures == 1) {
+				// The draw, a fence or the orphan and map, nothing bound
+				OGL_CHECK(stats.stateChanges == 0, stats.stateChanges, " state changes in a steady one texture frame");
+				OGL_CHECK(stats.calls <= 4, stats.calls, " GL calls in a steady one texture frame");
+			}
+		}
+	}
+}
@@ -0,0 +1,78 @@
+#include "bench.h"
+#include "render_bench.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "graphics/2D/instance_renderer.h"
+
+namespace ogl::bench {
+
+	OGL_BENCH(static_layer, "Builds a 500k tile static layer, edits it and compares drawing it with streaming the same tiles every frame") {
+		HeadlessGLDesc desc;
+		desc.recordCalls = true;
+		BenchGL gl(desc);
+		if(!gl.context()) { Fail(); return; }
+		const GraphicsContext& context = *gl.context();
+
+		SpriteScene scene(500'000, 4);
+		const RendererSpriteData data = scene.data();
+		BatchRenderer2D renderer(context);
+		constexpr double MB = 1024.0 * 1024.0;
+
+		auto start = Clock::now();
+		auto layer = renderer.create_static_layer(data);
+		const double buildMs = MillisecondsSince(start);
+		renderer.draw_static(*layer, context);
+		gl.finish();
+		Report("build: ", buildMs, " ms, ", layer->batch_count(), " batches, ", layer->uploaded_bytes() / MB, " MB initial upload");
+		OGL_CHECK(layer->size() == scene.size() && !layer->is_dirty());
+
+		// Nothing changed, so nothing is sent
+		renderer.reset_stats();
+		const double unchangedMs = TimeBest(5, [&]() {
+			renderer.draw_static(*layer, context);
+			gl.finish();
+		});
+		Report("unchanged frame: ", renderer.get_stats().staticUploadBytes, " bytes, ", unchangedMs, " ms to draw");
+		OGL_CHECK(renderer.get_stats().staticUploadBytes == 0, "an unchanged layer uploaded ", renderer.get_stats().staticUploadBytes, " bytes");
+
+		// 100 edits in two clusters of every other tile, each cluster merges
+		// into a single range of 99 tiles
+		for(size_t cluster : { (size_t)100'000, (size_t)400'000 }) {
+			for(size_t i = 0; i < 50; i++) {
+				const size_t tile = cluster + i * 2;
+				scene.positions()[tile].z += 0.05f;
+				OGL_CHECK(layer->set_sprites(tile, data.subset(tile, 1)), "tile ", tile, " no longer fits its batch");
+			}
+		}
+		if(gl.headless()) headless::ResetStats();
+		renderer.reset_stats();
+		start = Clock::now();
+		renderer.draw_static(*layer, context);
+		gl.finish();
+		const double editMs = MillisecondsSince(start);
+
+		const size_t editBytes = renderer.get_stats().staticUploadBytes;
+		Report("100 tile edits: ", editBytes / 1024.0, " KB, ", editMs, " ms to upload and draw");
+		OGL_CHECK(editBytes == 2 * 99 * 4 * sizeof(SpriteVertex), editBytes, " bytes uploaded for 2 ranges of 99 tiles");
+		if(gl.headless()) {
+			const auto& calls = headless::Calls();
+			const size_t subDataCalls = std::count_if(calls.begin(), calls.end(), [](const char* call) { return std::strcmp(call, "glBufferSubData") == 0; });
+			Report("100 tile edits: ", subDataCalls, " glBufferSubData calls");
+			OGL_CHECK(subDataCalls == 2, subDataCalls, " glBufferSubData calls for 2 ranges");
+		}
+
+		// What the same tiles cost when they are streamed every frame
+		renderer.process(data, context);
+		renderer.flush(context);
+		gl.finish();
+		renderer.reset_stats();
+		const double streamMs = TimeBest(5, [&]() {
+			renderer.process(data, context);
+			renderer.flush(context);
+			gl.finish();
+		});
+		Report("streaming the same tiles: ", streamMs, " ms and ", renderer.get_stats().vertexBytes / 5 / MB, " MB a frame");
+	}
+}
@@ -0,0 +1,106 @@
+#include "bench.h"
+
+#include <random>
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+
+#include "graphics/2D/texture_atlas.h"
+
+namespace ogl::bench {
+
+	namespace {
+
+		// Every pixel of an image is its index and position, so a misplaced
+		// pixel can't match by accident
+		std::vector<Image> RandomImages(size_t count, int minSize, int maxSize, uint32_t seed) {
+			std::mt19937 rng(seed);
+			std::uniform_int_distribution<int> sizes(minSize, maxSize);
+			std::vector<Image> images;
+			images.reserve(count);
+			for(size_t i = 0; i < count; i++) {
+				Image& image = images.emplace_back(sizes(rng), sizes(rng));
+				for(int y = 0; y < image.height; y++) {
+					for(int x = 0; x < image.width; x++) image.data[(size_t)y * image.width + x] = { (uint8_t)i, (uint8_t)(i >> 8), (uint8_t)x, (uint8_t)y };
+				}
+			}
+			return images;
+		}
+
+		// Checks image is at coords in the atlas and its padding repeats its edges
+		bool IsPlaced(const TextureAtlas& atlas, const Image& image, const TexCoords& coords, int padding) {
+			const Image& pixels = atlas.image();
+			const int x0 = (int)std::lround(coords.pos.x * pixels.width);
+			const int y0 = (int)std::lround(coords.pos.y * pixels.height);
+			if((int)std::lround(coords.size.x * pixels.width) != image.width || (int)std::lround(coords.size.y * pixels.height) != image.height) return false;
+
+			for(int y = -padding; y < image.height + padding; y++) {
+				for(int x = -padding; x < image.width + padding; x++) {
+					const int sx = std::clamp(x, 0, image.width - 1);
+					const int sy = std::clamp(y, 0, image.height - 1);
+					const auto& expected = image.data[(size_t)sy * image.width + sx];
+					const auto& actual = pixels.data[(size_t)(y0 + y) * pixels.width + x0 + x];
+					if(std::memcmp(&expected, &actual, sizeof(expected)) != 0) return false;
+				}
+			}
+			return true;
+		}
+	}
+
+	OGL_BENCH(texture_atlas, "Packs 10k small images into a 4096x4096 atlas incrementally and all at once, checks every pixel") {
+		constexpr int padding = 1;
+		const std::vector<Image> images = RandomImages(10'000, 4, 48, 1);
+
+		std::vector<const Image*> pointers;
+		for(const Image& image : images) pointers.push_back(&image);
+
+		{
+			TextureAtlas atlas(4096, 4096, padding);
+			std::optional<std::vector<TexCoords>> coords;
+			const auto start = Clock::now();
+			coords = atlas.insert_all(pointers);
+			const double ms = MillisecondsSince(start);
+
+			OGL_CHECK(coords, "insert_all didn't fit");
+			Report("insert_all: ", images.size(), " images in ", ms, " ms, occupancy ", atlas.occupancy() * 100.0f, "%");
+
+			size_t misplaced = 0;
+			for(size_t i = 0; coords && i < images.size(); i++) misplaced += !IsPlaced(atlas, images[i], (*coords)[i], padding);
+			OGL_CHECK(misplaced == 0, misplaced, " images misplaced");
+		}
+
+		{
+			TextureAtlas atlas(4096, 4096, padding);
+			std::vector<std::optional<TexCoords>> coords(images.size());
+			const auto start = Clock::now();
+			for(size_t i = 0; i < images.size(); i++) coords[i] = atlas.insert(images[i]);
+			const double ms = MillisecondsSince(start);
+
+			size_t failed = 0, misplaced = 0;
+			for(size_t i = 0; i < images.size(); i++) {
+				if(!coords[i]) failed++;
+				else misplaced += !IsPlaced(atlas, images[i], *coords[i], padding);
+			}
+			Report("insert: ", images.size() - failed, " images in ", ms, " ms, occupancy ", atlas.occupancy() * 100.0f, "%");
+			OGL_CHECK(failed == 0, failed, " images didn't fit");
+			OGL_CHECK(misplaced == 0, misplaced, " images misplaced");
+		}
+
+		{
+			// A set that doesn't fit leaves the atlas as it was
+			TextureAtlas atlas(256, 256, padding);
+			const Image first(32, 32);
+			OGL_CHECK(atlas.insert(first));
+			const Image before(atlas.image());
+			const float occupancy = atlas.occupancy();
+
+			OGL_CHECK(!atlas.insert_all(pointers), "10k images fit in 256x256");
+			OGL_CHECK(std::memcmp(before.data, atlas.image().data, (size_t)256 * 256 * sizeof(Image::pixel_t)) == 0, "a failed insert_all changed the pixels");
+			OGL_CHECK(atlas.occupancy() == occupancy, "a failed insert_all changed the occupancy");
+
+			// And the space is still free
+			const Image large(256 - 32 - padding * 4, 200);
+			OGL_CHECK(atlas.insert(large), "a failed insert_all used up space");
+		}
+	}
+}
@@ -0,0 +1,177 @@
+#include "bench.h"
+
+#include <random>
+#include <cstring>
+#include <fstream>
+#include <filesystem>
+
+#include "util/mipmap.h"
+#include "util/fileio.h"
+#include "util/texture_file.h"
+
+namespace ogl::bench {
+
+	namespace {
+
+		Image RandomImage(int width, int height, uint32_t seed) {
+			Image image(width, height);
+			std::mt19937 rng(seed);
+			for(int i = 0; i < width * height; i++) {
+				const uint32_t value = rng();
+				image.data[i] = { (uint8_t)value, (uint8_t)(value >> 8), (uint8_t)(value >> 16), (uint8_t)(value >> 24) };
+			}
+			return image;
+		}
+
+		bool SamePixels(const TextureFile::Level& level, const ImageView& image) {
+			if(level.width != (uint32_t)image.width || level.height != (uint32_t)image.height) return false;
+			const size_t rowBytes = (size_t)image.width * sizeof(Image::pixel_t);
+			for(int y = 0; y < image.height; y++) {
+				if(std::memcmp(level.data + (size_t)y * rowBytes, image.row(y), rowBytes) != 0) return false;
+			}
+			return true;
+		}
+
+		// Bakes base and checks the file holds exactly base plus the mips
+		// BuildMipChain makes for the same settings
+		void CheckRoundTrip(const char* name, const std::string& path, const ImageView& image, const TextureBakeSettings& settings) {
+			OGL_CHECK(BakeTexture(image, path.c_str(), settings), name);
+			const auto file = TextureFile::open(path.c_str());
+			OGL_CHECK(file, name);
+			if(!file) return;
+
+			// What the baker should have stored
+			Image base(image);
+			if(settings.premultiplyAlpha) PremultiplyAlpha(base, settings.colourSpace);
+			std::vector<Image> mips;
+			if(settings.generateMipMaps) mips = BuildMipChain(base, settings.levelCount, { settings.mipFilter, settings.colourSpace });
+
+			OGL_CHECK(file->format() == TextureFileFormat::RGBA8, name);
+			OGL_CHECK(file->width() == (uint32_t)image.width && file->height() == (uint32_t)image.height, name);
+			OGL_CHECK(file->level_count() == mips.size() + 1, name, ", ", file->level_count(), " levels");
+			OGL_CHECK(file->is_srgb() == (settings.colourSpace == ColourSpace::SRGB), name);
+			OGL_CHECK(file->is_premultiplied() == settings.premultiplyAlpha, name);
+			if(file->level_count() != mips.size() + 1) return;
+
+			OGL_CHECK(SamePixels(file->level(0), base), name, ", level 0");
+			for(uint32_t i = 1; i < file->level_count(); i++) {
+				const auto level = file->level(i);
+				OGL_CHECK(level.width == (uint32_t)MipSize(image.width, i) && level.height == (uint32_t)MipSize(image.height, i), name, ", level ", i);
+				OGL_CHECK((uintptr_t)level.data % 16 == 0, name, ", level ", i, " isn't aligned");
+				OGL_CHECK(SamePixels(level, mips[i - 1]), name, ", level ", i);
+			}
+		}
+
+		void WriteBytes(const std::string& path, const std::vector<uint8_t>& bytes) {
+			std::ofstream(path, std::ios::binary).write((const char*)bytes.data(), (std::streamsize)bytes.size());
+		}
+
+		// Applies corrupt to a copy of a valid file and checks open rejects it
+		template<typename Fn>
+		void CheckRejected(const char* name, const std::string& path, const std::vector<uint8_t>& valid, Fn&& corrupt) {
+			std::vector<uint8_t> bytes = valid;
+			corrupt(bytes);
+			WriteBytes(path, bytes);
+			OGL_CHECK(!TextureFile::open(path.c_str()), name, " was accepted");
+		}
+
+		TextureFileHeader& HeaderOf(std::vector<uint8_t>& bytes) { return *(TextureFileHeader*)bytes.data(); }
+		TextureFileLevel& LevelOf(std::vector<uint8_t>& bytes, uint32_t index) {
+			return ((TextureFileLevel*)(bytes.data() + sizeof(TextureFileHeader)))[index];
+		}
+	}
+
+	OGL_BENCH(texture_file, "Round trips images through BakeTexture and TextureFile::open, and checks open rejects broken files") {
+		const auto directory = std::filesystem::temp_directory_path() / "ogl_texture_file_bench";
+		std::filesystem::create_directories(directory);
+		const std::string path = (directory / "test.ogltex").string();
+
+		// Not a power of two, so mip sizes round down
+		const Image image = RandomImage(37, 23, 1);
+
+		{
+			TextureBakeSettings settings;
+			CheckRoundTrip("full chain", path, image, settings);
+			const auto file = TextureFile::open(path.c_str());
+			OGL_CHECK(file && file->level_count() == MipLevelCount(37, 23));
+
+			settings.levelCount = 3;
+			CheckRoundTrip("partial chain", path, image, settings);
+
+			settings.generateMipMaps = false;
+			CheckRoundTrip("no mips", path, image, settings);
+		}
+
+		{
+			// Rows of a sub view aren't next to each other, the file's must be
+			const Image larger = RandomImage(64, 64, 2);
+			const ImageView view = larger.view(5, 7, 20, 13);
+			CheckRoundTrip("sub view", path, view, {});
+		}
+
+		{
+			TextureBakeSettings settings;
+			settings.colourSpace = ColourSpace::SRGB;
+			CheckRoundTrip("srgb", path, image, settings);
+
+			settings.premultiplyAlpha = true;
+			CheckRoundTrip("srgb premultiplied", path, image, settings);
+
+			settings.colourSpace = ColourSpace::Linear;
+			settings.mipFilter = ResampleFilter::Kaiser;
+			CheckRoundTrip("premultiplied kaiser", path, image, settings);
+		}
+
+		{
+			// Compressed levels hold exactly what CompressImage makes of each level
+			TextureBakeSettings settings;
+			settings.format = TextureFileFormat::BC3;
+			OGL_CHECK(BakeTexture(image, path.c_str(), settings));
+			const auto file = TextureFile::open(path.c_str());
+			OGL_CHECK(file && file->format() == TextureFileFormat::BC3 && file->level_count() == MipLevelCount(37, 23));
+			if(file) {
+				const auto mips = BuildMipChain(image);
+				for(uint32_t i = 0; i < file->level_count(); i++) {
+					const CompressedImage expected = CompressImage(i ? mips[i - 1].view() : image.view(), BlockFormat::BC3);
+					const auto level = file->level(i);
+					OGL_CHECK(level.size == expected.data.size() && std::memcmp(level.data, expected.data.data(), level.size) == 0, "BC3 level ", i);
+				}
+			}
+		}
+
+		// Every way open can refuse a file, starting from a valid one
+		OGL_CHECK(BakeTexture(image, path.c_str()));
+		const auto readBack = ReadFile(path.c_str());
+		OGL_CHECK(readBack);
+		if(readBack) {
+			const std::vector<uint8_t> valid(readBack->begin(), readBack->end());
+			const std::string brokenPath = (directory / "broken.ogltex").string();
+
+			OGL_CHECK(!TextureFile::open((directory / "missing.ogltex").string().c_str()), "missing file was opened");
+
+			CheckRejected("short header", brokenPath, valid, [](auto& b) { b.resize(sizeof(TextureFileHeader) - 1); });
+			CheckRejected("bad magic", brokenPath, valid, [](auto& b) { HeaderOf(b).magic ^= 1; });
+			CheckRejected("bad version", brokenPath, valid, [](auto& b) { HeaderOf(b).version++; });
+			CheckRejected("bad format", brokenPath, valid, [](auto& b) { HeaderOf(b).format = (TextureFileFormat)4; });
+			CheckRejected("unknown flags", brokenPath, valid, [](auto& b) { HeaderOf(b).flags |= 1u << 31; });
+			CheckRejected("zero width", brokenPath, valid, [](auto& b) { HeaderOf(b).width = 0; });
+			CheckRejected("zero levels", brokenPath, valid, [](auto& b) { HeaderOf(b).levelCount = 0; });
+			CheckRejected("too many levels", brokenPath, valid, [](auto& b) { HeaderOf(b).levelCount = 33; });
+			CheckRejected("truncated table", brokenPath, valid, [](auto& b) { b.resize(sizeof(TextureFileHeader) + sizeof(TextureFileLevel) * 2); });
+			CheckRejected("bad level width", brokenPath, valid, [](auto& b) { LevelOf(b, 1).width++; });
+			CheckRejected("bad level height", brokenPath, valid, [](auto& b) { LevelOf(b, 2).height--; });
+			CheckRejected("bad level byte size", brokenPath, valid, [](auto& b) { LevelOf(b, 0).size += 4; });
+			CheckRejected("level offset in the table", brokenPath, valid, [](auto& b) { LevelOf(b, 0).offset = 0; });
+			CheckRejected("level offset past the end", brokenPath, valid, [](auto& b) { LevelOf(b, 1).offset = b.size() + 16; });
+			CheckRejected("level offset wrapping", brokenPath, valid, [](auto& b) { LevelOf(b, 1).offset = ~0ull - 8; });
+			CheckRejected("truncated payload", brokenPath, valid, [](auto& b) { b.pop_back(); });
+
+			// And the untouched bytes still open, so the rejections above are down to the corruption
+			WriteBytes(brokenPath, valid);
+			OGL_CHECK(TextureFile::open(brokenPath.c_str()), "valid copy was rejected");
+		}
+
+		std::error_code error;
+		std::filesystem::remove_all(directory, error);
+	}
+}
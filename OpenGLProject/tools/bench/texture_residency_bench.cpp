@@ -0,0 +1,139 @@
+#include "bench.h"
+#include "render_bench.h"
+
+#include <thread>
+#include <filesystem>
+
+#include "graphics/texture_residency.h"
+
+namespace ogl::bench {
+
+	namespace {
+
+		constexpr int s_Size = 64;
+		constexpr size_t s_FullBytes = (size_t)s_Size * s_Size * 4;
+
+		// The handle shows the full texture rather than its placeholder
+		bool IsResident(const std::shared_ptr<Texture2D>& texture) { return texture->memory_size() == s_FullBytes; }
+
+		// Runs updates until loads loads have finished in total, with the
+		// budget lifted so waiting evicts nothing. Returns false on a timeout.
+		bool WaitForLoads(TextureResidency& residency, size_t loads) {
+			const size_t budget = residency.budget();
+			residency.set_budget(SIZE_MAX);
+			const auto start = Clock::now();
+			while(residency.stats().loads < loads && MillisecondsSince(start) < 5000.0) {
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+				residency.update();
+			}
+			residency.set_budget(budget);
+			return residency.stats().loads >= loads;
+		}
+	}
+
+	OGL_BENCH(texture_residency, "Checks TextureResidency evicts in LRU order, keeps last frame's textures, reloads, drops released and failed loads and counts it all") {
+		BenchGL gl;
+		if(!gl.context()) { Fail(); return; }
+
+		const auto directory = std::filesystem::temp_directory_path() / "ogl_texture_residency_bench";
+		std::filesystem::create_directories(directory);
+		std::vector<std::string> paths;
+		for(int i = 0; i < 8; i++) {
+			Image image(s_Size, s_Size);
+			for(int p = 0; p < s_Size * s_Size; p++) image.data[p] = { (uint8_t)(i * 30), 100, 200, 255 };
+			paths.push_back((directory / ("texture" + std::to_string(i) + ".png")).string());
+			image.write(paths.back().c_str());
+		}
+
+		const TextureAssetParams params = { false, FilterMode::Linear, FilterMode::Linear, WrapMode::ClampToEdge };
+		TextureResidencySettings settings;
+		settings.budgetBytes = 3 * s_FullBytes;
+		// Loads finish in the order they were requested
+		settings.loaderThreads = 1;
+
+		{
+			TextureResidency residency(settings);
+			std::vector<std::shared_ptr<Texture2D>> textures;
+			for(int i = 0; i < 6; i++) textures.push_back(residency.load(paths[i], params));
+			OGL_CHECK(residency.stats().loads == 0 && residency.stats().misses == 0, "textures were read before they were used");
+
+			// Used one per frame, so 0 is the least recently used
+			for(auto& texture : textures) {
+				texture->mark_used();
+				residency.set_budget(SIZE_MAX);
+				residency.update();
+				residency.set_budget(settings.budgetBytes);
+			}
+			if(!WaitForLoads(residency, 6)) { Fail(); return; }
+			OGL_CHECK(residency.stats().misses == 6 && residency.stats().hits == 0);
+
+			// Over budget by 3, the 3 used longest ago go
+			residency.update();
+			TextureResidencyStats stats = residency.stats();
+			OGL_CHECK(stats.evictions == 3, stats.evictions, " evictions");
+			OGL_CHECK(stats.residentBytes == 3 * s_FullBytes && stats.residentTextures == 3, stats.residentBytes, " bytes in ", stats.residentTextures, " textures resident");
+			for(int i = 0; i < 6; i++) OGL_CHECK(IsResident(textures[i]) == (i >= 3), "texture ", i, (i >= 3 ? " was evicted" : " is still resident"));
+
+			// Evicted textures load again on their next use
+			residency.reset_stats();
+			for(auto& texture : textures) texture->mark_used();
+			stats = residency.stats();
+			OGL_CHECK(stats.hits == 3 && stats.misses == 3, stats.hits, " hits and ", stats.misses, " misses");
+			OGL_CHECK(stats.hit_rate() == 0.5f);
+			if(!WaitForLoads(residency, 3)) { Fail(); return; }
+			for(int i = 0; i < 6; i++) OGL_CHECK(IsResident(textures[i]), "texture ", i, " isn't resident after it was used again");
+
+			// All 6 are used this frame, none can go even though they are over budget
+			residency.reset_stats();
+			for(auto& texture : textures) texture->mark_used();
+			residency.update();
+			stats = residency.stats();
+			OGL_CHECK(stats.evictions == 0 && stats.residentBytes == 6 * s_FullBytes, stats.evictions, " evictions of textures used last frame");
+			OGL_CHECK(stats.hits == 6 && stats.misses == 0, stats.hits, " hits and ", stats.misses, " misses");
+
+			// Only 4 and 5 are used now, 3 of the other 4 go
+			textures[4]->mark_used();
+			textures[5]->mark_used();
+			residency.update();
+			stats = residency.stats();
+			OGL_CHECK(stats.evictions == 3 && stats.residentBytes == 3 * s_FullBytes, stats.evictions, " evictions, ", stats.residentBytes, " bytes resident");
+			OGL_CHECK(IsResident(textures[4]) && IsResident(textures[5]), "a texture used last frame was evicted");
+
+			// Released while its load is in flight, the load is dropped. The
+			// next load can only finish after it.
+			residency.reset_stats();
+			residency.set_budget(SIZE_MAX);
+			auto released = residency.load(paths[6], params);
+			released->mark_used();
+			released.reset();
+			auto next = residency.load(paths[7], params);
+			next->mark_used();
+			if(!WaitForLoads(residency, 1)) { Fail(); return; }
+			for(int i = 0; i < 4; i++) residency.update();
+			stats = residency.stats();
+			OGL_CHECK(stats.loads == 1 && IsResident(next), stats.loads, " loads after releasing a texture that was loading");
+			OGL_CHECK(stats.residentBytes == 4 * s_FullBytes && stats.residentTextures == 4, stats.residentBytes, " bytes in ", stats.residentTextures, " textures resident");
+
+			// A file that isn't there keeps its placeholder and isn't tried again
+			residency.reset_stats();
+			auto missing = residency.load((directory / "missing.png").string(), params);
+			const size_t placeholderBytes = missing->memory_size();
+			missing->mark_used();
+			auto after = residency.load(paths[6], params);
+			after->mark_used();
+			if(!WaitForLoads(residency, 1)) { Fail(); return; }
+			for(int i = 0; i < 4; i++) residency.update();
+			missing->mark_used();
+			residency.update();
+			stats = residency.stats();
+			OGL_CHECK(!IsResident(missing) && missing->memory_size() == placeholderBytes, "a failed load replaced its placeholder");
+			OGL_CHECK(stats.loads == 1 && stats.misses == 3, stats.loads, " loads and ", stats.misses, " misses with a failed load");
+			OGL_CHECK(IsResident(after), "the load after a failed one didn't finish");
+
+			Report("final: ", stats.residentTextures, " textures and ", stats.residentBytes, " bytes resident, ", stats.placeholderBytes, " placeholder bytes");
+		}
+
+		std::error_code error;
+		std::filesystem::remove_all(directory, error);
+	}
+}
@@ -0,0 +1,51 @@
+#include "bench.h"
+#include "render_bench.h"
+
+#include "graphics/2D/instance_renderer.h"
+
+namespace ogl::bench {
+
+	OGL_BENCH(texture_slots, "Checks the 2D renderer flushes once per full batch while textures fit in the slots and once per slots' worth of new textures when they don't") {
+		BenchGL gl;
+		if(!gl.context()) { Fail(); return; }
+		const GraphicsContext& context = *gl.context();
+		const size_t slots = (size_t)context.maxFragmentTextureSlots;
+		const size_t batch = OGL_2D_BATCH_MAX_SPRITES;
+		Report(slots, " texture slots, ", batch, " sprites a batch");
+
+		const auto ceilDiv = [](size_t a, size_t b) { return (a + b - 1) / b; };
+
+		struct Case {
+			const char* name;
+			size_t sprites, textures;
+			// Sprites in a row sharing a texture, 1 hands them out round robin
+			size_t run;
+			size_t expectedFlushes;
+		};
+		const Case cases[] = {
+			{ "one texture", 100'000, 1, 1, ceilDiv(100'000, batch) },
+			{ "as many textures as slots", 100'000, slots, 1, ceilDiv(100'000, batch) },
+			{ "uneven sprite count", 25'001, slots, 1, ceilDiv(25'001, batch) },
+			// Every sprite brings a texture the batch doesn't have yet
+			{ "4 more textures than slots", 25'000, slots + 4, 1, ceilDiv(25'000, slots) },
+			// Runs of 100, a new texture every run
+			{ "4x the slots in runs", 100'000, slots * 4, 100, ceilDiv(100'000 / 100, slots) },
+		};
+
+		for(const Case& c : cases) {
+			SpriteScene scene(c.sprites, c.textures);
+			for(size_t i = 0; i < c.sprites; i++) {
+				scene.sprite_textures()[i] = scene.textures()[i / c.run % c.textures];
+			}
+
+			BatchRenderer2D renderer(context, BatchRenderer2DSettings{});
+			renderer.process(scene.data(), context);
+			renderer.flush(context);
+			const BatchRenderer2DStats& stats = renderer.get_stats();
+
+			Report(c.name, ": ", c.sprites, " sprites, ", c.textures, " textures, ", stats.flushes, " flushes, ", stats.drawCalls, " draws");
+			OGL_CHECK(stats.flushes == c.expectedFlushes, c.name, ": ", stats.flushes, " flushes, expected ", c.expectedFlushes);
+			OGL_CHECK(stats.sprites == c.sprites, c.name, ": drew ", stats.sprites, " of ", c.sprites, " sprites");
+		}
+	}
+}
@@ -0,0 +1,56 @@
+#include "bench.h"
+#include "render_bench.h"
+
+#include <cstring>
+#include <map>
+#include <string>
+
+#include "graphics/2D/instance_renderer.h"
+
+namespace ogl::bench {
+
+	OGL_BENCH(uniform_calls, "Breaks down the GL calls of a steady 25k sprite, 20 texture frame and checks none look up or rebind uniforms") {
+		HeadlessGLDesc desc;
+		desc.recordCalls = true;
+		BenchGL gl(desc);
+		if(!gl.context()) { Fail(); return; }
+		if(!gl.headless()) {
+			Report("only counts GL calls, run it without --egl");
+			return;
+		}
+		const GraphicsContext& context = *gl.context();
+
+		// 16 texture slots and 20 textures, so batches are small: 1563 a frame
+		SpriteScene scene(25'000, 20);
+		const RendererSpriteData data = scene.data();
+		BatchRenderer2D renderer(context);
+
+		// The first frame uploads the projection and fills the ring
+		renderer.process(data, context);
+		renderer.flush(context);
+
+		headless::ResetStats();
+		renderer.process(data, context);
+		renderer.flush(context);
+
+		std::map<std::string, size_t> byName;
+		for(const char* call : headless::Calls()) byName[call]++;
+		const HeadlessGLStats& stats = headless::Stats();
+		Report(stats.calls, " GL calls, ", stats.drawCalls, " draws, ", stats.redundantStateChanges, " redundant state changes");
+		for(const auto& [name, count] : byName) Report("  ", name, ": ", count);
+
+		const auto count = [&](const char* name) { auto it = byName.find(name); return it == byName.end() ? (size_t)0 : it->second; };
+		size_t uniformSets = 0;
+		for(const auto& [name, n] : byName) {
+			if(name.find("Uniform") != std::string::npos && name.find("Block") == std::string::npos) uniformSets += n;
+		}
+
+		// The projection lives in a uniform buffer that is only sent when
+		// it changes, and locations were looked up when the shader linked
+		OGL_CHECK(count("glGetUniformLocation") == 0, count("glGetUniformLocation"), " uniform lookups in a frame");
+		OGL_CHECK(uniformSets == 0, uniformSets, " uniform sets in a steady frame");
+		OGL_CHECK(count("glUseProgram") <= 1, count("glUseProgram"), " program binds in a frame");
+		OGL_CHECK(stats.redundantStateChanges == 0, stats.redundantStateChanges, " redundant state changes");
+		OGL_CHECK(count("glBufferSubData") == 0 && count("glBufferData") == 0, "the projection was uploaded again");
+	}
+}
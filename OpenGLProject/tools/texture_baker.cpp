@@ -0,0 +1,59 @@
+// Offline texture baker, turns any image stb can read into a texture file
+// (see util/texture_file.h) that the engine maps and uploads directly.
+//
+//   TextureBaker <input image> <output.ogltex> [options]
+//
+//   --no-mips      only store the base level
+//   --levels N     store N levels including the base one
+//   --kaiser       filter mips with a Kaiser window instead of a box
+//   --srgb         the image is sRGB, mips are filtered in linear light
+//   --premultiply  multiply colour by alpha before building mips
+//   --format F     rgba8 (default), bc1, bc3 or bc7
+//   --hq           slower, higher quality block compression
+
+#include <cstring>
+#include <cstdlib>
+
+#include "core.h"
+#include "util/image.h"
+#include "util/texture_file.h"
+
+int main(int argc, char** argv) {
+	if(argc < 3) {
+		ogl::log::Info("Usage: ", argv[0], " <input image> <output", ogl::texture_file_extension, "> [--no-mips] [--levels N] [--kaiser] [--srgb] [--premultiply] [--format rgba8|bc1|bc3|bc7] [--hq]");
+		return 1;
+	}
+
+	ogl::TextureBakeSettings settings;
+	for(int i = 3; i < argc; i++) {
+		if(!strcmp(argv[i], "--no-mips")) settings.generateMipMaps = false;
+		else if(!strcmp(argv[i], "--levels") && i + 1 < argc) settings.levelCount = (uint32_t)atoi(argv[++i]);
+		else if(!strcmp(argv[i], "--kaiser")) settings.mipFilter = ogl::ResampleFilter::Kaiser;
+		else if(!strcmp(argv[i], "--srgb")) settings.colourSpace = ogl::ColourSpace::SRGB;
+		else if(!strcmp(argv[i], "--premultiply")) settings.premultiplyAlpha = true;
+		else if(!strcmp(argv[i], "--hq")) settings.compressionQuality = ogl::CompressionQuality::High;
+		else if(!strcmp(argv[i], "--format") && i + 1 < argc) {
+			const char* format = argv[++i];
+			if(!strcmp(format, "rgba8")) settings.format = ogl::TextureFileFormat::RGBA8;
+			else if(!strcmp(format, "bc1")) settings.format = ogl::TextureFileFormat::BC1;
+			else if(!strcmp(format, "bc3")) settings.format = ogl::TextureFileFormat::BC3;
+			else if(!strcmp(format, "bc7")) settings.format = ogl::TextureFileFormat::BC7;
+			else {
+				ogl::log::Error("Unknown format '", format, "'");
+				return 1;
+			}
+		}
+		else {
+			ogl::log::Error("Unknown option '", argv[i], "'");
+			return 1;
+		}
+	}
+
+	const auto image = ogl::Image::open(argv[1]);
+	if(!image) return 1;
+
+	if(!ogl::BakeTexture(*image, argv[2], settings)) return 1;
+
+	ogl::log::InfoFrom("TextureBaker", "Baked '", argv[1], "' (", image->width, "x", image->height, ") to '", argv[2], "'");
+	return 0;
+}
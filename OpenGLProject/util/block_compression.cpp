@@ -0,0 +1,638 @@
+#include "block_compression.h"
+
+#include <cmath>
+#include <cstring>
+#include <numeric>
+#include <algorithm>
+#include <execution>
+
+// Every encoder works the same way: pick two endpoints on a line through the
+// block's texels, quantise them to the format, then give each texel the index
+// of the nearest colour the decoder interpolates between them. Fast takes the
+// line from the bounding box of the block. High takes it from the principal
+// axis of the texels and then moves the endpoints to the least squares fit of
+// the chosen indices, keeping whichever result has the lowest error.
+
+namespace ogl {
+
+	namespace {
+
+		// Rows of blocks handed to each parallel job
+		constexpr int s_BlockRowsPerBand = 16;
+
+		constexpr int s_LeastSquaresPasses = 2;
+
+		// Texels as floats in [0, 255]
+		using Texels = float[16][4];
+
+		void LoadTexels(const Image::pixel_t* pixels, Texels& texels) {
+			for(int i = 0; i < 16; i++) {
+				texels[i][0] = pixels[i].x;
+				texels[i][1] = pixels[i].y;
+				texels[i][2] = pixels[i].z;
+				texels[i][3] = pixels[i].w;
+			}
+		}
+
+		float Clamp255(float value) { return value < 0.0f ? 0.0f : (value > 255.0f ? 255.0f : value); }
+
+		float DistanceSquared(const float* a, const float* b, int channels) {
+			float sum = 0.0f;
+			for(int c = 0; c < channels; c++) sum += (a[c] - b[c]) * (a[c] - b[c]);
+			return sum;
+		}
+
+		/* ENDPOINT FITTING */
+
+		// Diagonal of the bounding box of the used texels, flipped per
+		// channel to follow the way each channel correlates with the one
+		// that varies most. Inset a little as the extremes are rarely worth
+		// spending an endpoint on.
+		void FitBoundingBox(const Texels& texels, const bool* used, int channels, float* e0, float* e1) {
+			float low[4] = { 255.0f, 255.0f, 255.0f, 255.0f }, high[4] = {}, mean[4] = {};
+			int count = 0;
+			for(int i = 0; i < 16; i++) {
+				if(!used[i]) continue;
+				count++;
+				for(int c = 0; c < channels; c++) {
+					low[c] = std::min(low[c], texels[i][c]);
+					high[c] = std::max(high[c], texels[i][c]);
+					mean[c] += texels[i][c];
+				}
+			}
+			for(int c = 0; c < channels; c++) mean[c] /= (float)count;
+
+			int widest = 0;
+			for(int c = 1; c < channels; c++)
+				if(high[c] - low[c] > high[widest] - low[widest]) widest = c;
+
+			for(int c = 0; c < channels; c++) {
+				float covariance = 0.0f;
+				for(int i = 0; i < 16; i++)
+					if(used[i]) covariance += (texels[i][c] - mean[c]) * (texels[i][widest] - mean[widest]);
+
+				const float inset = (high[c] - low[c]) / 16.0f;
+				const float top = high[c] - inset, bottom = low[c] + inset;
+				e0[c] = covariance < 0.0f ? bottom : top;
+				e1[c] = covariance < 0.0f ? top : bottom;
+			}
+		}
+
+		// Endpoints at the furthest texels along the principal axis.
+		// Returns false if the texels have no axis (they are all the same).
+		bool FitPrincipalAxis(const Texels& texels, const bool* used, int channels, float* e0, float* e1) {
+			float mean[4] = {};
+			int count = 0;
+			for(int i = 0; i < 16; i++) {
+				if(!used[i]) continue;
+				count++;
+				for(int c = 0; c < channels; c++) mean[c] += texels[i][c];
+			}
+			for(int c = 0; c < channels; c++) mean[c] /= (float)count;
+
+			float covariance[4][4] = {};
+			for(int i = 0; i < 16; i++) {
+				if(!used[i]) continue;
+				for(int a = 0; a < channels; a++)
+					for(int b = 0; b < channels; b++)
+						covariance[a][b] += (texels[i][a] - mean[a]) * (texels[i][b] - mean[b]);
+			}
+
+			// Power iteration, starting from the bounding box diagonal
+			float axis[4] = {}, start0[4], start1[4];
+			FitBoundingBox(texels, used, channels, start0, start1);
+			for(int c = 0; c < channels; c++) axis[c] = start0[c] - start1[c];
+			for(int iteration = 0; iteration < 8; iteration++) {
+				float next[4] = {}, length = 0.0f;
+				for(int a = 0; a < channels; a++) {
+					for(int b = 0; b < channels; b++) next[a] += covariance[a][b] * axis[b];
+					length += next[a] * next[a];
+				}
+				if(length < 1e-12f) return false;
+				length = 1.0f / std::sqrt(length);
+				for(int c = 0; c < channels; c++) axis[c] = next[c] * length;
+			}
+
+			float low = 1e30f, high = -1e30f;
+			for(int i = 0; i < 16; i++) {
+				if(!used[i]) continue;
+				float t = 0.0f;
+				for(int c = 0; c < channels; c++) t += (texels[i][c] - mean[c]) * axis[c];
+				low = std::min(low, t);
+				high = std::max(high, t);
+			}
+
+			for(int c = 0; c < channels; c++) {
+				e0[c] = Clamp255(mean[c] + axis[c] * high);
+				e1[c] = Clamp255(mean[c] + axis[c] * low);
+			}
+			return true;
+		}
+
+		// Endpoints that minimise the squared error of the texels for fixed
+		// interpolation weights, weights[i] is how much of e0 texel i gets.
+		// Returns false if the weights don't pin the endpoints down.
+		bool FitLeastSquares(const Texels& texels, const bool* used, const float* weights, int channels, float* e0, float* e1) {
+			float aa = 0.0f, bb = 0.0f, ab = 0.0f, ax[4] = {}, bx[4] = {};
+			for(int i = 0; i < 16; i++) {
+				if(!used[i]) continue;
+				const float a = weights[i], b = 1.0f - weights[i];
+				aa += a * a;
+				bb += b * b;
+				ab += a * b;
+				for(int c = 0; c < channels; c++) {
+					ax[c] += a * texels[i][c];
+					bx[c] += b * texels[i][c];
+				}
+			}
+
+			const float determinant = aa * bb - ab * ab;
+			if(std::abs(determinant) < 1e-6f) return false;
+
+			const float inverse = 1.0f / determinant;
+			for(int c = 0; c < channels; c++) {
+				e0[c] = Clamp255((ax[c] * bb - bx[c] * ab) * inverse);
+				e1[c] = Clamp255((bx[c] * aa - ax[c] * ab) * inverse);
+			}
+			return true;
+		}
+
+		/* BC1 COLOUR */
+
+		uint16_t Pack565(const float* colour) {
+			const uint32_t r = (uint32_t)(colour[0] * 31.0f / 255.0f + 0.5f);
+			const uint32_t g = (uint32_t)(colour[1] * 63.0f / 255.0f + 0.5f);
+			const uint32_t b = (uint32_t)(colour[2] * 31.0f / 255.0f + 0.5f);
+			return (uint16_t)((r << 11) | (g << 5) | b);
+		}
+
+		void Unpack565(uint16_t packed, int* colour) {
+			const int r = (packed >> 11) & 31, g = (packed >> 5) & 63, b = packed & 31;
+			colour[0] = (r << 3) | (r >> 2);
+			colour[1] = (g << 2) | (g >> 4);
+			colour[2] = (b << 3) | (b >> 2);
+		}
+
+		// The 4 colours a BC1 colour block decodes to. With c0 <= c1 the
+		// block has 3 colours and index 3 is transparent black.
+		void ColourPalette(uint16_t c0, uint16_t c1, int (&palette)[4][4]) {
+			Unpack565(c0, palette[0]);
+			Unpack565(c1, palette[1]);
+			palette[0][3] = palette[1][3] = 255;
+			for(int c = 0; c < 3; c++) {
+				if(c0 > c1) {
+					palette[2][c] = (2 * palette[0][c] + palette[1][c] + 1) / 3;
+					palette[3][c] = (palette[0][c] + 2 * palette[1][c] + 1) / 3;
+				} else {
+					palette[2][c] = (palette[0][c] + palette[1][c] + 1) / 2;
+					palette[3][c] = 0;
+				}
+			}
+			palette[2][3] = 255;
+			palette[3][3] = c0 > c1 ? 255 : 0;
+		}
+
+		struct ColourFit {
+			uint16_t c0, c1;
+			uint8_t indices[16];
+			float error;
+		};
+
+		// Quantises the endpoints and picks indices. threeColour keeps the
+		// transparent index for the texels that aren't used.
+		ColourFit FitColourIndices(const Texels& texels, const bool* used, bool threeColour, const float* e0, const float* e1) {
+			ColourFit fit;
+			fit.c0 = Pack565(e0);
+			fit.c1 = Pack565(e1);
+			// The order of the endpoints is what picks the mode
+			if(threeColour ? fit.c0 > fit.c1 : fit.c0 < fit.c1) std::swap(fit.c0, fit.c1);
+
+			int palette[4][4];
+			ColourPalette(fit.c0, fit.c1, palette);
+			float paletteF[4][4];
+			for(int i = 0; i < 4; i++)
+				for(int c = 0; c < 4; c++) paletteF[i][c] = (float)palette[i][c];
+
+			// Equal endpoints can only mean 3 colour mode to the decoder, index 0 is the same in both
+			const int colours = threeColour || fit.c0 == fit.c1 ? 3 : 4;
+			fit.error = 0.0f;
+			for(int i = 0; i < 16; i++) {
+				if(!used[i]) {
+					fit.indices[i] = 3;
+					continue;
+				}
+				int best = 0;
+				float bestError = DistanceSquared(texels[i], paletteF[0], 3);
+				for(int j = 1; j < colours; j++) {
+					const float error = DistanceSquared(texels[i], paletteF[j], 3);
+					if(error < bestError) { best = j; bestError = error; }
+				}
+				fit.indices[i] = (uint8_t)best;
+				fit.error += bestError;
+			}
+			return fit;
+		}
+
+		ColourFit RefineColourFit(const Texels& texels, const bool* used, bool threeColour, ColourFit fit) {
+			static constexpr float s_FourColourWeights[4] = { 1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f };
+			static constexpr float s_ThreeColourWeights[4] = { 1.0f, 0.0f, 0.5f, 0.0f };
+			const bool fourColour = fit.c0 > fit.c1;
+
+			for(int pass = 0; pass < s_LeastSquaresPasses; pass++) {
+				float weights[16];
+				for(int i = 0; i < 16; i++)
+					weights[i] = (fourColour ? s_FourColourWeights : s_ThreeColourWeights)[fit.indices[i]];
+
+				float e0[4], e1[4];
+				if(!FitLeastSquares(texels, used, weights, 3, e0, e1)) break;
+				const ColourFit refined = FitColourIndices(texels, used, threeColour, e0, e1);
+				if(refined.error >= fit.error) break;
+				fit = refined;
+			}
+			return fit;
+		}
+
+		void EncodeColourBlock(const Image::pixel_t* pixels, bool allowTransparent, CompressionQuality quality, uint8_t* out) {
+			Texels texels;
+			LoadTexels(pixels, texels);
+
+			bool used[16];
+			bool anyTransparent = false, anyUsed = false;
+			for(int i = 0; i < 16; i++) {
+				used[i] = !allowTransparent || pixels[i].w >= 128;
+				anyTransparent |= !used[i];
+				anyUsed |= used[i];
+			}
+
+			ColourFit fit;
+			if(!anyUsed) {
+				// Fully transparent, every index is the transparent one
+				fit.c0 = fit.c1 = 0;
+				std::fill(std::begin(fit.indices), std::end(fit.indices), (uint8_t)3);
+			} else {
+				float e0[4], e1[4];
+				FitBoundingBox(texels, used, 3, e0, e1);
+				fit = FitColourIndices(texels, used, anyTransparent, e0, e1);
+
+				if(quality == CompressionQuality::High) {
+					fit = RefineColourFit(texels, used, anyTransparent, fit);
+					if(FitPrincipalAxis(texels, used, 3, e0, e1)) {
+						const ColourFit axisFit = RefineColourFit(texels, used, anyTransparent,
+							FitColourIndices(texels, used, anyTransparent, e0, e1));
+						if(axisFit.error < fit.error) fit = axisFit;
+					}
+				}
+			}
+
+			uint32_t indices = 0;
+			for(int i = 0; i < 16; i++) indices |= (uint32_t)fit.indices[i] << (i * 2);
+			out[0] = (uint8_t)fit.c0;
+			out[1] = (uint8_t)(fit.c0 >> 8);
+			out[2] = (uint8_t)fit.c1;
+			out[3] = (uint8_t)(fit.c1 >> 8);
+			std::memcpy(out + 4, &indices, 4);
+		}
+
+		void DecodeColourBlock(const uint8_t* block, bool forceFourColour, Image::pixel_t* pixels) {
+			uint16_t c0 = (uint16_t)(block[0] | (block[1] << 8));
+			uint16_t c1 = (uint16_t)(block[2] | (block[3] << 8));
+			uint32_t indices;
+			std::memcpy(&indices, block + 4, 4);
+
+			int palette[4][4];
+			ColourPalette(c0, c1, palette);
+			if(forceFourColour && c0 <= c1) {
+				// BC3 colour is always 4 colours whatever the endpoint order
+				for(int c = 0; c < 3; c++) {
+					palette[2][c] = (2 * palette[0][c] + palette[1][c] + 1) / 3;
+					palette[3][c] = (palette[0][c] + 2 * palette[1][c] + 1) / 3;
+				}
+				palette[3][3] = 255;
+			}
+
+			for(int i = 0; i < 16; i++) {
+				const int* colour = palette[(indices >> (i * 2)) & 3];
+				pixels[i] = Image::pixel_t{ (uint8_t)colour[0], (uint8_t)colour[1], (uint8_t)colour[2], (uint8_t)colour[3] };
+			}
+		}
+
+		/* BC3 ALPHA */
+
+		// a0 > a1 interpolates 8 values, otherwise 6 values plus 0 and 255
+		void AlphaPalette(int a0, int a1, int (&palette)[8]) {
+			palette[0] = a0;
+			palette[1] = a1;
+			if(a0 > a1) {
+				for(int i = 1; i < 7; i++) palette[i + 1] = ((7 - i) * a0 + i * a1 + 3) / 7;
+			} else {
+				for(int i = 1; i < 5; i++) palette[i + 1] = ((5 - i) * a0 + i * a1 + 2) / 5;
+				palette[6] = 0;
+				palette[7] = 255;
+			}
+		}
+
+		int FitAlphaIndices(const Image::pixel_t* pixels, int a0, int a1, uint8_t* indices) {
+			int palette[8];
+			AlphaPalette(a0, a1, palette);
+			int error = 0;
+			for(int i = 0; i < 16; i++) {
+				int best = 0, bestError = 1 << 30;
+				for(int j = 0; j < 8; j++) {
+					const int difference = pixels[i].w - palette[j];
+					if(difference * difference < bestError) { best = j; bestError = difference * difference; }
+				}
+				indices[i] = (uint8_t)best;
+				error += bestError;
+			}
+			return error;
+		}
+
+		void EncodeAlphaBlock(const Image::pixel_t* pixels, CompressionQuality quality, uint8_t* out) {
+			int low = 255, high = 0;
+			for(int i = 0; i < 16; i++) {
+				low = std::min<int>(low, pixels[i].w);
+				high = std::max<int>(high, pixels[i].w);
+			}
+
+			uint8_t indices[16];
+			int a0 = high, a1 = low;
+			int error = FitAlphaIndices(pixels, a0, a1, indices);
+
+			// 6 value mode spends no steps on 0 and 255, which blocks with
+			// cut out edges are full of
+			if(quality == CompressionQuality::High && error > 0) {
+				int innerLow = 255, innerHigh = 0;
+				for(int i = 0; i < 16; i++) {
+					if(pixels[i].w == 0 || pixels[i].w == 255) continue;
+					innerLow = std::min<int>(innerLow, pixels[i].w);
+					innerHigh = std::max<int>(innerHigh, pixels[i].w);
+				}
+				if(innerLow <= innerHigh) {
+					uint8_t innerIndices[16];
+					const int innerError = FitAlphaIndices(pixels, innerLow, innerHigh, innerIndices);
+					if(innerError < error) {
+						a0 = innerLow;
+						a1 = innerHigh;
+						std::memcpy(indices, innerIndices, sizeof(indices));
+					}
+				}
+			}
+
+			uint64_t bits = 0;
+			for(int i = 0; i < 16; i++) bits |= (uint64_t)indices[i] << (i * 3);
+			out[0] = (uint8_t)a0;
+			out[1] = (uint8_t)a1;
+			for(int i = 0; i < 6; i++) out[2 + i] = (uint8_t)(bits >> (i * 8));
+		}
+
+		void DecodeAlphaBlock(const uint8_t* block, Image::pixel_t* pixels) {
+			int palette[8];
+			AlphaPalette(block[0], block[1], palette);
+			uint64_t bits = 0;
+			for(int i = 0; i < 6; i++) bits |= (uint64_t)block[2 + i] << (i * 8);
+			for(int i = 0; i < 16; i++) pixels[i].w = (uint8_t)palette[(bits >> (i * 3)) & 7];
+		}
+
+		/* BC7 MODE 6 */
+
+		constexpr int s_BC7Weights4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+		struct BitWriter {
+			uint8_t* out;
+			int position = 0;
+			void write(uint32_t value, int bits) {
+				for(int i = 0; i < bits; i++, position++)
+					if((value >> i) & 1) out[position / 8] |= (uint8_t)(1 << (position % 8));
+			}
+		};
+
+		struct BitReader {
+			const uint8_t* in;
+			int position = 0;
+			uint32_t read(int bits) {
+				uint32_t value = 0;
+				for(int i = 0; i < bits; i++, position++)
+					value |= (uint32_t)((in[position / 8] >> (position % 8)) & 1) << i;
+				return value;
+			}
+		};
+
+		struct BC7Endpoint {
+			uint8_t colour[4]; // 7 bits per channel
+			uint8_t pBit;
+			// The 8 bit value the decoder sees
+			int value(int channel) const { return (colour[channel] << 1) | pBit; }
+		};
+
+		// Quantises to 7 bits per channel with whichever shared p-bit gets closer
+		BC7Endpoint QuantiseBC7(const float* endpoint) {
+			BC7Endpoint best{};
+			float bestError = 1e30f;
+			for(uint8_t p = 0; p < 2; p++) {
+				BC7Endpoint candidate{};
+				candidate.pBit = p;
+				float error = 0.0f;
+				for(int c = 0; c < 4; c++) {
+					const int quantised = std::clamp((int)std::lround((endpoint[c] - p) / 2.0f), 0, 127);
+					candidate.colour[c] = (uint8_t)quantised;
+					const float difference = (float)candidate.value(c) - endpoint[c];
+					error += difference * difference;
+				}
+				if(error < bestError) { best = candidate; bestError = error; }
+			}
+			return best;
+		}
+
+		struct BC7Fit {
+			BC7Endpoint e0, e1;
+			uint8_t indices[16];
+			float error;
+		};
+
+		BC7Fit FitBC7Indices(const Texels& texels, const float* e0, const float* e1) {
+			BC7Fit fit;
+			fit.e0 = QuantiseBC7(e0);
+			fit.e1 = QuantiseBC7(e1);
+
+			float palette[16][4];
+			for(int i = 0; i < 16; i++)
+				for(int c = 0; c < 4; c++)
+					palette[i][c] = (float)(((64 - s_BC7Weights4[i]) * fit.e0.value(c) + s_BC7Weights4[i] * fit.e1.value(c) + 32) >> 6);
+
+			fit.error = 0.0f;
+			for(int i = 0; i < 16; i++) {
+				int best = 0;
+				float bestError = DistanceSquared(texels[i], palette[0], 4);
+				for(int j = 1; j < 16; j++) {
+					const float error = DistanceSquared(texels[i], palette[j], 4);
+					if(error < bestError) { best = j; bestError = error; }
+				}
+				fit.indices[i] = (uint8_t)best;
+				fit.error += bestError;
+			}
+			return fit;
+		}
+
+		BC7Fit RefineBC7Fit(const Texels& texels, const bool* used, BC7Fit fit) {
+			for(int pass = 0; pass < s_LeastSquaresPasses; pass++) {
+				float weights[16];
+				for(int i = 0; i < 16; i++) weights[i] = 1.0f - (float)s_BC7Weights4[fit.indices[i]] / 64.0f;
+
+				float e0[4], e1[4];
+				if(!FitLeastSquares(texels, used, weights, 4, e0, e1)) break;
+				const BC7Fit refined = FitBC7Indices(texels, e0, e1);
+				if(refined.error >= fit.error) break;
+				fit = refined;
+			}
+			return fit;
+		}
+
+		template<typename F>
+		void ForEachBlockBand(int blockRows, F&& func) {
+			std::vector<int> bands((blockRows + s_BlockRowsPerBand - 1) / s_BlockRowsPerBand);
+			std::iota(bands.begin(), bands.end(), 0);
+			std::for_each(std::execution::par, bands.begin(), bands.end(), [&](int band) {
+				const int first = band * s_BlockRowsPerBand;
+				func(first, std::min(first + s_BlockRowsPerBand, blockRows));
+			});
+		}
+	}
+
+	size_t BlockSize(BlockFormat format) { return format == BlockFormat::BC1 ? 8 : 16; }
+
+	size_t CompressedSize(BlockFormat format, int width, int height) {
+		return (size_t)((width + 3) / 4) * (size_t)((height + 3) / 4) * BlockSize(format);
+	}
+
+	void CompressBlockBC1(const Image::pixel_t* pixels, CompressionQuality quality, uint8_t* out) {
+		EncodeColourBlock(pixels, true, quality, out);
+	}
+
+	void CompressBlockBC3(const Image::pixel_t* pixels, CompressionQuality quality, uint8_t* out) {
+		EncodeAlphaBlock(pixels, quality, out);
+		EncodeColourBlock(pixels, false, quality, out + 8);
+	}
+
+	void CompressBlockBC7(const Image::pixel_t* pixels, CompressionQuality quality, uint8_t* out) {
+		Texels texels;
+		LoadTexels(pixels, texels);
+		bool used[16];
+		std::fill(std::begin(used), std::end(used), true);
+
+		float e0[4], e1[4];
+		FitBoundingBox(texels, used, 4, e0, e1);
+		BC7Fit fit = FitBC7Indices(texels, e0, e1);
+		if(quality == CompressionQuality::High) {
+			fit = RefineBC7Fit(texels, used, fit);
+			if(FitPrincipalAxis(texels, used, 4, e0, e1)) {
+				const BC7Fit axisFit = RefineBC7Fit(texels, used, FitBC7Indices(texels, e0, e1));
+				if(axisFit.error < fit.error) fit = axisFit;
+			}
+		}
+
+		// Texel 0's index only has 3 bits, so its top bit must be 0. Swapping
+		// the endpoints and flipping every index makes that true.
+		if(fit.indices[0] & 8) {
+			std::swap(fit.e0, fit.e1);
+			for(uint8_t& index : fit.indices) index = (uint8_t)(15 - index);
+		}
+
+		std::memset(out, 0, 16);
+		BitWriter writer{ out };
+		writer.write(1 << 6, 7);
+		for(int c = 0; c < 4; c++) {
+			writer.write(fit.e0.colour[c], 7);
+			writer.write(fit.e1.colour[c], 7);
+		}
+		writer.write(fit.e0.pBit, 1);
+		writer.write(fit.e1.pBit, 1);
+		writer.write(fit.indices[0], 3);
+		for(int i = 1; i < 16; i++) writer.write(fit.indices[i], 4);
+	}
+
+	void DecompressBlockBC1(const uint8_t* block, Image::pixel_t* pixels) {
+		DecodeColourBlock(block, false, pixels);
+	}
+
+	void DecompressBlockBC3(const uint8_t* block, Image::pixel_t* pixels) {
+		DecodeColourBlock(block + 8, true, pixels);
+		DecodeAlphaBlock(block, pixels);
+	}
+
+	void DecompressBlockBC7(const uint8_t* block, Image::pixel_t* pixels) {
+		// Mode is the number of 0 bits before the first 1
+		if((block[0] & 0x7f) != 1 << 6) {
+			std::fill(pixels, pixels + 16, Image::pixel_t{ 0, 0, 0, 0 });
+			return;
+		}
+
+		BitReader reader{ block };
+		reader.read(7);
+		int colour[2][4];
+		for(int c = 0; c < 4; c++) {
+			colour[0][c] = (int)reader.read(7);
+			colour[1][c] = (int)reader.read(7);
+		}
+		const int p0 = (int)reader.read(1), p1 = (int)reader.read(1);
+		for(int c = 0; c < 4; c++) {
+			colour[0][c] = (colour[0][c] << 1) | p0;
+			colour[1][c] = (colour[1][c] << 1) | p1;
+		}
+
+		for(int i = 0; i < 16; i++) {
+			const int weight = s_BC7Weights4[reader.read(i == 0 ? 3 : 4)];
+			uint8_t channels[4];
+			for(int c = 0; c < 4; c++) channels[c] = (uint8_t)(((64 - weight) * colour[0][c] + weight * colour[1][c] + 32) >> 6);
+			pixels[i] = Image::pixel_t{ channels[0], channels[1], channels[2], channels[3] };
+		}
+	}
+
+	CompressedImage CompressImage(const ImageView& image, BlockFormat format, CompressionQuality quality) {
+		CompressedImage result{ format, image.width, image.height, std::vector<uint8_t>(CompressedSize(format, image.width, image.height)) };
+
+		const auto compressBlock = format == BlockFormat::BC1 ? CompressBlockBC1
+			: format == BlockFormat::BC3 ? CompressBlockBC3 : CompressBlockBC7;
+		const int blocksWide = (image.width + 3) / 4;
+		const int blocksHigh = (image.height + 3) / 4;
+		const size_t blockSize = BlockSize(format);
+
+		ForEachBlockBand(blocksHigh, [&](int firstRow, int endRow) {
+			Image::pixel_t pixels[16];
+			for(int by = firstRow; by < endRow; by++) {
+				for(int bx = 0; bx < blocksWide; bx++) {
+					for(int y = 0; y < 4; y++) {
+						const Image::pixel_t* row = image.row(std::min(by * 4 + y, image.height - 1));
+						for(int x = 0; x < 4; x++) pixels[y * 4 + x] = row[std::min(bx * 4 + x, image.width - 1)];
+					}
+					compressBlock(pixels, quality, result.data.data() + ((size_t)by * blocksWide + bx) * blockSize);
+				}
+			}
+		});
+
+		return result;
+	}
+
+	Image DecompressImage(const uint8_t* data, int width, int height, BlockFormat format) {
+		Image result(width, height);
+
+		const auto decompressBlock = format == BlockFormat::BC1 ? DecompressBlockBC1
+			: format == BlockFormat::BC3 ? DecompressBlockBC3 : DecompressBlockBC7;
+		const int blocksWide = (width + 3) / 4;
+		const int blocksHigh = (height + 3) / 4;
+		const size_t blockSize = BlockSize(format);
+
+		ForEachBlockBand(blocksHigh, [&](int firstRow, int endRow) {
+			Image::pixel_t pixels[16];
+			for(int by = firstRow; by < endRow; by++) {
+				for(int bx = 0; bx < blocksWide; bx++) {
+					decompressBlock(data + ((size_t)by * blocksWide + bx) * blockSize, pixels);
+					for(int y = 0; y < 4 && by * 4 + y < height; y++)
+						for(int x = 0; x < 4 && bx * 4 + x < width; x++)
+							result.data[(size_t)(by * 4 + y) * width + bx * 4 + x] = pixels[y * 4 + x];
+				}
+			}
+		});
+
+		return result;
+	}
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <vector>
+
+#include "core.h"
+#include "util/image.h"
+
+namespace ogl {
+
+	// GPU block compressed formats. Every format stores 4x4 texel blocks
+	// that the GPU decodes when sampling, so they stay compressed in VRAM.
+	enum class BlockFormat {
+		// 8 bytes per block, RGB with 1 bit alpha. 1/8 the size of RGBA8.
+		BC1,
+		// 16 bytes per block, BC1 colour with interpolated 8 bit alpha. 1/4 the size of RGBA8.
+		BC3,
+		// 16 bytes per block. Only mode 6 (one RGBA endpoint pair, 16 steps)
+		// is written, which beats BC3 on opaque images but not where alpha
+		// varies independently of colour.
+		BC7
+	};
+
+	enum class CompressionQuality {
+		// Endpoints from the bounding box of each block
+		Fast,
+		// Endpoints along each block's principal axis, refined with least squares
+		High
+	};
+
+	struct CompressedImage {
+		BlockFormat format;
+		int width, height;
+		std::vector<uint8_t> data;
+	};
+
+	size_t BlockSize(BlockFormat format);
+	// Bytes an image of the given size takes, partial blocks count as whole ones
+	size_t CompressedSize(BlockFormat format, int width, int height);
+
+	// Compresses image with rows of blocks encoded in parallel. Blocks on the
+	// edges of images that aren't a multiple of 4 repeat the last row and
+	// column. Blocks are stored row by row in the same order as the pixels,
+	// so an Image's bottom up rows stay bottom up.
+	CompressedImage CompressImage(const ImageView& image, BlockFormat format, CompressionQuality quality = CompressionQuality::Fast);
+
+	// Decodes to RGBA8, used when the driver can't sample a format and to
+	// measure quality. BC7 blocks in modes other than 6 decode to zero.
+	Image DecompressImage(const uint8_t* data, int width, int height, BlockFormat format);
+
+	// Single block versions, pixels are the 16 texels of the block row by row
+	void CompressBlockBC1(const Image::pixel_t* pixels, CompressionQuality quality, uint8_t* out);
+	void CompressBlockBC3(const Image::pixel_t* pixels, CompressionQuality quality, uint8_t* out);
+	void CompressBlockBC7(const Image::pixel_t* pixels, CompressionQuality quality, uint8_t* out);
+
+	void DecompressBlockBC1(const uint8_t* block, Image::pixel_t* pixels);
+	void DecompressBlockBC3(const uint8_t* block, Image::pixel_t* pixels);
+	void DecompressBlockBC7(const uint8_t* block, Image::pixel_t* pixels);
+}
@@ -0,0 +1,47 @@
+#include "cpuid.h"
+
+#if defined(OGL_ARCH_X86) && defined(_MSC_VER)
+	#include <intrin.h>
+	#include <immintrin.h>
+#endif
+
+namespace ogl {
+
+	static CPUFeatures QueryCPUFeatures() {
+		CPUFeatures features;
+
+#if defined(OGL_ARCH_X86) && (defined(__clang__) || defined(__GNUC__))
+		__builtin_cpu_init();
+		features.sse2  = __builtin_cpu_supports("sse2");
+		features.sse41 = __builtin_cpu_supports("sse4.1");
+		features.avx   = __builtin_cpu_supports("avx");
+		features.avx2  = __builtin_cpu_supports("avx2");
+#elif defined(OGL_ARCH_X86) && defined(_MSC_VER)
+		int info[4];
+		__cpuid(info, 0);
+		const int maxLeaf = info[0];
+
+		__cpuid(info, 1);
+		features.sse2  = (info[3] & (1 << 26)) != 0;
+		features.sse41 = (info[2] & (1 << 19)) != 0;
+
+		// AVX also needs the OS to save the upper halves of the ymm registers
+		const bool osxsave = (info[2] & (1 << 27)) != 0;
+		const bool avxBit  = (info[2] & (1 << 28)) != 0;
+		const bool osYmm   = osxsave && (_xgetbv(0) & 0x6) == 0x6;
+		features.avx = avxBit && osYmm;
+
+		if(maxLeaf >= 7) {
+			__cpuidex(info, 7, 0);
+			features.avx2 = features.avx && (info[1] & (1 << 5)) != 0;
+		}
+#endif
+
+		return features;
+	}
+
+	const CPUFeatures& GetCPUFeatures() {
+		static const CPUFeatures features = QueryCPUFeatures();
+		return features;
+	}
+}
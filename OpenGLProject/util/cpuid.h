@@ -0,0 +1,20 @@
+#pragma once
+
+#include "core.h"
+
+namespace ogl {
+
+	// CPUFeatures describes the SIMD instruction sets the host CPU supports.
+	// Use it to pick between kernels at runtime instead of relying on the
+	// flags the binary was compiled with.
+	struct CPUFeatures {
+		bool sse2 = false;
+		bool sse41 = false;
+		bool avx = false;
+		bool avx2 = false;
+	};
+
+	// Queries the CPU the first time it is called. The result is cached so
+	// this is cheap enough to call from anywhere.
+	const CPUFeatures& GetCPUFeatures();
+}
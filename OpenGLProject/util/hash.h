@@ -0,0 +1,34 @@
+#pragma once
+
+#include <string_view>
+
+#include "core.h"
+
+namespace ogl {
+
+	constexpr uint64_t s_FNV1aOffset = 0xcbf29ce484222325ull;
+	constexpr uint64_t s_FNV1aPrime = 0x100000001b3ull;
+
+	// FNV-1a. Not a good hash for large inputs, but cheap for the short
+	// strings and keys it is used on. Pass the result back in as hash to
+	// hash several pieces as one. The byte version has its own name so a
+	// C string never ends up hashed as (pointer, size).
+	inline uint64_t HashBytesFNV1a(const void* data, size_t size, uint64_t hash = s_FNV1aOffset) {
+		const uint8_t* bytes = (const uint8_t*)data;
+		for(size_t i = 0; i < size; i++) {
+			hash ^= bytes[i];
+			hash *= s_FNV1aPrime;
+		}
+		return hash;
+	}
+
+	inline uint64_t HashFNV1a(std::string_view string, uint64_t hash = s_FNV1aOffset) {
+		return HashBytesFNV1a(string.data(), string.size(), hash);
+	}
+
+	// Hashes a trivially copyable value by its bytes
+	template<typename T>
+	uint64_t HashValueFNV1a(const T& value, uint64_t hash = s_FNV1aOffset) {
+		return HashBytesFNV1a(&value, sizeof(T), hash);
+	}
+}
@@ -1,90 +1,144 @@
-#pragma once
-
-#include "assert.h"
-#include <algorithm>
-#define STBI_FREE(x) free(x)
-#define STBI_MALLOC(x) malloc(x)
-#define STBI_REALLOC(ptr, size) realloc(ptr, size)
-#define STBIW_FREE(x) free(x)
-#define STBIW_MALLOC(x) malloc(x)
-#define STBIW_REALLOC(ptr, size) realloc(ptr, size)
-
-#include <optional>
-#include <cstring>
-#include <execution>
-
-#include "core.h"
-#include "math/vector.h"
-#include "util/stb_image.h"
-#include "util/stb_image_write.h"
-
-namespace ogl {
-
-	// TODO: Write move assignment operator
-
-	struct Image {
-
-		using pixel_t = Vector4<uint8_t>;
-		using iterator = pixel_t*;
-		using const_iterator = pixel_t*;
-	private:
-		Image(pixel_t* data, int width, int height) : data(data), width(width), height(height) {}
-	public:
-	
-		Image(const Image& other) : width(other.width), height(other.height) {
-			const size_t size = (size_t)width * (size_t)height;
-			data = new(STBI_MALLOC(size * sizeof(pixel_t))) pixel_t[size]; 
-			memcpy(data, other.data, size * sizeof(pixel_t));
-		}
-
-		Image(Image&& other) : data(other.data), width(other.width), height(other.height) { other.data = nullptr; }
-		// This constructor will copy the data pointed to by the data ptr. Memory will be allocated
-		Image(int width, int height, const pixel_t* data = nullptr) : width(width), height(height) {
-			size_t size = (size_t)width * (size_t)height;
-			this->data = new(STBI_MALLOC(size * sizeof(pixel_t))) pixel_t[size]; 
-			if (data != nullptr)
-				std::memcpy(this->data, data, size * sizeof(pixel_t));
-		}
-
-		~Image() {
-			if(data) stbi_image_free(data); 
-		}
-
-		bool write(const char* path) {
-			stbi_flip_vertically_on_write(1);
-			return stbi_write_png(path, width, height, 4, data, 0);
-		}
-
-		static std::optional<Image> open(FILE* file) {
-			stbi_set_flip_vertically_on_load(1);
-
-			int channels, width, height;
-			unsigned char* pre_data = stbi_load_from_file(file, &width, &height, &channels, 4);
-			if (pre_data == nullptr) {
-				log::Error("STBI Failed to read image file");
-				return std::nullopt;
-			}
-
-			size_t size = (size_t)width * (size_t)height;
-			pixel_t* data = new(STBI_MALLOC(size * sizeof(pixel_t))) pixel_t[size];
-			std::memcpy(data, pre_data, size * sizeof(pixel_t));
-			stbi_image_free(pre_data);
-
-			return Image(data, width, height);
-		}
-
-		static std::optional<Image> open(const char* file) {
-			FILE* fp = fopen(file, "rb");
-			if(!fp) { 
-				log::Error("Failed to open image '", file, "' for reading");
-				return std::nullopt;
-			}
-			SCOPE_DEFER([fp] { fclose(fp);  });
-
-			return Image::open(fp);
-		}
-
-		int width, height;
-		pixel_t* data;
-	};
-}
+#pragma once
+
+#include "assert.h"
+#include <algorithm>
+#define STBI_FREE(x) free(x)
+#define STBI_MALLOC(x) malloc(x)
+#define STBI_REALLOC(ptr, size) realloc(ptr, size)
+#define STBIW_FREE(x) free(x)
+#define STBIW_MALLOC(x) malloc(x)
+#define STBIW_REALLOC(ptr, size) realloc(ptr, size)
+
+#include <optional>
+#include <cstring>
+#include <execution>
+
+#include "core.h"
+#include "math/vector.h"
+#include "util/stb_image.h"
+#include "util/stb_image_write.h"
+
+namespace ogl {
+
+	// A window into the pixels of an Image, or any other RGBA8 buffer. Rows
+	// are stride pixels apart, so a sub-rectangle is viewed without copying
+	// anything. Owns nothing and is only valid while the pixels are.
+	struct ImageView {
+
+		using pixel_t = Vector4<uint8_t>;
+
+		ImageView(pixel_t* data, int width, int height, int stride) 
+			: width(width), height(height), stride(stride), data(data) {}
+		ImageView(pixel_t* data, int width, int height) : ImageView(data, width, height, width) {}
+
+		pixel_t* row(int y) const { return data + (size_t)y * (size_t)stride; }
+		pixel_t& at(int x, int y) const { return row(y)[x]; }
+
+		ImageView sub_view(int x, int y, int width, int height) const {
+			OGL_DEBUG_ASSERT(x >= 0 && y >= 0 && x + width <= this->width && y + height <= this->height, 
+				"Sub view is outside the view");
+			return ImageView(row(y) + x, width, height, stride);
+		}
+
+		// True if the rows follow each other with no gap, so the pixels can
+		// be treated as one block
+		bool is_contiguous() const { return stride == width || height <= 1; }
+
+		int width, height;
+		int stride;
+		pixel_t* data;
+	};
+
+	struct Image {
+
+		using pixel_t = Vector4<uint8_t>;
+		using iterator = pixel_t*;
+		using const_iterator = pixel_t*;
+	private:
+		// Takes ownership of data, which must have been allocated with STBI_MALLOC
+		Image(pixel_t* data, int width, int height) : width(width), height(height), data(data) {}
+	public:
+	
+		Image(const Image& other) : Image(other.width, other.height, other.data) {}
+		Image(Image&& other) noexcept : width(other.width), height(other.height), data(other.data) { other.data = nullptr; }
+
+		// This constructor will copy the data pointed to by the data ptr. Memory will be allocated
+		Image(int width, int height, const pixel_t* data = nullptr) : width(width), height(height) {
+			size_t size = (size_t)width * (size_t)height;
+			this->data = new(STBI_MALLOC(size * sizeof(pixel_t))) pixel_t[size]; 
+			if (data != nullptr)
+				std::memcpy(this->data, data, size * sizeof(pixel_t));
+		}
+
+		// Copies the pixels in view into a new image
+		explicit Image(const ImageView& view) : Image(view.width, view.height) {
+			if(view.is_contiguous()) {
+				std::memcpy(data, view.data, (size_t)width * (size_t)height * sizeof(pixel_t));
+				return;
+			}
+			for(int y = 0; y < height; y++)
+				std::memcpy(data + (size_t)y * (size_t)width, view.row(y), (size_t)width * sizeof(pixel_t));
+		}
+
+		Image& operator=(const Image& other) {
+			if(this != &other) *this = Image(other);
+			return *this;
+		}
+
+		Image& operator=(Image&& other) noexcept {
+			if(this == &other) return *this;
+			if(data) stbi_image_free(data);
+			width = other.width;
+			height = other.height;
+			data = other.data;
+			other.data = nullptr;
+			return *this;
+		}
+
+		~Image() {
+			if(data) stbi_image_free(data); 
+		}
+
+		// Views are as mutable as the image's pixels always were, a const
+		// Image only stops the image itself being reassigned
+		ImageView view() const { return ImageView(data, width, height); }
+		ImageView view(int x, int y, int width, int height) const { return view().sub_view(x, y, width, height); }
+		operator ImageView() const { return view(); }
+
+		bool write(const char* path) {
+			stbi_flip_vertically_on_write(1);
+			return stbi_write_png(path, width, height, 4, data, 0);
+		}
+
+		// Safe to call from any thread, the flip flag is set per thread
+		static std::optional<Image> open(FILE* file) {
+			stbi_set_flip_vertically_on_load_thread(1);
+
+			int channels, width, height;
+			unsigned char* data = stbi_load_from_file(file, &width, &height, &channels, 4);
+			if (data == nullptr) {
+				log::Error("STBI Failed to read image file: ", stbi_failure_reason());
+				return std::nullopt;
+			}
+
+			// stb allocates with STBI_MALLOC and 4 channels is exactly pixel_t,
+			// so the image takes the buffer over as is
+			static_assert(sizeof(pixel_t) == 4 * sizeof(stbi_uc));
+			return Image((pixel_t*)data, width, height);
+		}
+
+		static std::optional<Image> open(const char* file) {
+			FILE* fp = fopen(file, "rb");
+			if(!fp) { 
+				log::Error("Failed to open image '", file, "' for reading");
+				return std::nullopt;
+			}
+			SCOPE_DEFER([fp] { fclose(fp);  });
+
+			return Image::open(fp);
+		}
+
+		int width, height;
+		pixel_t* data;
+	};
+}
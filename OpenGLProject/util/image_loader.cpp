@@ -0,0 +1,15 @@
+#include "image_loader.h"
+
+namespace ogl {
+
+	std::future<std::optional<Image>> ImageLoader::load(std::string path) {
+		return m_Pool.submit([path = std::move(path)] { return Image::open(path.c_str()); });
+	}
+
+	std::vector<std::future<std::optional<Image>>> ImageLoader::load_all(const std::vector<std::string>& paths) {
+		std::vector<std::future<std::optional<Image>>> images;
+		images.reserve(paths.size());
+		for(const auto& path : paths) images.push_back(load(path));
+		return images;
+	}
+}
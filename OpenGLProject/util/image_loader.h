@@ -0,0 +1,37 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <future>
+#include <optional>
+
+#include "core.h"
+#include "util/image.h"
+#include "util/thread_pool.h"
+
+namespace ogl {
+
+	// Decodes images on a pool of worker threads. Reading the file and
+	// decoding both happen on a worker, the calling thread only gets the
+	// future back. Nothing here touches GL, so images are uploaded by
+	// constructing a Texture2D from the result on the context thread:
+	//
+	//   auto pending = loader.load("./sprite.png");
+	//   ...
+	//   if(auto image = pending.get()) Texture2D texture(*image);
+	class ImageLoader {
+	public:
+		// 0 starts one thread per hardware thread, leaving one for the caller
+		explicit ImageLoader(size_t threadCount = 0) : m_Pool(threadCount) {}
+
+		// The future holds nullopt if the file couldn't be opened or decoded
+		std::future<std::optional<Image>> load(std::string path);
+		// Queues every path in order, the futures line up with paths
+		std::vector<std::future<std::optional<Image>>> load_all(const std::vector<std::string>& paths);
+
+		size_t thread_count() const { return m_Pool.thread_count(); }
+
+	private:
+		ThreadPool m_Pool;
+	};
+}
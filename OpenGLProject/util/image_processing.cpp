@@ -0,0 +1,511 @@
+#include "image_processing.h"
+
+#include <cmath>
+#include <vector>
+#include <numeric>
+#include <algorithm>
+#include <execution>
+
+#include "util/cpuid.h"
+
+#ifdef OGL_ARCH_X86
+	#include <immintrin.h>
+#endif
+
+// Everything here works on rows so images can be split into bands of rows
+// that are processed in parallel. The integer kernels round exactly the same
+// way as their scalar versions and the float passes only ever multiply and
+// add in the same order, so every kernel gives the same bytes on every CPU.
+
+namespace ogl {
+
+	namespace {
+
+		// Output rows handed to each parallel job. Resize filters the source
+		// rows a band needs horizontally once per band, so the rows shared
+		// with the neighbouring bands are filtered twice. Larger bands waste
+		// less on that.
+		constexpr int s_RowsPerBand = 64;
+
+		constexpr int s_LinearToSRGBTableSize = 1 << 14;
+
+		struct ColourTables {
+			float byteToUnit[256];
+			float srgbToLinear[256];
+			// Indexed by a linear value scaled to the table size, fine
+			// enough that nearly every entry rounds like the exact curve
+			uint8_t linearToSRGB[s_LinearToSRGBTableSize];
+		};
+
+		float SRGBToLinearExact(float value) {
+			return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+		}
+
+		float LinearToSRGBExact(float value) {
+			return value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+		}
+
+		const ColourTables& GetColourTables() {
+			static const ColourTables tables = [] {
+				ColourTables tables;
+				for(int i = 0; i < 256; i++) {
+					tables.byteToUnit[i] = (float)i / 255.0f;
+					tables.srgbToLinear[i] = SRGBToLinearExact((float)i / 255.0f);
+				}
+				for(int i = 0; i < s_LinearToSRGBTableSize; i++) {
+					const float linear = (float)i / (float)(s_LinearToSRGBTableSize - 1);
+					tables.linearToSRGB[i] = (uint8_t)(LinearToSRGBExact(linear) * 255.0f + 0.5f);
+				}
+				return tables;
+			}();
+			return tables;
+		}
+
+		inline float Saturate(float value) { return value < 0.0f ? 0.0f : (value > 1.0f ? 1.0f : value); }
+
+		inline uint8_t UnitToByte(float value) { return (uint8_t)(Saturate(value) * 255.0f + 0.5f); }
+
+		inline uint8_t EncodeSRGB(const ColourTables& tables, float value) {
+			return tables.linearToSRGB[(int)(Saturate(value) * (float)(s_LinearToSRGBTableSize - 1) + 0.5f)];
+		}
+
+		template<typename F>
+		void ForEachBand(int rows, F&& func) {
+			std::vector<int> bands((rows + s_RowsPerBand - 1) / s_RowsPerBand);
+			std::iota(bands.begin(), bands.end(), 0);
+			std::for_each(std::execution::par, bands.begin(), bands.end(), [&](int band) {
+				const int first = band * s_RowsPerBand;
+				func(first, std::min(first + s_RowsPerBand, rows));
+			});
+		}
+
+		/* RESAMPLING */
+
+		// The source pixels and weights that make up each output pixel along
+		// one axis
+		struct FilterTaps {
+			std::vector<int> start;
+			std::vector<int> count;
+			std::vector<size_t> offset;
+			std::vector<float> weights;
+		};
+
+		constexpr float s_KaiserRadius = 3.0f;
+		constexpr float s_KaiserBeta = 4.0f;
+
+		// Modified Bessel function of the first kind, order 0
+		double BesselI0(double x) {
+			double sum = 1.0, term = 1.0;
+			const double quarterSquare = x * x * 0.25;
+			for(int k = 1; k < 32 && term > sum * 1e-12; k++) {
+				term *= quarterSquare / ((double)k * k);
+				sum += term;
+			}
+			return sum;
+		}
+
+		float FilterRadius(ResampleFilter filter) {
+			return filter == ResampleFilter::Kaiser ? s_KaiserRadius : 0.5f;
+		}
+
+		float FilterWeight(ResampleFilter filter, float x) {
+			if(filter == ResampleFilter::Box) return x >= -0.5f && x < 0.5f ? 1.0f : 0.0f;
+
+			if(std::abs(x) >= s_KaiserRadius) return 0.0f;
+			static const double invI0Beta = 1.0 / BesselI0(s_KaiserBeta);
+			const double ratio = x / s_KaiserRadius;
+			const double window = BesselI0(s_KaiserBeta * std::sqrt(1.0 - ratio * ratio)) * invI0Beta;
+			const double pix = 3.14159265358979323846 * x;
+			const double sinc = x == 0.0f ? 1.0 : std::sin(pix) / pix;
+			return (float)(sinc * window);
+		}
+
+		FilterTaps BuildFilterTaps(int sourceSize, int destSize, ResampleFilter filter) {
+			const float scale = (float)sourceSize / (float)destSize;
+			// Widened when shrinking so every source pixel contributes
+			const float filterScale = std::max(scale, 1.0f);
+			const float support = FilterRadius(filter) * filterScale;
+
+			FilterTaps taps;
+			taps.start.resize(destSize);
+			taps.count.resize(destSize);
+			taps.offset.resize(destSize);
+
+			std::vector<float> weights;
+			for(int i = 0; i < destSize; i++) {
+				const float center = ((float)i + 0.5f) * scale;
+				int first = std::max(0, (int)std::floor(center - support));
+				const int last = std::min(sourceSize - 1, (int)std::ceil(center + support));
+
+				weights.clear();
+				for(int j = first; j <= last; j++)
+					weights.push_back(FilterWeight(filter, ((float)j + 0.5f - center) / filterScale));
+
+				// Taps with no weight at either end are dropped
+				size_t begin = 0, end = weights.size();
+				while(begin < end && weights[begin] == 0.0f) begin++;
+				while(end > begin && weights[end - 1] == 0.0f) end--;
+
+				float sum = 0.0f;
+				for(size_t j = begin; j < end; j++) sum += weights[j];
+
+				taps.offset[i] = taps.weights.size();
+				if(sum == 0.0f) {
+					// Can only happen for a degenerate filter, use the nearest pixel
+					taps.start[i] = std::min(sourceSize - 1, (int)center);
+					taps.count[i] = 1;
+					taps.weights.push_back(1.0f);
+					continue;
+				}
+
+				// Renormalised so pixels clipped off at the edges don't darken them
+				taps.start[i] = first + (int)begin;
+				taps.count[i] = (int)(end - begin);
+				for(size_t j = begin; j < end; j++) taps.weights.push_back(weights[j] / sum);
+			}
+
+			return taps;
+		}
+
+		void DecodeRow(const ColourTables& tables, ColourSpace space, const Image::pixel_t* pixels, int width, float* out) {
+			const float* colourTable = space == ColourSpace::SRGB ? tables.srgbToLinear : tables.byteToUnit;
+			for(int x = 0; x < width; x++) {
+				const Image::pixel_t& pixel = pixels[x];
+				out[x * 4 + 0] = colourTable[pixel.x];
+				out[x * 4 + 1] = colourTable[pixel.y];
+				out[x * 4 + 2] = colourTable[pixel.z];
+				out[x * 4 + 3] = tables.byteToUnit[pixel.w];
+			}
+		}
+
+		void EncodeRow(const ColourTables& tables, ColourSpace space, const float* row, int width, Image::pixel_t* out) {
+			for(int x = 0; x < width; x++) {
+				const float* pixel = row + x * 4;
+				if(space == ColourSpace::SRGB) {
+					out[x] = Image::pixel_t{ EncodeSRGB(tables, pixel[0]), EncodeSRGB(tables, pixel[1]),
+						EncodeSRGB(tables, pixel[2]), UnitToByte(pixel[3]) };
+				} else {
+					out[x] = Image::pixel_t{ UnitToByte(pixel[0]), UnitToByte(pixel[1]),
+						UnitToByte(pixel[2]), UnitToByte(pixel[3]) };
+				}
+			}
+		}
+
+		// Filters a row of RGBA floats along x, writing one pixel per tap set
+		using HorizontalPassFn = void(*)(const float* row, const FilterTaps& taps, float* out);
+		// out += row * weight over count floats
+		using VerticalAccumulateFn = void(*)(const float* row, float weight, float* out, size_t count);
+
+		void HorizontalPassScalar(const float* row, const FilterTaps& taps, float* out) {
+			for(size_t i = 0; i < taps.start.size(); i++) {
+				const float* pixel = row + (size_t)taps.start[i] * 4;
+				const float* weights = taps.weights.data() + taps.offset[i];
+				float r = 0.0f, g = 0.0f, b = 0.0f, a = 0.0f;
+				for(int k = 0; k < taps.count[i]; k++, pixel += 4) {
+					r = r + pixel[0] * weights[k];
+					g = g + pixel[1] * weights[k];
+					b = b + pixel[2] * weights[k];
+					a = a + pixel[3] * weights[k];
+				}
+				out[i * 4 + 0] = r;
+				out[i * 4 + 1] = g;
+				out[i * 4 + 2] = b;
+				out[i * 4 + 3] = a;
+			}
+		}
+
+		void VerticalAccumulateScalar(const float* row, float weight, float* out, size_t count) {
+			for(size_t i = 0; i < count; i++) out[i] = out[i] + row[i] * weight;
+		}
+
+#ifdef OGL_ARCH_X86
+
+		// A pixel is exactly one xmm register, so each tap is one multiply and add
+		void HorizontalPassSSE2(const float* row, const FilterTaps& taps, float* out) {
+			for(size_t i = 0; i < taps.start.size(); i++) {
+				const float* pixel = row + (size_t)taps.start[i] * 4;
+				const float* weights = taps.weights.data() + taps.offset[i];
+				__m128 sum = _mm_setzero_ps();
+				for(int k = 0; k < taps.count[i]; k++, pixel += 4)
+					sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(pixel), _mm_set1_ps(weights[k])));
+				_mm_storeu_ps(out + i * 4, sum);
+			}
+		}
+
+		void VerticalAccumulateSSE2(const float* row, float weight, float* out, size_t count) {
+			const __m128 w = _mm_set1_ps(weight);
+			size_t i = 0;
+			for(; i + 4 <= count; i += 4)
+				_mm_storeu_ps(out + i, _mm_add_ps(_mm_loadu_ps(out + i), _mm_mul_ps(_mm_loadu_ps(row + i), w)));
+			for(; i < count; i++) out[i] = out[i] + row[i] * weight;
+		}
+
+		OGL_TARGET("avx")
+		void VerticalAccumulateAVX(const float* row, float weight, float* out, size_t count) {
+			const __m256 w = _mm256_set1_ps(weight);
+			size_t i = 0;
+			for(; i + 8 <= count; i += 8)
+				_mm256_storeu_ps(out + i, _mm256_add_ps(_mm256_loadu_ps(out + i), _mm256_mul_ps(_mm256_loadu_ps(row + i), w)));
+			for(; i < count; i++) out[i] = out[i] + row[i] * weight;
+
+			_mm256_zeroupper();
+		}
+
+#endif
+
+		HorizontalPassFn SelectHorizontalPass() {
+#ifdef OGL_ARCH_X86
+			if(GetCPUFeatures().sse2) return HorizontalPassSSE2;
+#endif
+			return HorizontalPassScalar;
+		}
+
+		VerticalAccumulateFn SelectVerticalAccumulate() {
+#ifdef OGL_ARCH_X86
+			const auto& cpu = GetCPUFeatures();
+			if(cpu.avx) return VerticalAccumulateAVX;
+			if(cpu.sse2) return VerticalAccumulateSSE2;
+#endif
+			return VerticalAccumulateScalar;
+		}
+	}
+
+	float SRGBToLinear(uint8_t value) { return GetColourTables().srgbToLinear[value]; }
+	uint8_t LinearToSRGB(float value) { return EncodeSRGB(GetColourTables(), value); }
+
+	Image Resize(const ImageView& source, int width, int height, const ResampleSettings& settings) {
+		OGL_ASSERT(width > 0 && height > 0, "Can't resize to an empty image");
+		Image result(width, height);
+
+		const FilterTaps columns = BuildFilterTaps(source.width, width, settings.filter);
+		const FilterTaps rows = BuildFilterTaps(source.height, height, settings.filter);
+
+		static const HorizontalPassFn horizontalPass = SelectHorizontalPass();
+		static const VerticalAccumulateFn verticalAccumulate = SelectVerticalAccumulate();
+		const ColourTables& tables = GetColourTables();
+		const size_t rowFloats = (size_t)width * 4;
+
+		ForEachBand(height, [&](int firstRow, int endRow) {
+			// Every source row the band reads, filtered along x
+			const int firstSource = rows.start[firstRow];
+			int endSource = firstSource;
+			for(int y = firstRow; y < endRow; y++) endSource = std::max(endSource, rows.start[y] + rows.count[y]);
+
+			std::vector<float> decoded((size_t)source.width * 4);
+			std::vector<float> filtered((size_t)(endSource - firstSource) * rowFloats);
+			for(int y = firstSource; y < endSource; y++) {
+				DecodeRow(tables, settings.colourSpace, source.row(y), source.width, decoded.data());
+				horizontalPass(decoded.data(), columns, filtered.data() + (size_t)(y - firstSource) * rowFloats);
+			}
+
+			std::vector<float> out(rowFloats);
+			for(int y = firstRow; y < endRow; y++) {
+				std::fill(out.begin(), out.end(), 0.0f);
+				const float* weights = rows.weights.data() + rows.offset[y];
+				for(int k = 0; k < rows.count[y]; k++) {
+					const float* row = filtered.data() + (size_t)(rows.start[y] + k - firstSource) * rowFloats;
+					verticalAccumulate(row, weights[k], out.data(), rowFloats);
+				}
+				EncodeRow(tables, settings.colourSpace, out.data(), width, result.data + (size_t)y * (size_t)width);
+			}
+		});
+
+		return result;
+	}
+
+	Image DownsampleHalf(const ImageView& source, const ResampleSettings& settings) {
+		const int width = std::max(1, source.width / 2);
+		const int height = std::max(1, source.height / 2);
+
+		const bool fastPath = settings.filter == ResampleFilter::Box && settings.colourSpace == ColourSpace::Linear
+			&& source.width % 2 == 0 && source.height % 2 == 0;
+		if(!fastPath) return Resize(source, width, height, settings);
+
+		static const BoxDownsampleRowFn kernel = SelectBoxDownsampleKernel();
+		Image result(width, height);
+		ForEachBand(height, [&](int firstRow, int endRow) {
+			for(int y = firstRow; y < endRow; y++)
+				kernel(source.row(y * 2), source.row(y * 2 + 1), result.data + (size_t)y * (size_t)width, (size_t)width);
+		});
+		return result;
+	}
+
+	void PremultiplyAlpha(const ImageView& image, ColourSpace colourSpace) {
+		if(colourSpace == ColourSpace::Linear) {
+			static const PremultiplyRowFn kernel = SelectPremultiplyKernel();
+			ForEachBand(image.height, [&](int firstRow, int endRow) {
+				for(int y = firstRow; y < endRow; y++) kernel(image.row(y), (size_t)image.width);
+			});
+			return;
+		}
+
+		const ColourTables& tables = GetColourTables();
+		ForEachBand(image.height, [&](int firstRow, int endRow) {
+			for(int y = firstRow; y < endRow; y++) {
+				Image::pixel_t* pixel = image.row(y);
+				for(int x = 0; x < image.width; x++, pixel++) {
+					const float alpha = tables.byteToUnit[pixel->w];
+					pixel->x = EncodeSRGB(tables, tables.srgbToLinear[pixel->x] * alpha);
+					pixel->y = EncodeSRGB(tables, tables.srgbToLinear[pixel->y] * alpha);
+					pixel->z = EncodeSRGB(tables, tables.srgbToLinear[pixel->z] * alpha);
+				}
+			}
+		});
+	}
+
+	/* INTEGER KERNELS */
+
+	void BoxDownsampleRowScalar(const Image::pixel_t* top, const Image::pixel_t* bottom, Image::pixel_t* out, size_t outWidth) {
+		const uint8_t* t = &top->x;
+		const uint8_t* b = &bottom->x;
+		uint8_t* o = &out->x;
+		for(size_t i = 0; i < outWidth * 4; i++) {
+			// Channel c of output pixel p reads channel c of source pixels 2p and 2p + 1
+			const size_t s = (i / 4) * 8 + i % 4;
+			o[i] = (uint8_t)((t[s] + t[s + 4] + b[s] + b[s + 4] + 2) >> 2);
+		}
+	}
+
+	// Rounds c * a / 255 to nearest without a divide
+	static inline uint8_t MultiplyUnorm8(uint32_t c, uint32_t a) {
+		const uint32_t t = c * a + 128;
+		return (uint8_t)((t + (t >> 8)) >> 8);
+	}
+
+	void PremultiplyRowScalar(Image::pixel_t* pixels, size_t count) {
+		for(size_t i = 0; i < count; i++) {
+			Image::pixel_t& pixel = pixels[i];
+			pixel.x = MultiplyUnorm8(pixel.x, pixel.w);
+			pixel.y = MultiplyUnorm8(pixel.y, pixel.w);
+			pixel.z = MultiplyUnorm8(pixel.z, pixel.w);
+		}
+	}
+
+#ifdef OGL_ARCH_X86
+
+	namespace intern {
+
+		// Sums vertically adjacent pixels of two 4 pixel registers as 16 bit
+		// lanes, then adds horizontally adjacent pairs. Returns the 2x2 sums
+		// of the 2 output pixels the 4 source pixels make, plus 2 for rounding.
+		static inline OGL_FORCE_INLINE void BoxSums(__m128i top, __m128i bottom, __m128i& lo, __m128i& hi) {
+			const __m128i zero = _mm_setzero_si128();
+			lo = _mm_add_epi16(_mm_unpacklo_epi8(top, zero), _mm_unpacklo_epi8(bottom, zero));
+			hi = _mm_add_epi16(_mm_unpackhi_epi8(top, zero), _mm_unpackhi_epi8(bottom, zero));
+		}
+
+		static inline OGL_FORCE_INLINE __m128i BoxPairs(__m128i lo, __m128i hi) {
+			const __m128i sum = _mm_add_epi16(_mm_unpacklo_epi64(lo, hi), _mm_unpackhi_epi64(lo, hi));
+			return _mm_srli_epi16(_mm_add_epi16(sum, _mm_set1_epi16(2)), 2);
+		}
+
+		// c * a / 255 rounded for 16 bit lanes holding 2 pixels, the alpha
+		// lanes are multiplied by 255 so they come out unchanged
+		static inline OGL_FORCE_INLINE __m128i Premultiply16(__m128i pixels) {
+			__m128i alpha = _mm_shufflelo_epi16(pixels, _MM_SHUFFLE(3, 3, 3, 3));
+			alpha = _mm_shufflehi_epi16(alpha, _MM_SHUFFLE(3, 3, 3, 3));
+			const __m128i colourMask = _mm_setr_epi16(-1, -1, -1, 0, -1, -1, -1, 0);
+			const __m128i alphaOne = _mm_setr_epi16(0, 0, 0, 255, 0, 0, 0, 255);
+			const __m128i factor = _mm_or_si128(_mm_and_si128(alpha, colourMask), alphaOne);
+
+			const __m128i t = _mm_add_epi16(_mm_mullo_epi16(pixels, factor), _mm_set1_epi16(128));
+			return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+		}
+	}
+
+	void BoxDownsampleRowSSE2(const Image::pixel_t* top, const Image::pixel_t* bottom, Image::pixel_t* out, size_t outWidth) {
+		size_t i = 0;
+		// 8 source pixels per row make 4 output pixels
+		for(; i + 4 <= outWidth; i += 4) {
+			__m128i lo0, hi0, lo1, hi1;
+			intern::BoxSums(_mm_loadu_si128((const __m128i*)(top + i * 2)), _mm_loadu_si128((const __m128i*)(bottom + i * 2)), lo0, hi0);
+			intern::BoxSums(_mm_loadu_si128((const __m128i*)(top + i * 2 + 4)), _mm_loadu_si128((const __m128i*)(bottom + i * 2 + 4)), lo1, hi1);
+			const __m128i result = _mm_packus_epi16(intern::BoxPairs(lo0, hi0), intern::BoxPairs(lo1, hi1));
+			_mm_storeu_si128((__m128i*)(out + i), result);
+		}
+		BoxDownsampleRowScalar(top + i * 2, bottom + i * 2, out + i, outWidth - i);
+	}
+
+	OGL_TARGET("avx2")
+	void BoxDownsampleRowAVX2(const Image::pixel_t* top, const Image::pixel_t* bottom, Image::pixel_t* out, size_t outWidth) {
+		const __m256i zero = _mm256_setzero_si256();
+		const __m256i two = _mm256_set1_epi16(2);
+		size_t i = 0;
+		// Same as the SSE2 kernel with each 128 bit lane doing half the work,
+		// 16 source pixels per row make 8 output pixels
+		for(; i + 8 <= outWidth; i += 8) {
+			__m256i sums[2];
+			for(int j = 0; j < 2; j++) {
+				const __m256i t = _mm256_loadu_si256((const __m256i*)(top + i * 2 + j * 8));
+				const __m256i b = _mm256_loadu_si256((const __m256i*)(bottom + i * 2 + j * 8));
+				const __m256i lo = _mm256_add_epi16(_mm256_unpacklo_epi8(t, zero), _mm256_unpacklo_epi8(b, zero));
+				const __m256i hi = _mm256_add_epi16(_mm256_unpackhi_epi8(t, zero), _mm256_unpackhi_epi8(b, zero));
+				const __m256i sum = _mm256_add_epi16(_mm256_unpacklo_epi64(lo, hi), _mm256_unpackhi_epi64(lo, hi));
+				sums[j] = _mm256_srli_epi16(_mm256_add_epi16(sum, two), 2);
+			}
+			// Packing works per lane, the 64 bit pairs come out as 0 2 1 3
+			const __m256i packed = _mm256_packus_epi16(sums[0], sums[1]);
+			_mm256_storeu_si256((__m256i*)(out + i), _mm256_permute4x64_epi64(packed, _MM_SHUFFLE(3, 1, 2, 0)));
+		}
+		_mm256_zeroupper();
+		BoxDownsampleRowSSE2(top + i * 2, bottom + i * 2, out + i, outWidth - i);
+	}
+
+	void PremultiplyRowSSE2(Image::pixel_t* pixels, size_t count) {
+		const __m128i zero = _mm_setzero_si128();
+		size_t i = 0;
+		for(; i + 4 <= count; i += 4) {
+			const __m128i p = _mm_loadu_si128((const __m128i*)(pixels + i));
+			const __m128i lo = intern::Premultiply16(_mm_unpacklo_epi8(p, zero));
+			const __m128i hi = intern::Premultiply16(_mm_unpackhi_epi8(p, zero));
+			_mm_storeu_si128((__m128i*)(pixels + i), _mm_packus_epi16(lo, hi));
+		}
+		PremultiplyRowScalar(pixels + i, count - i);
+	}
+
+	OGL_TARGET("avx2")
+	void PremultiplyRowAVX2(Image::pixel_t* pixels, size_t count) {
+		const __m256i zero = _mm256_setzero_si256();
+		const __m256i colourMask = _mm256_setr_epi16(-1, -1, -1, 0, -1, -1, -1, 0, -1, -1, -1, 0, -1, -1, -1, 0);
+		const __m256i alphaOne = _mm256_setr_epi16(0, 0, 0, 255, 0, 0, 0, 255, 0, 0, 0, 255, 0, 0, 0, 255);
+		const __m256i round = _mm256_set1_epi16(128);
+
+		size_t i = 0;
+		// Unpacking and packing both work per lane, so the pixels end up
+		// back where they started
+		for(; i + 8 <= count; i += 8) {
+			const __m256i p = _mm256_loadu_si256((const __m256i*)(pixels + i));
+			__m256i halves[2] = { _mm256_unpacklo_epi8(p, zero), _mm256_unpackhi_epi8(p, zero) };
+			for(__m256i& half : halves) {
+				__m256i alpha = _mm256_shufflelo_epi16(half, _MM_SHUFFLE(3, 3, 3, 3));
+				alpha = _mm256_shufflehi_epi16(alpha, _MM_SHUFFLE(3, 3, 3, 3));
+				const __m256i factor = _mm256_or_si256(_mm256_and_si256(alpha, colourMask), alphaOne);
+				const __m256i t = _mm256_add_epi16(_mm256_mullo_epi16(half, factor), round);
+				half = _mm256_srli_epi16(_mm256_add_epi16(t, _mm256_srli_epi16(t, 8)), 8);
+			}
+			_mm256_storeu_si256((__m256i*)(pixels + i), _mm256_packus_epi16(halves[0], halves[1]));
+		}
+		_mm256_zeroupper();
+		PremultiplyRowSSE2(pixels + i, count - i);
+	}
+
+#endif
+
+	BoxDownsampleRowFn SelectBoxDownsampleKernel() {
+#ifdef OGL_ARCH_X86
+		const auto& cpu = GetCPUFeatures();
+		if(cpu.avx2) return BoxDownsampleRowAVX2;
+		if(cpu.sse2) return BoxDownsampleRowSSE2;
+#endif
+		return BoxDownsampleRowScalar;
+	}
+
+	PremultiplyRowFn SelectPremultiplyKernel() {
+#ifdef OGL_ARCH_X86
+		const auto& cpu = GetCPUFeatures();
+		if(cpu.avx2) return PremultiplyRowAVX2;
+		if(cpu.sse2) return PremultiplyRowSSE2;
+#endif
+		return PremultiplyRowScalar;
+	}
+}
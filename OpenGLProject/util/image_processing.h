@@ -0,0 +1,68 @@
+#pragma once
+
+#include "core.h"
+#include "util/image.h"
+
+namespace ogl {
+
+	// How the colour channels of an image are encoded. Alpha is always
+	// linear. Filtering an SRGB image is done in linear light, otherwise
+	// dark and bright texels don't average to the brightness they should.
+	enum class ColourSpace {
+		Linear,
+		SRGB
+	};
+
+	enum class ResampleFilter {
+		// Averages every source pixel an output pixel covers
+		Box,
+		// Kaiser windowed sinc, radius 3. Keeps mips sharper than Box
+		// without the ringing of a plain sinc.
+		Kaiser
+	};
+
+	struct ResampleSettings {
+		ResampleFilter filter = ResampleFilter::Box;
+		ColourSpace colourSpace = ColourSpace::Linear;
+	};
+
+	// sRGB transfer functions for a single 8 bit channel, linear is in [0, 1]
+	float SRGBToLinear(uint8_t value);
+	uint8_t LinearToSRGB(float value);
+
+	// Resizes to width x height. Rows are filtered in parallel. Edges are
+	// handled by renormalising the filter over the pixels that exist.
+	Image Resize(const ImageView& source, int width, int height, const ResampleSettings& settings = {});
+
+	// Halves both dimensions, never below 1. A Box filter on an even sized
+	// Linear image takes an integer fast path, everything else goes
+	// through Resize.
+	Image DownsampleHalf(const ImageView& source, const ResampleSettings& settings = {});
+
+	// Multiplies the colour channels by alpha in place. With SRGB the
+	// multiply happens in linear light.
+	void PremultiplyAlpha(const ImageView& image, ColourSpace colourSpace = ColourSpace::Linear);
+
+	// The integer kernels behind DownsampleHalf and PremultiplyAlpha. All
+	// of them must produce byte identical output to the scalar ones.
+
+	// Writes one output row from two source rows. Each output pixel is the
+	// rounded average of a 2x2 block.
+	using BoxDownsampleRowFn = void(*)(const Image::pixel_t* top, const Image::pixel_t* bottom, Image::pixel_t* out, size_t outWidth);
+	// Premultiplies a run of Linear pixels, rounding to nearest
+	using PremultiplyRowFn = void(*)(Image::pixel_t* pixels, size_t count);
+
+	void BoxDownsampleRowScalar(const Image::pixel_t* top, const Image::pixel_t* bottom, Image::pixel_t* out, size_t outWidth);
+	void PremultiplyRowScalar(Image::pixel_t* pixels, size_t count);
+
+#ifdef OGL_ARCH_X86
+	void BoxDownsampleRowSSE2(const Image::pixel_t* top, const Image::pixel_t* bottom, Image::pixel_t* out, size_t outWidth);
+	void BoxDownsampleRowAVX2(const Image::pixel_t* top, const Image::pixel_t* bottom, Image::pixel_t* out, size_t outWidth);
+	void PremultiplyRowSSE2(Image::pixel_t* pixels, size_t count);
+	void PremultiplyRowAVX2(Image::pixel_t* pixels, size_t count);
+#endif
+
+	// Return the fastest kernel supported by the host CPU
+	BoxDownsampleRowFn SelectBoxDownsampleKernel();
+	PremultiplyRowFn SelectPremultiplyKernel();
+}
@@ -0,0 +1,104 @@
+#include "mapped_file.h"
+
+#include <utility>
+
+#ifdef OGL_PLATFORM_WINDOWS
+	#define WIN32_LEAN_AND_MEAN
+	#define NOMINMAX
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <unistd.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+#endif
+
+namespace ogl {
+
+	MappedFile::MappedFile(MappedFile&& other) noexcept 
+		: m_Data(std::exchange(other.m_Data, nullptr)), m_Size(std::exchange(other.m_Size, 0)) {}
+
+	MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+		if(this == &other) return *this;
+		unmap();
+		m_Data = std::exchange(other.m_Data, nullptr);
+		m_Size = std::exchange(other.m_Size, 0);
+		return *this;
+	}
+
+	MappedFile::~MappedFile() { unmap(); }
+
+#ifdef OGL_PLATFORM_WINDOWS
+
+	std::optional<MappedFile> MappedFile::open(const char* path) {
+		HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if(file == INVALID_HANDLE_VALUE) {
+			log::Error("Failed to open '", path, "' for mapping");
+			return std::nullopt;
+		}
+		// The mapping keeps the file alive, the handles aren't needed after it is made
+		SCOPE_DEFER([file] { CloseHandle(file); });
+
+		LARGE_INTEGER size;
+		if(!GetFileSizeEx(file, &size)) {
+			log::Error("Failed to get the size of '", path, "'");
+			return std::nullopt;
+		}
+		if(size.QuadPart == 0) return MappedFile(nullptr, 0);
+
+		HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if(!mapping) {
+			log::Error("Failed to map '", path, "'");
+			return std::nullopt;
+		}
+		const void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		CloseHandle(mapping);
+		if(!data) {
+			log::Error("Failed to map '", path, "'");
+			return std::nullopt;
+		}
+
+		return MappedFile((const uint8_t*)data, (size_t)size.QuadPart);
+	}
+
+	void MappedFile::unmap() {
+		if(m_Data) UnmapViewOfFile(m_Data);
+		m_Data = nullptr;
+		m_Size = 0;
+	}
+
+#else
+
+	std::optional<MappedFile> MappedFile::open(const char* path) {
+		const int file = ::open(path, O_RDONLY);
+		if(file == -1) {
+			log::Error("Failed to open '", path, "' for mapping");
+			return std::nullopt;
+		}
+		// The mapping keeps the file alive, the descriptor isn't needed after it is made
+		SCOPE_DEFER([file] { close(file); });
+
+		struct stat info;
+		if(fstat(file, &info) == -1) {
+			log::Error("Failed to get the size of '", path, "'");
+			return std::nullopt;
+		}
+		if(info.st_size == 0) return MappedFile(nullptr, 0);
+
+		void* data = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+		if(data == MAP_FAILED) {
+			log::Error("Failed to map '", path, "'");
+			return std::nullopt;
+		}
+
+		return MappedFile((const uint8_t*)data, (size_t)info.st_size);
+	}
+
+	void MappedFile::unmap() {
+		if(m_Data) munmap((void*)m_Data, m_Size);
+		m_Data = nullptr;
+		m_Size = 0;
+	}
+
+#endif
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <optional>
+
+#include "core.h"
+
+namespace ogl {
+
+	// A read only view of a whole file mapped into memory. Pages are only
+	// read from disk when they are first touched and the OS can drop them
+	// again under memory pressure, nothing is copied into the process.
+	class MappedFile {
+	public:
+		MappedFile(const MappedFile&) = delete;
+		MappedFile(MappedFile&& other) noexcept;
+		MappedFile& operator=(const MappedFile&) = delete;
+		MappedFile& operator=(MappedFile&& other) noexcept;
+		~MappedFile();
+
+		// nullopt if the file can't be opened or mapped. Empty files map to
+		// a null data pointer with a size of 0.
+		static std::optional<MappedFile> open(const char* path);
+
+		const uint8_t* data() const { return m_Data; }
+		size_t size() const { return m_Size; }
+
+	private:
+		MappedFile(const uint8_t* data, size_t size) : m_Data(data), m_Size(size) {}
+		void unmap();
+
+		const uint8_t* m_Data = nullptr;
+		size_t m_Size = 0;
+	};
+}
@@ -0,0 +1,16 @@
+#include "mipmap.h"
+
+namespace ogl {
+
+	std::vector<Image> BuildMipChain(const ImageView& base, uint32_t levelCount, const ResampleSettings& settings) {
+		const uint32_t fullCount = MipLevelCount(base.width, base.height);
+		if(!levelCount || levelCount > fullCount) levelCount = fullCount;
+
+		std::vector<Image> levels;
+		levels.reserve(levelCount - 1);
+		for(uint32_t level = 1; level < levelCount; level++)
+			levels.push_back(DownsampleHalf(level == 1 ? base : levels.back().view(), settings));
+
+		return levels;
+	}
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+
+#include "core.h"
+#include "util/image.h"
+#include "util/image_processing.h"
+
+namespace ogl {
+
+	// Size of a dimension at a mip level, rounded down the same way GL does
+	inline int MipSize(int size, uint32_t level) { return std::max(1, size >> level); }
+
+	// Levels in a full chain down to 1x1, including the base level
+	inline uint32_t MipLevelCount(int width, int height) {
+		uint32_t levels = 1;
+		for(int size = std::max(width, height); size > 1; size >>= 1) levels++;
+		return levels;
+	}
+
+	// Every level after the base, smallest last. levelCount includes the
+	// base level, 0 builds the full chain down to 1x1. Each level is
+	// filtered from the one before it with DownsampleHalf.
+	std::vector<Image> BuildMipChain(const ImageView& base, uint32_t levelCount = 0, const ResampleSettings& settings = {});
+}
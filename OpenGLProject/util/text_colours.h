@@ -1,11 +1,11 @@
-#pragma once
-
-#define TEXT_RESET "\033[0m"
-#define TEXT_BLACK "\033[0;30m" 
-#define TEXT_RED "\033[0;31m" 
-#define TEXT_GREEN "\033[0;32m" 
-#define TEXT_YELLOW "\033[0;33m" 
-#define TEXT_BLUE "\033[0;34m" 
-#define TEXT_PURPLE "\033[0;35m" 
-#define TEXT_CYAN "\033[0;36m" 
+#pragma once
+
+#define TEXT_RESET "\033[0m"
+#define TEXT_BLACK "\033[0;30m" 
+#define TEXT_RED "\033[0;31m" 
+#define TEXT_GREEN "\033[0;32m" 
+#define TEXT_YELLOW "\033[0;33m" 
+#define TEXT_BLUE "\033[0;34m" 
+#define TEXT_PURPLE "\033[0;35m" 
+#define TEXT_CYAN "\033[0;36m" 
 #define TEXT_WHITE "\033[0;37m" 
\ No newline at end of file
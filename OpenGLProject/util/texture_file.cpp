@@ -0,0 +1,177 @@
+#include "texture_file.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <system_error>
+
+#include "util/mipmap.h"
+
+namespace ogl {
+
+	namespace {
+
+		// Bumped whenever the layout changes, old files then fail to open
+		constexpr uint32_t s_FileVersion = 1;
+		constexpr uint32_t s_FileMagic = 0x544c474f; // "OGLT"
+		constexpr size_t s_LevelAlignment = 16;
+
+		static_assert(sizeof(TextureFileHeader) == 32);
+		static_assert(sizeof(TextureFileLevel) == 24);
+
+		size_t AlignUp(size_t value, size_t alignment) { return (value + alignment - 1) / alignment * alignment; }
+
+		struct LevelPayload {
+			uint32_t width, height;
+			const void* data;
+			size_t size;
+		};
+
+		constexpr uint32_t s_KnownFlags = TextureFileFlagSRGB | TextureFileFlagPremultipliedAlpha;
+
+		bool WriteTextureFile(const char* path, TextureFileFormat format, uint32_t flags, const std::vector<LevelPayload>& payloads) {
+			TextureFileHeader header{ s_FileMagic, s_FileVersion, format, 
+				payloads[0].width, payloads[0].height, (uint32_t)payloads.size(), flags, 0 };
+
+			std::vector<TextureFileLevel> levels(payloads.size());
+			size_t offset = sizeof(TextureFileHeader) + sizeof(TextureFileLevel) * levels.size();
+			for(size_t i = 0; i < payloads.size(); i++) {
+				offset = AlignUp(offset, s_LevelAlignment);
+				levels[i] = TextureFileLevel{ offset, payloads[i].size, payloads[i].width, payloads[i].height };
+				offset += payloads[i].size;
+			}
+
+			// Written next to the real file then renamed over it, so a texture
+			// being rebaked is never seen half written
+			std::filesystem::path temp = path;
+			temp += ".tmp";
+
+			FILE* file = fopen(temp.string().c_str(), "wb");
+			if(!file) {
+				log::ErrorFrom("TextureFile", "Failed to open '", temp.string(), "' for writing");
+				return false;
+			}
+
+			bool written = fwrite(&header, sizeof(header), 1, file) == 1
+				&& fwrite(levels.data(), sizeof(TextureFileLevel), levels.size(), file) == levels.size();
+
+			static constexpr uint8_t padding[s_LevelAlignment] = {};
+			for(size_t i = 0; written && i < payloads.size(); i++) {
+				const size_t pad = levels[i].offset - (size_t)ftell(file);
+				written = fwrite(padding, 1, pad, file) == pad
+					&& fwrite(payloads[i].data, 1, payloads[i].size, file) == payloads[i].size;
+			}
+			fclose(file);
+
+			std::error_code error;
+			if(written) std::filesystem::rename(temp, path, error);
+			if(!written || error) {
+				log::ErrorFrom("TextureFile", "Failed to write '", path, "'");
+				std::filesystem::remove(temp, error);
+				return false;
+			}
+
+			return true;
+		}
+	}
+
+	size_t TextureLevelSize(TextureFileFormat format, uint32_t width, uint32_t height) {
+		const size_t blocks = (size_t)((width + 3) / 4) * (size_t)((height + 3) / 4);
+		switch(format) {
+			case TextureFileFormat::RGBA8: return (size_t)width * (size_t)height * 4;
+			case TextureFileFormat::BC1: return blocks * 8;
+			case TextureFileFormat::BC3: return blocks * 16;
+			case TextureFileFormat::BC7: return blocks * 16;
+		}
+		return 0;
+	}
+
+	BlockFormat ToBlockFormat(TextureFileFormat format) {
+		OGL_ASSERT(IsBlockCompressed(format), "RGBA8 isn't a block format");
+		switch(format) {
+			case TextureFileFormat::BC1: return BlockFormat::BC1;
+			case TextureFileFormat::BC3: return BlockFormat::BC3;
+			default: return BlockFormat::BC7;
+		}
+	}
+
+	bool BakeTexture(const ImageView& image, const char* path, const TextureBakeSettings& settings) {
+		// Level 0 is the image itself. It is copied if it has to be changed,
+		// or if it is a view with gaps between its rows, so every level is
+		// tightly packed.
+		std::optional<Image> copy;
+		if(settings.premultiplyAlpha || !image.is_contiguous()) copy.emplace(image);
+		if(settings.premultiplyAlpha) PremultiplyAlpha(*copy, settings.colourSpace);
+		const ImageView base = copy ? copy->view() : image;
+
+		std::vector<Image> mips;
+		if(settings.generateMipMaps) mips = BuildMipChain(base, settings.levelCount, { settings.mipFilter, settings.colourSpace });
+
+		std::vector<ImageView> views;
+		views.reserve(mips.size() + 1);
+		views.push_back(base);
+		for(const Image& mip : mips) views.push_back(mip.view());
+
+		std::vector<CompressedImage> compressed;
+		if(IsBlockCompressed(settings.format)) {
+			compressed.reserve(views.size());
+			for(const ImageView& view : views)
+				compressed.push_back(CompressImage(view, ToBlockFormat(settings.format), settings.compressionQuality));
+		}
+
+		std::vector<LevelPayload> payloads;
+		payloads.reserve(views.size());
+		for(size_t i = 0; i < views.size(); i++) {
+			const void* data = compressed.empty() ? (const void*)views[i].data : compressed[i].data.data();
+			payloads.push_back({ (uint32_t)views[i].width, (uint32_t)views[i].height, data, 
+				TextureLevelSize(settings.format, views[i].width, views[i].height) });
+		}
+
+		uint32_t flags = 0;
+		if(settings.colourSpace == ColourSpace::SRGB) flags |= TextureFileFlagSRGB;
+		if(settings.premultiplyAlpha) flags |= TextureFileFlagPremultipliedAlpha;
+
+		return WriteTextureFile(path, settings.format, flags, payloads);
+	}
+
+	std::optional<TextureFile> TextureFile::open(const char* path) {
+		auto file = MappedFile::open(path);
+		if(!file) return std::nullopt;
+
+		const auto invalid = [path](const char* reason) {
+			log::ErrorFrom("TextureFile", "'", path, "' isn't a valid texture file: ", reason);
+			return std::nullopt;
+		};
+
+		if(file->size() < sizeof(TextureFileHeader)) return invalid("too small");
+		const auto& header = *(const TextureFileHeader*)file->data();
+		if(header.magic != s_FileMagic) return invalid("wrong magic");
+		if(header.version != s_FileVersion) return invalid("unsupported version");
+		if(header.format > TextureFileFormat::BC7) return invalid("unknown format");
+		if(header.flags & ~s_KnownFlags) return invalid("unknown flags");
+		if(!header.width || !header.height || !header.levelCount) return invalid("empty texture");
+		if(header.levelCount > 32) return invalid("too many levels");
+
+		const size_t tableEnd = sizeof(TextureFileHeader) + sizeof(TextureFileLevel) * header.levelCount;
+		if(file->size() < tableEnd) return invalid("truncated level table");
+
+		// Every level is checked once here so level() can trust the table
+		const auto* levels = (const TextureFileLevel*)(file->data() + sizeof(TextureFileHeader));
+		for(uint32_t i = 0; i < header.levelCount; i++) {
+			const auto& level = levels[i];
+			if(level.width != (uint32_t)MipSize(header.width, i) || level.height != (uint32_t)MipSize(header.height, i))
+				return invalid("level has the wrong size");
+			if(level.size != TextureLevelSize(header.format, level.width, level.height))
+				return invalid("level has the wrong byte size");
+			if(level.offset < tableEnd || level.offset > file->size() || level.size > file->size() - level.offset)
+				return invalid("level is outside the file");
+		}
+
+		return TextureFile(std::move(*file));
+	}
+
+	TextureFile::Level TextureFile::level(uint32_t index) const {
+		OGL_DEBUG_ASSERT(index < level_count(), "Texture file level out of range");
+		const TextureFileLevel& level = levels()[index];
+		return Level{ level.width, level.height, m_File.data() + level.offset, (size_t)level.size };
+	}
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <vector>
+#include <optional>
+
+#include "core.h"
+#include "util/image.h"
+#include "util/image_processing.h"
+#include "util/block_compression.h"
+#include "util/mapped_file.h"
+
+namespace ogl {
+
+	// Textures baked ahead of time into a file that is mapped and uploaded
+	// as is, with no decoding and no mips generated at runtime. Layout:
+	//
+	//   TextureFileHeader
+	//   TextureFileLevel[levelCount]   base level first
+	//   level payloads                 each at its own offset, 16 byte aligned
+	//
+	// Everything is little endian. Rows are stored bottom row first, the
+	// same way Image holds them, so they go straight to glTexImage2D.
+
+	inline constexpr const char* texture_file_extension = ".ogltex";
+
+	enum class TextureFileFormat : uint32_t {
+		RGBA8 = 0,
+		// 4x4 blocks of 8 bytes, RGB with 1 bit alpha
+		BC1 = 1,
+		// 4x4 blocks of 16 bytes, RGBA
+		BC3 = 2,
+		// 4x4 blocks of 16 bytes, RGBA at higher quality than BC3
+		BC7 = 3
+	};
+
+	inline bool IsBlockCompressed(TextureFileFormat format) { return format != TextureFileFormat::RGBA8; }
+	// The BlockFormat a compressed file format holds
+	BlockFormat ToBlockFormat(TextureFileFormat format);
+
+	enum TextureFileFlags : uint32_t {
+		// Colour is sRGB encoded and should be uploaded as an sRGB format
+		TextureFileFlagSRGB = 1 << 0,
+		// Colour has been multiplied by alpha
+		TextureFileFlagPremultipliedAlpha = 1 << 1
+	};
+
+	struct TextureFileHeader {
+		uint32_t magic;
+		uint32_t version;
+		TextureFileFormat format;
+		uint32_t width, height;
+		uint32_t levelCount;
+		// TextureFileFlags
+		uint32_t flags;
+		uint32_t reserved;
+	};
+
+	struct TextureFileLevel {
+		// From the start of the file
+		uint64_t offset;
+		uint64_t size;
+		uint32_t width, height;
+	};
+
+	// Bytes a level of the given size takes up in format
+	size_t TextureLevelSize(TextureFileFormat format, uint32_t width, uint32_t height);
+
+	struct TextureBakeSettings {
+		// Store a mip chain so the loader never has to generate one
+		bool generateMipMaps = true;
+		// Levels including the base one, 0 is a full chain down to 1x1
+		uint32_t levelCount = 0;
+		ResampleFilter mipFilter = ResampleFilter::Box;
+		// SRGB filters mips in linear light and marks the file as sRGB
+		ColourSpace colourSpace = ColourSpace::Linear;
+		// Premultiplies before the mips are built, so they filter correctly
+		bool premultiplyAlpha = false;
+		// Every level is compressed to this after the mips are built
+		TextureFileFormat format = TextureFileFormat::RGBA8;
+		CompressionQuality compressionQuality = CompressionQuality::Fast;
+	};
+
+	// Writes image to path as a texture file. Returns false if the file
+	// couldn't be written.
+	bool BakeTexture(const ImageView& image, const char* path, const TextureBakeSettings& settings = {});
+
+	// A texture file mapped into memory. Levels point straight into the
+	// mapping, nothing is copied.
+	class TextureFile {
+	public:
+		struct Level {
+			uint32_t width, height;
+			const uint8_t* data;
+			size_t size;
+		};
+
+		// nullopt if the file can't be mapped or isn't a valid texture file
+		static std::optional<TextureFile> open(const char* path);
+
+		TextureFileFormat format() const { return header().format; }
+		uint32_t width() const { return header().width; }
+		uint32_t height() const { return header().height; }
+		uint32_t level_count() const { return header().levelCount; }
+		bool is_srgb() const { return header().flags & TextureFileFlagSRGB; }
+		bool is_premultiplied() const { return header().flags & TextureFileFlagPremultipliedAlpha; }
+
+		Level level(uint32_t index) const;
+
+	private:
+		explicit TextureFile(MappedFile file) : m_File(std::move(file)) {}
+
+		const TextureFileHeader& header() const { return *(const TextureFileHeader*)m_File.data(); }
+		const TextureFileLevel* levels() const { return (const TextureFileLevel*)(m_File.data() + sizeof(TextureFileHeader)); }
+
+		MappedFile m_File;
+	};
+}
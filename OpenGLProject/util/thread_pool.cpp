@@ -0,0 +1,51 @@
+#include "thread_pool.h"
+
+#include <algorithm>
+
+namespace ogl {
+
+	ThreadPool::ThreadPool(size_t threadCount) {
+		if(!threadCount) {
+			const size_t hardwareThreads = std::thread::hardware_concurrency();
+			threadCount = std::max<size_t>(hardwareThreads, 2) - 1;
+		}
+
+		m_Threads.reserve(threadCount);
+		for(size_t i = 0; i < threadCount; i++)
+			m_Threads.emplace_back([this] { work(); });
+	}
+
+	ThreadPool::~ThreadPool() {
+		{
+			std::lock_guard lock(m_Mutex);
+			m_Stopping = true;
+		}
+		m_JobAdded.notify_all();
+
+		for(auto& thread : m_Threads) thread.join();
+	}
+
+	void ThreadPool::push(std::function<void()> job) {
+		{
+			std::lock_guard lock(m_Mutex);
+			OGL_DEBUG_ASSERT(!m_Stopping, "Job submitted to a thread pool that is shutting down");
+			m_Jobs.push_back(std::move(job));
+		}
+		m_JobAdded.notify_one();
+	}
+
+	void ThreadPool::work() {
+		while(true) {
+			std::function<void()> job;
+			{
+				std::unique_lock lock(m_Mutex);
+				m_JobAdded.wait(lock, [this] { return m_Stopping || !m_Jobs.empty(); });
+				if(m_Jobs.empty()) return;
+
+				job = std::move(m_Jobs.front());
+				m_Jobs.pop_front();
+			}
+			job();
+		}
+	}
+}
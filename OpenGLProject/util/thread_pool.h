@@ -0,0 +1,53 @@
+#pragma once
+
+#include <mutex>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <future>
+#include <functional>
+#include <type_traits>
+#include <condition_variable>
+
+#include "core.h"
+
+namespace ogl {
+
+	// A fixed set of worker threads running jobs in the order they were
+	// submitted. Jobs must not touch GL, no worker has a context.
+	class ThreadPool {
+	public:
+		// 0 starts one thread per hardware thread, leaving one for the caller
+		explicit ThreadPool(size_t threadCount = 0);
+		// Runs every job still queued before joining the workers
+		~ThreadPool();
+
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+
+		// Queues job and returns a future for its result. Exceptions thrown
+		// by the job are rethrown by the future's get.
+		template<typename F>
+		auto submit(F&& job) -> std::future<std::invoke_result_t<std::decay_t<F>>> {
+			using result_t = std::invoke_result_t<std::decay_t<F>>;
+			// packaged_task is move only and std::function needs a copyable callable
+			auto task = std::make_shared<std::packaged_task<result_t()>>(std::forward<F>(job));
+			auto future = task->get_future();
+			push([task] { (*task)(); });
+			return future;
+		}
+
+		size_t thread_count() const { return m_Threads.size(); }
+
+	private:
+		void push(std::function<void()> job);
+		void work();
+
+		std::vector<std::thread> m_Threads;
+		std::deque<std::function<void()>> m_Jobs;
+		std::mutex m_Mutex;
+		std::condition_variable m_JobAdded;
+		bool m_Stopping = false;
+	};
+}